@@ -4,7 +4,89 @@
 #include "src/controller/history.h"
 #include "src/controller/arguments.h"
 #include "src/controller/solver.h"
+#include "src/controller/solveRepair.h"
 #include "src/controller/patternComparator.h"
+#include "src/controller/session.h"
+
+/**
+ * Returns the next command of the replayed session if it is due, -1 otherwise
+ *
+ * A new game is returned as a RESTART, its scramble being stored in scramble.
+ */
+static move nextReplayedCommand(sessionReplay * replay, move ** scramble) {
+    sessionEvent event;
+    if (!nextDueSessionEvent(replay, &event)) return (move)-1;
+    if (event.type == SESSION_SCRAMBLE) {
+        *scramble = sessionScramble(&event);
+        return RESTART;
+    }
+    if (event.cmd == RETURN) {
+        readSessionEvent(replay, &event);
+    } // The cancelling move is replayed by the RETURN itself
+    return event.cmd;
+}
+
+#define QUICK_REPAIR_DEPTH 2 /**< Length of the repairs searched at once */
+
+/**
+ * A repair of the solution running in the background, when the cube is too
+ * far from the solution to be repaired at once
+ */
+typedef struct _backgroundRepair {
+    SDL_Thread * thread;    /**< The thread, NULL if none is running */
+    SDL_atomic_t done;      /**< Set by the thread when it is finished */
+    cube * start;           /**< The cube being repaired */
+    solvePath * path;       /**< The solution to rejoin */
+    move * solution;        /**< The repaired solution */
+    bool solved;            /**< true if the cube had to be solved again */
+} backgroundRepair;
+
+/**
+ * Repairs the solution of the background repair, solving the cube again if
+ * the solution is out of reach
+ */
+static int repairInBackground(void * data) {
+    backgroundRepair * repair = (backgroundRepair *) data;
+    repair->solution = repairSolvePath(repair->path, repair->start,
+            SOLVE_REPAIR_DEPTH, NULL, NULL);
+    repair->solved = !repair->solution;
+    if (repair->solved) repair->solution = neutralSolve(repair->start);
+    SDL_AtomicSet(&repair->done, 1);
+    return 0;
+}
+
+/**
+ * Waits for the end of the background repair, and drops it
+ */
+static void dropRepair(backgroundRepair * repair) {
+    if (!repair->thread) return;
+    SDL_WaitThread(repair->thread, NULL);
+    repair->thread = NULL;
+    free(repair->solution);
+    destroyCube(repair->start);
+}
+
+/**
+ * Returns true if two cubes are in the same state, orientation included
+ */
+static bool sameState(cube * aCube, cube * bCube) {
+    for (int face = F ; face <= D ; face++) {
+        for (int index = 0 ; index < 3 ; index++) {
+            if (memcmp(aCube->cube[face][index], bCube->cube[face][index], 3)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Replaces the solving sequence shown by the view
+ */
+static mvqueue replaceSolveQueue(mvqueue solveQueue, move * solution) {
+    freeQueue(solveQueue);
+    return toMvQueue(solution);
+}
 
 int main(int argc, char **argv) {
     srand(time(NULL));                      // Seeding random command
@@ -15,23 +97,47 @@ int main(int argc, char **argv) {
             "\\_\\_\\_\\/\\/\\/ \n"
             " \\_\\_\\_\\/\\/ \n"
             "  \\_\\_\\_\\/ \nWELCOME TO RUBIKSAWESOME !!!\n");
-    mode gameMode = argParsing(argc, argv); // Identify game mode
+    settings gameSettings = argParsing(argc, argv); // Identify game mode
 
     /* Initializing data and graphic environment */
     setSDL();
     rubikview mainView = generateView();
+    mainView.onDemand = gameSettings.onDemand;
+    mainView.profilePath = gameSettings.profilePath;
     mvqueue moveQueue = initQueue();
     mvstack moveStack = initQueue();
     cube * cubeData = initCube();
     cube * finishedCube = initCube();
 
     /* Scramble (or not) and saving init sequence for dev purposes */
-    move * initSequence = initGame(cubeData, &mainView, gameMode, argv);
+    move * initSequence = NULL;
+    sessionLog * recorder = NULL;
+    sessionReplay * replay = NULL;
+    if (gameSettings.replayPath) {
+        replay = openSessionReplay(gameSettings.replayPath);
+        if (!replay) exitFatal("in main(), invalid session log");
+        sessionEvent event;
+        readSessionEvent(replay, &event);
+        srand(replay->seed);
+        initSequence = sessionScramble(&event);
+        scrambleCube(cubeData, &mainView, initSequence);
+    } else {
+        initSequence = initGame(cubeData, &mainView, &gameSettings);
+    }
+    if (gameSettings.recordPath) {
+        recorder = openSessionLog(gameSettings.recordPath, gameSettings.seed,
+                initSequence);
+    }
+    move * replayedScramble = NULL;
 
     /* Solving sequence */
     mvqueue solveQueue = initQueue();
     move * winSequence = (move *)malloc(sizeof(move));
     *winSequence = (move)-1;
+    solvePath * solution = NULL;        // States along the last solution
+    bool offSolution = false;           // The solution needs a repair
+    backgroundRepair repair;
+    repair.thread = NULL;
 
     /*
      * Main loop
@@ -40,23 +146,75 @@ int main(int argc, char **argv) {
     while (1) {
     mainView.update(&mainView, moveQueue, moveStack, solveQueue);
 
+    if (repair.thread && SDL_AtomicGet(&repair.done)) {
+      if (sameState(repair.start, cubeData)) {
+        if (repair.solved) {
+          freeSolvePath(solution);
+          solution = initSolvePath(cubeData, repair.solution);
+        } // The new solution is the one to rejoin from now on
+        solveQueue = replaceSolveQueue(solveQueue, repair.solution);
+        offSolution = false;
+        mainView.redrawNeeded = true;
+      } // The repair is dropped if the cube moved meanwhile
+      dropRepair(&repair);
+    }
+
+    if (offSolution && !repair.thread) {
+      move * repaired = repairSolvePath(solution, cubeData, QUICK_REPAIR_DEPTH,
+          NULL, NULL);
+      if (repaired) {
+        solveQueue = replaceSolveQueue(solveQueue, repaired);
+        free(repaired);
+        offSolution = false;
+        mainView.redrawNeeded = true;
+      } else {
+        repair.start = cubeData->copy(cubeData);
+        repair.path = solution;
+        SDL_AtomicSet(&repair.done, 0);
+        repair.thread = SDL_CreateThread(&repairInBackground, "repair",
+            &repair);
+        if (!repair.thread) {
+          SDL_Log("Unable to start the repair: %s", SDL_GetError());
+          destroyCube(repair.start);
+          offSolution = false;
+        } // The solution keeps the undoing of the moves
+      }
+    } // Short repairs are shown at once, longer ones when they are found
+
     if (patternMatches(cubeData, finishedCube)
-        && mainView.animStack == NULL
+        && mainView.animQueue->head == NULL
         && !mainView.gameWon) {
         playWinningSequence(&mainView);
     }
 
-    if (!isEmpty(moveQueue)) {
-      move newMove = dequeue(moveQueue);
+    move newMove = (move)-1;
+    if (replay) {
+      while (!isEmpty(moveQueue)) dequeue(moveQueue); // Input is ignored
+      newMove = nextReplayedCommand(replay, &replayedScramble);
+    } else if (!isEmpty(moveQueue)) {
+      newMove = dequeue(moveQueue);
+    }
+
+    if ((int) newMove != -1) {
+      mainView.redrawNeeded = true; // History or help may change
       if (newMove == *(head(solveQueue, 1))) {
           pop(solveQueue);
+          recordMove(recorder, newMove);
           mainView.animate(&mainView, newMove, true);
           cubeData->rotate(cubeData, newMove);
           cubeData->print(cubeData);
       } else {
         if (newMove == RETURN) {
           if (!isEmpty(moveStack)) {
-            pop(solveQueue);
+            move cancelled = inverseMove(lastCommand(moveStack));
+            if (solution) {
+              push(solveQueue, inverseMove(cancelled));
+              offSolution = true;
+            } else {
+              pop(solveQueue);
+            }
+            recordMove(recorder, RETURN);
+            recordMove(recorder, cancelled);
             cancelMove(cubeData, &mainView, moveStack);
           }
         } else if (newMove == RESTART) {
@@ -67,28 +225,48 @@ int main(int argc, char **argv) {
           moveQueue = initQueue();
           moveStack = initQueue();
           cubeData = initCube();
+          freeQueue(solveQueue);
+          solveQueue = initQueue();
+          dropRepair(&repair);
+          if (solution) freeSolvePath(solution);
+          solution = NULL;
+          offSolution = false;
 
           // Reinitialize the game with the same game mode as at start
           free(initSequence);
-          initSequence = initGame(cubeData, &mainView, gameMode, argv);
+          if (replay) {
+            initSequence = replayedScramble;
+            scrambleCube(cubeData, &mainView, initSequence);
+          } else {
+            initSequence = initGame(cubeData, &mainView, &gameSettings);
+          }
+          recordScramble(recorder, initSequence);
         } else if (newMove == SOLVE_PLS) {
+            recordMove(recorder, SOLVE_PLS);
 
             /* Let's call the solver */
             //winSequence = expandCommand(fakeSolve(initSequence, moveStack));
-            winSequence = trueSolve(cubeData);
+            free(winSequence);
+            winSequence = neutralSolve(cubeData);
             /* We store it in a queue for the view */
-            solveQueue = toMvQueue(winSequence);
+            solveQueue = replaceSolveQueue(solveQueue, winSequence);
+            dropRepair(&repair);
+            if (solution) freeSolvePath(solution);
+            solution = initSolvePath(cubeData, winSequence);
+            offSolution = false;
 
             // TEMPORARY DISPLAY
             fprintf(stderr, "Solving sequence : \n");
             printQueue(solveQueue);
 
         } else {
+          recordMove(recorder, newMove);
           mainView.animate(&mainView, newMove, false);
           cubeData->rotate(cubeData, newMove);
           cubeData->print(cubeData);
           addCmdToHistory(moveStack, newMove);
           push(solveQueue, inverseMove(newMove));
+          offSolution = solution != NULL; // Undoing the move is a solution
           if (patternMatches(cubeData, finishedCube)) {
               playWinningSequence(&mainView);
           }
@@ -97,6 +275,8 @@ int main(int argc, char **argv) {
     }
   }
 
-  closeWindow();
+  closeSessionLog(recorder);
+  closeSessionReplay(replay);
+  closeWindow(&mainView);
   return 0;
 }
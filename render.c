@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "src/view/view.h"
+#include "src/view/offscreen.h"
+#include "src/model/cube.h"
+#include "src/controller/commandParser.h"
+#include "src/controller/history.h"
+#include "src/controller/patternComparator.h"
+#include "src/controller/session.h"
+
+#define RENDER_FPS 30       /**< Default number of frames per second */
+#define RENDER_TAIL 1000    /**< Time rendered after the last move, in ms */
+
+/**
+ * State of a headless rendering
+ */
+typedef struct _renderState {
+    rubikview view;         /**< The view, drawn offscreen */
+    cube * cubeData;        /**< The model, to detect the end of the game */
+    cube * finishedCube;    /**< A solved cube */
+    mvstack moveStack;      /**< History of the moves, drawn by the view */
+} renderState;
+
+static void usage() {
+    printf("Usage is :\n"
+           "\t./rubikrender [-p session file | -m moves] [-s scramble]\n"
+           "\t              [-d directory | -y file] [-f fps] [-a samples]\n\n"
+           "\t-p path\t\tRender a recorded session\n"
+           "\t-m moves\tRender a list of moves, \"R U Ri Ui\"\n"
+           "\t-s moves\tScramble instantly before the moves of -m\n"
+           "\t-d path\t\tWrite numbered PNG frames in a directory\n"
+           "\t-y path\t\tWrite a Y4M stream, - for the standard output\n"
+           "\t-f fps\t\tFrames per second (default %d)\n"
+           "\t-a samples\tSamples for the antialiasing, 0 to render faster"
+           " (default %d)\n", RENDER_FPS, OFFSCREEN_SAMPLES);
+}
+
+/**
+ * Start a new game in the rendered view, scrambled instantly
+ */
+static void restartGame(renderState * state, move * scramble) {
+    resetView(&state->view);
+    freeQueue(state->moveStack);
+    state->moveStack = initQueue();
+    destroyCube(state->cubeData);
+    state->cubeData = initCube();
+    scrambleCube(state->cubeData, &state->view, scramble);
+
+    animationQueue * animQueue = state->view.animQueue;
+    while (animQueue->head != NULL) {
+        finishAnimationStack(animQueue->head, state->view.rubikCube);
+        removeAnimationStack(animQueue);
+    } // The scramble is not part of the video
+}
+
+/**
+ * Animate a move, or cancel the last one for a RETURN
+ */
+static void playMove(renderState * state, move cmd) {
+    if (cmd == RETURN) {
+        if (!isEmpty(state->moveStack)) {
+            cancelMove(state->cubeData, &state->view, state->moveStack);
+        }
+        return;
+    }
+    if (cmd >= RETURN) return; // No solver in the renderer
+
+    state->view.animate(&state->view, cmd, false);
+    state->cubeData->rotate(state->cubeData, cmd);
+    addCmdToHistory(state->moveStack, cmd);
+    if (patternMatches(state->cubeData, state->finishedCube)) {
+        playWinningSequence(&state->view);
+    }
+}
+
+/**
+ * Parse a list of moves, double moves being expanded
+ */
+static move * parseMoves(const char * str) {
+    move * moves = commandParser(str);
+    if (!moves) exitFatal("in parseMoves(), invalid list of moves");
+    move * expanded = expandCommand(moves);
+    free(moves);
+    return expanded;
+}
+
+/*
+ * Headless rendering of a session log or of a list of moves
+ * The animations are driven by a virtual clock advancing of exactly one frame
+ * per frame, so the video has the real speed of the game whatever the time
+ * spent to render it.
+ */
+int main(int argc, char **argv) {
+    const char * sessionPath = NULL;
+    const char * movesString = NULL;
+    const char * scrambleString = NULL;
+    const char * framesPath = NULL;
+    const char * streamPath = NULL;
+    int fps = RENDER_FPS;
+    int samples = OFFSCREEN_SAMPLES;
+
+    int option;
+    while ((option = getopt(argc, argv, "p:m:s:d:y:f:a:h")) != -1) {
+        switch (option) {
+            case 'p': sessionPath = optarg; break;
+            case 'm': movesString = optarg; break;
+            case 's': scrambleString = optarg; break;
+            case 'd': framesPath = optarg; break;
+            case 'y': streamPath = optarg; break;
+            case 'f': fps = atoi(optarg); break;
+            case 'a': samples = atoi(optarg); break;
+            default: usage(); return 1;
+        }
+    }
+    if ((!sessionPath == !movesString) || (!framesPath == !streamPath)
+            || fps <= 0 || samples < 0) {
+        usage();
+        return 1;
+    }
+
+    /* Keep the standard output for the stream, messages go to stderr */
+    FILE * stream = NULL;
+    if (streamPath && strcmp(streamPath, "-") == 0) {
+        stream = fdopen(dup(STDOUT_FILENO), "wb");
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    } else if (streamPath) {
+        stream = fopen(streamPath, "wb");
+    }
+    if (streamPath && !stream) exitFatal("in main(), unable to open the stream");
+
+    /* Sources of the moves */
+    sessionReplay * replay = NULL;
+    sessionEvent event;
+    bool eventPending = false;
+    move * moves = NULL;
+    int moveIndex = 0;
+    if (sessionPath) {
+        replay = openSessionReplay(sessionPath);
+        if (!replay) exitFatal("in main(), invalid session log");
+        eventPending = readSessionEvent(replay, &event);
+    } else {
+        moves = parseMoves(movesString);
+    }
+
+    offscreenTarget * target = generateOffscreenTarget(VIEW_WIDTH, VIEW_HEIGHT,
+            samples);
+    setupScene(VIEW_WIDTH, VIEW_HEIGHT);
+    IMG_Init(IMG_INIT_PNG);
+    renderState state;
+    generateViewContent(&state.view);
+    state.cubeData = initCube();
+    state.finishedCube = initCube();
+    state.moveStack = initQueue();
+    if (scrambleString) {
+        move * scramble = parseMoves(scrambleString);
+        restartGame(&state, scramble);
+        free(scramble);
+    }
+    if (stream) writeY4MHeader(target, stream, fps);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    unsigned long frame = 0;
+    Uint32 tailEnd = 0;
+    for ( ; ; frame++) {
+        Uint32 now = frame * 1000 / fps;
+
+        /* Feed the moves that are due */
+        if (replay) {
+            while (eventPending && event.time <= now) {
+                if (event.type == SESSION_SCRAMBLE) {
+                    move * scramble = sessionScramble(&event);
+                    restartGame(&state, scramble);
+                    free(scramble);
+                } else {
+                    playMove(&state, event.cmd);
+                    if (event.cmd == RETURN) readSessionEvent(replay, &event);
+                } // The cancelling move is replayed by the RETURN itself
+                eventPending = readSessionEvent(replay, &event);
+            }
+        } else if (state.view.animQueue->head == NULL
+                && (int)moves[moveIndex] != -1) {
+            playMove(&state, moves[moveIndex++]);
+        }
+
+        /* Stop a little after the last move */
+        bool animating = updateAnimations(&state.view, 0, now);
+        bool sourceDone = replay ? !eventPending : (int)moves[moveIndex] == -1;
+        if (sourceDone && !animating) {
+            if (tailEnd == 0) tailEnd = now + RENDER_TAIL;
+            else if (now >= tailEnd) break;
+        }
+
+        renderScene(&state.view, state.moveStack, 0);
+        readOffscreenFrame(target);
+        if (stream) {
+            if (!writeFrameY4M(target, stream)) {
+                exitFatal("in main(), unable to write the stream");
+            }
+        } else {
+            char path[4096];
+            snprintf(path, sizeof(path), "%s/frame%05lu.png", framesPath, frame);
+            if (!writeFramePNG(target, path)) {
+                exitFatal("in main(), unable to write a frame");
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec)
+        + (end.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(stderr, "%lu frame(s), %.1f s of video rendered in %.3f s",
+            frame, (double)frame / fps, elapsed);
+    if (elapsed > 0) fprintf(stderr, " (%.1f fps)", frame / elapsed);
+    fprintf(stderr, "\n");
+
+    if (stream) fclose(stream);
+    closeSessionReplay(replay);
+    free(moves);
+    destroyOffscreenTarget(target);
+    return 0;
+}
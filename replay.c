@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <time.h>
+#include "src/model/cube.h"
+#include "src/controller/session.h"
+
+/*
+ * Headless replay of a session log
+ * Applies every recorded move to the model as fast as possible, then prints
+ * the final cube.
+ */
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        printf("Usage is :\n\t./rubikreplay [session file]\n");
+        return 1;
+    }
+
+    sessionReplay * replay = openSessionReplay(argv[1]);
+    if (!replay) exitFatal("in main(), invalid session log");
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    cube * cubeData = NULL;
+    unsigned long moveCount = 0;
+    int gameCount = 0;
+    sessionEvent event;
+    while (readSessionEvent(replay, &event)) {
+        if (event.type == SESSION_SCRAMBLE) {
+            if (cubeData) destroyCube(cubeData);
+            cubeData = initCube();
+            for (int index = 0 ; index < event.scrambleSize ; index++) {
+                cubeData->rotate(cubeData,
+                        readPackedMove(event.scramble, index));
+            }
+            gameCount++;
+        } else if (event.cmd < RETURN) {
+            cubeData->rotate(cubeData, event.cmd);
+            moveCount++;
+        } // Commands are skipped, their effect on the cube is recorded as moves
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec)
+        + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("Seed is: %u\n", replay->seed);
+    printf("%d game(s), %lu move(s) replayed in %.3f s", gameCount, moveCount,
+            elapsed);
+    if (elapsed > 0) printf(" (%.0f moves/s)", moveCount / elapsed);
+    printf("\n");
+    if (cubeData) {
+        cubeData->print(cubeData);
+        destroyCube(cubeData);
+    }
+
+    closeSessionReplay(replay);
+    return 0;
+}
@@ -0,0 +1,791 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "src/rubik.h"
+#include "src/controller/lastLayerTable.h"
+#include "src/controller/solveCache.h"
+#include "src/controller/xcrossSearch.h"
+
+#define SOLVERD_SOCKET "/tmp/rubiksolverd.sock"   /**< Default socket path */
+#define SOLVERD_TIMEOUT 2000    /**< Default time limit of a solve, in ms */
+#define SOLVERD_CLIENTS 64      /**< Maximum number of connected clients */
+#define SOLVERD_WORKERS 64      /**< Maximum number of workers */
+#define SOLVERD_LINE 4096       /**< Maximum length of a request or a reply */
+#define SOLVERD_CACHE 16        /**< Default size of the cache, in MiB */
+#define SOLVERD_OUTPUT 65536    /**< Replies of a client waiting to be sent */
+#define SOLVERD_BACKLOG 1024    /**< Requests of a client without reply sent,
+                                  over which its requests are not read */
+
+/**
+ * A request, waiting for a worker, being solved or waiting for its reply to
+ * be sent
+ */
+typedef struct _solverJob {
+    char * request;             /**< The request line, without the newline */
+    char * reply;               /**< The reply line, NULL until solved */
+    struct _solverClient * client;  /**< The client, NULL if it left */
+    struct _solverJob * next;   /**< Next request of the client */
+    struct _solverJob * nextPending;    /**< Next request waiting a worker */
+} solverJob;
+
+/**
+ * A connected client. Its replies are sent in the order of its requests.
+ */
+typedef struct _solverClient {
+    int fd;                     /**< The connection */
+    char buffer[SOLVERD_LINE];  /**< The start of an incomplete request */
+    size_t length;              /**< Length of the incomplete request */
+    bool skipping;              /**< Skipping the end of a request too long */
+    solverJob * head;           /**< Oldest request without reply sent */
+    solverJob * tail;           /**< Newest request */
+    int jobCount;               /**< Requests without reply sent */
+    char output[SOLVERD_OUTPUT + SOLVERD_LINE + 1]; /**< The replies not sent */
+    size_t outputLength;        /**< Length of the replies not sent */
+    bool draining;              /**< No more requests, closed once answered */
+} solverClient;
+
+/**
+ * A worker process, solving one request at a time
+ */
+typedef struct _solverWorker {
+    pid_t pid;                  /**< The process, 0 if not running */
+    int fd;                     /**< Master side of the socket pair */
+    char buffer[SOLVERD_LINE];  /**< The start of an incomplete reply */
+    size_t length;              /**< Length of the incomplete reply */
+    solverJob * job;            /**< The request solved, NULL if idle */
+    struct timespec deadline;   /**< Time limit of the request solved */
+} solverWorker;
+
+static solverClient * clients[SOLVERD_CLIENTS];
+static solverWorker workers[SOLVERD_WORKERS];
+static int workerCount;
+static int timeout = SOLVERD_TIMEOUT;
+static int shortening = 0;          /**< Time spent shortening a solution */
+static solverJob * pendingHead = NULL;
+static solverJob * pendingTail = NULL;
+static const char * socketPath = SOLVERD_SOCKET;
+static volatile sig_atomic_t stopped = 0;
+static solveCache * cache = NULL;
+static cube * requestData = NULL;   /**< The cube of a request, in the master */
+static cube * solvedData = NULL;    /**< A solved cube */
+
+static void usage() {
+    printf("Usage is :\n"
+           "\t./rubiksolverd [-s socket] [-w workers] [-t timeout]\n"
+           "\t               [-c megabytes] [-f cache file] [-d deadline]\n"
+           "\t               [-x nodes] [-p pairs] [-l table]\n\n"
+           "\t-s path\t\tPath of the Unix socket (default %s)\n"
+           "\t-w workers\tNumber of solving processes (default: one per CPU)\n"
+           "\t-t ms\t\tTime limit of a solve (default %d)\n"
+           "\t-c megabytes\tSize of the cache of solutions, 0 to disable"
+           " (default %d)\n"
+           "\t-f path\t\tLoad the cache from a file, saved when stopped\n"
+           "\t-d ms\t\tTime spent shortening a solution, less than the time"
+           " limit (default 0)\n"
+           "\t-x nodes\tBudget of the search of the cross with pairs, 0 for"
+           " the cross\n\t\t\talone (default %d)\n"
+           "\t-p pairs\tPairs searched with the cross, up to %d (default %d)\n"
+           "\t-l path\t\tTable of the last layer (default %s next to the"
+           " executable,\n\t\t\tsolved in 4 steps without it)\n\n"
+           "Each request is a line, answered by a line in the same order :\n"
+           "\tfacelets UUUUUUUUURRRRRRRRRFFFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB\n"
+           "\tmoves R U Ri Ui\n"
+           "\tbetween [facelets] [facelets | checkerboard | superflip |"
+           " cubeincube |\n"
+           "\t        sixspots | crosses | stripes]\n"
+           "\t-> ok [solve time in us] [solution] | error [message]\n"
+           "\tstats\n"
+           "\t-> ok [hits] [misses] [entries] [bytes]\n",
+           SOLVERD_SOCKET, SOLVERD_TIMEOUT, SOLVERD_CACHE, XCROSS_NODES,
+           XCROSS_SLOTS, XCROSS_PAIRS, LAST_LAYER_PATH);
+}
+
+static void onSignal(int signal) {
+    (void) signal;
+    stopped = 1;
+}
+
+static long elapsedMicroseconds(struct timespec * start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000000L
+        + (now.tv_nsec - start->tv_nsec) / 1000;
+}
+
+/**
+ * Write a whole buffer, false if the peer left
+ */
+static bool writeAll(int fd, const char * buffer, size_t length) {
+    while (length > 0) {
+        ssize_t written = send(fd, buffer, length, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        buffer += written;
+        length -= written;
+    }
+    return true;
+}
+
+/**
+ * Set a cube from a request
+ *
+ * @param request the request line
+ * @param work the cube to set
+ * @param solved a solved cube
+ * @returns NULL, or the error message if the request is invalid
+ */
+static const char * requestCube(const char * request, cube * work,
+        cube * solved) {
+    if (strncmp(request, "facelets ", 9) == 0) {
+        if (!setFacelets(work, request + 9)) return "error invalid facelets";
+    } else if (strncmp(request, "moves ", 6) == 0) {
+        move * moves = commandParser(request + 6);
+        if (!moves) return "error invalid moves";
+        move * expanded = expandCommand(moves);
+        free(moves);
+        for (int face = F ; face <= D ; face++) {
+            for (int index = 0 ; index < 3 ; index++) {
+                memcpy(work->cube[face][index], solved->cube[face][index], 3);
+            }
+        } // Scrambling from a solved cube
+        executeBulkCommand(work, expanded);
+        free(expanded);
+    } else {
+        return "error unknown request";
+    }
+    return NULL;
+}
+
+/**
+ * Write the reply of a solution
+ *
+ * @param reply the reply line, of SOLVERD_LINE chars
+ * @param solveTime the time spent solving, in microseconds
+ * @param solution the moves, terminated by -1
+ */
+static void solutionReply(char * reply, long solveTime, move * solution) {
+    char * solutionString = commandToString(solution);
+    if (snprintf(reply, SOLVERD_LINE - 1, "ok %ld %s", solveTime,
+                solutionString) >= SOLVERD_LINE - 1) {
+        strcpy(reply, "error solution too long");
+    } // Room is left for the newline
+    free(solutionString);
+}
+
+/**
+ * Find the moves between two cubes in a worker, for a request
+ * "between <facelets> <facelets or pattern name>"
+ *
+ * @param request the request line
+ * @param work a cube reused by every request
+ * @param reply the reply line, of SOLVERD_LINE chars
+ */
+static void betweenRequest(const char * request, cube * work, char * reply) {
+    const char * target = request + 8 + FACELETS_LENGTH;
+    if (strlen(request) <= 8 + FACELETS_LENGTH || *target != ' '
+            || !setFacelets(work, request + 8)) {
+        strcpy(reply, "error invalid facelets");
+        return;
+    }
+
+    cube * goal = patternCube(target + 1);
+    if (!goal) {
+        goal = initCube();
+        if (strlen(target + 1) != FACELETS_LENGTH
+                || !setFacelets(goal, target + 1)) {
+            destroyCube(goal);
+            strcpy(reply, "error invalid target");
+            return;
+        }
+    } // A pattern name, or the facelets of the cube to reach
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    move * solution = solveBetween(work, goal, shortening * 1000L);
+    long solveTime = elapsedMicroseconds(&start);
+
+    if (!solution) {
+        strcpy(reply, "error different stickers");
+    } else if (!executeBulkCommand(work, solution)->equals(work, goal)) {
+        strcpy(reply, "error unsolved");
+    } else {
+        solutionReply(reply, solveTime, solution);
+    } // The moves are checked, the solver is not always right
+    free(solution);
+    destroyCube(goal);
+}
+
+/**
+ * Solve a request in a worker
+ *
+ * @param request the request line
+ * @param work a cube reused by every request
+ * @param solved a solved cube
+ * @param reply the reply line, of SOLVERD_LINE chars
+ */
+static void solveRequest(char * request, cube * work, cube * solved,
+        char * reply) {
+    if (strncmp(request, "between ", 8) == 0) {
+        betweenRequest(request, work, reply);
+        return;
+    } // Not cached, so only answered by the workers
+
+    const char * error = requestCube(request, work, solved);
+    if (error) {
+        strcpy(reply, error);
+        return;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    move * solution = anytimeSolve(work, shortening * 1000L, NULL, NULL, NULL);
+    long solveTime = elapsedMicroseconds(&start);
+
+    executeBulkCommand(work, solution);
+    if (!patternMatches(work, solved)) {
+        strcpy(reply, "error unsolved");
+    } else {
+        solutionReply(reply, solveTime, solution);
+    } // The solution is checked, the solver is not always right
+    free(solution);
+}
+
+/**
+ * Main loop of a worker : a request line in, a reply line out. The cubes are
+ * kept between the requests. The solver exits the worker when it is stuck.
+ */
+static void runWorker(int fd) {
+    cube * work = initCube();
+    cube * solved = initCube();
+    char request[SOLVERD_LINE];
+    char reply[SOLVERD_LINE];
+    size_t length = 0;
+
+    while (true) {
+        char * newline = memchr(request, '\n', length);
+        if (!newline) {
+            ssize_t received = read(fd, request + length,
+                    SOLVERD_LINE - length);
+            if (received < 0 && errno == EINTR) continue;
+            if (received <= 0) break;
+            length += received;
+            continue;
+        }
+
+        *newline = '\0';
+        solveRequest(request, work, solved, reply);
+        strcat(reply, "\n");
+        if (!writeAll(fd, reply, strlen(reply))) break;
+
+        length -= newline + 1 - request;
+        memmove(request, newline + 1, length);
+    }
+
+    destroyCube(work);
+    destroyCube(solved);
+    _exit(0);
+}
+
+static void startWorker(solverWorker * worker, int listener) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0) {
+        exitFatal("in startWorker(), unable to create a socket pair");
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) exitFatal("in startWorker(), unable to fork");
+    if (pid == 0) {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        close(listener);
+        close(pair[0]);
+        for (int index = 0 ; index < SOLVERD_CLIENTS ; index++) {
+            if (clients[index]) close(clients[index]->fd);
+        }
+        for (int index = 0 ; index < workerCount ; index++) {
+            if (workers[index].pid && &workers[index] != worker) {
+                close(workers[index].fd);
+            }
+        } // The fds of the other workers, the one restarted is closed
+        runWorker(pair[1]);
+    }
+
+    close(pair[1]);
+    worker->pid = pid;
+    worker->fd = pair[0];
+    worker->length = 0;
+    worker->job = NULL;
+}
+
+/**
+ * Send the replies of a client which are ready, in the order of its requests.
+ * The socket of the client does not block : the replies it does not take yet
+ * are kept in its output, and the requests wait while the output is full.
+ *
+ * @returns false if the client left
+ */
+static bool flushReplies(solverClient * client) {
+    while (client->head && client->head->reply
+            && client->outputLength < SOLVERD_OUTPUT) {
+        solverJob * job = client->head;
+        size_t length = strlen(job->reply);
+        memcpy(client->output + client->outputLength, job->reply, length);
+        client->output[client->outputLength + length] = '\n';
+        client->outputLength += length + 1;
+        client->head = job->next;
+        if (!client->head) client->tail = NULL;
+        client->jobCount--;
+        free(job->request);
+        free(job->reply);
+        free(job);
+    }
+
+    size_t sent = 0;
+    while (sent < client->outputLength) {
+        ssize_t written = send(client->fd, client->output + sent,
+                client->outputLength - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) continue;
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (written <= 0) return false;
+        sent += written;
+    }
+    client->outputLength -= sent;
+    memmove(client->output, client->output + sent, client->outputLength);
+    return true;
+}
+
+/**
+ * Give the reply of a request to its client, or drop it if the client left
+ */
+static void finishJob(solverJob * job, const char * reply) {
+    if (!job->client) {
+        free(job->request);
+        free(job);
+        return;
+    }
+    job->reply = strdup(reply);
+    if (!job->reply) exitFatal("in finishJob(), unable to allocate");
+}
+
+static void closeClient(int slot) {
+    solverClient * client = clients[slot];
+    close(client->fd);
+
+    solverJob ** pending = &pendingHead;
+    pendingTail = NULL;
+    while (*pending) {
+        if ((*pending)->client == client) {
+            *pending = (*pending)->nextPending;
+        } else {
+            pendingTail = *pending;
+            pending = &(*pending)->nextPending;
+        }
+    } // Removing its requests waiting a worker
+
+    solverJob * job = client->head;
+    while (job) {
+        solverJob * next = job->next;
+        bool running = false;
+        for (int index = 0 ; index < workerCount ; index++) {
+            running |= workers[index].job == job;
+        }
+        if (running) {
+            job->client = NULL;
+        } else {
+            free(job->request);
+            free(job->reply);
+            free(job);
+        }
+        job = next;
+    } // Its requests being solved are dropped when they are solved
+
+    free(client);
+    clients[slot] = NULL;
+}
+
+/**
+ * Answer a request without a worker : the statistics, or a solution found in
+ * the cache
+ *
+ * @returns true if the request is answered
+ */
+static bool answerFromMaster(solverJob * job) {
+    char reply[SOLVERD_LINE];
+    if (strcmp(job->request, "stats") == 0) {
+        snprintf(reply, SOLVERD_LINE, "ok %lu %lu %d %zu",
+                cache ? cache->hits : 0, cache ? cache->misses : 0,
+                cache ? cache->entries : 0, cache ? cache->bytes : 0);
+        finishJob(job, reply);
+        return true;
+    }
+    if (!cache || requestCube(job->request, requestData, solvedData)) {
+        return false;
+    } // The invalid requests are answered by the workers
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    move * solution = lookupSolveCache(cache, requestData);
+    if (!solution) return false;
+    long lookupTime = elapsedMicroseconds(&start);
+
+    char * solutionString = commandToString(solution);
+    bool fits = snprintf(reply, SOLVERD_LINE - 1, "ok %ld %s", lookupTime,
+            solutionString) < SOLVERD_LINE - 1;
+    free(solutionString);
+    free(solution);
+    if (fits) finishJob(job, reply);
+    return fits;
+}
+
+/**
+ * Store the solution of a worker in the cache
+ */
+static void storeReply(solverJob * job, const char * reply) {
+    const char * solutionString = strchr(reply + 3, ' ');
+    if (!cache || strncmp(reply, "ok ", 3) || !solutionString
+            || requestCube(job->request, requestData, solvedData)) {
+        return;
+    }
+
+    move * solution = commandParser(solutionString + 1);
+    if (solution) storeSolveCache(cache, requestData, solution);
+    free(solution);
+}
+
+/**
+ * Add a request to the ones of a client, answered in their order
+ */
+static solverJob * addJob(solverClient * client, const char * request) {
+    solverJob * job = (solverJob *) ec_malloc(sizeof(solverJob));
+    job->request = strdup(request);
+    if (!job->request) exitFatal("in addJob(), unable to allocate");
+    job->reply = NULL;
+    job->client = client;
+    job->next = NULL;
+    job->nextPending = NULL;
+
+    if (client->tail) client->tail->next = job;
+    else client->head = job;
+    client->tail = job;
+    client->jobCount++;
+    return job;
+}
+
+/**
+ * Read the requests of a client, every complete line is answered from the
+ * master or queued for the workers. A request too long is answered with an
+ * error and skipped up to its newline.
+ */
+static bool readClient(solverClient * client) {
+    ssize_t received = read(client->fd, client->buffer + client->length,
+            SOLVERD_LINE - client->length);
+    if (received < 0) {
+        return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    if (received == 0) {
+        client->draining = true;
+        return true;
+    } // The client may still read the replies of its requests
+    client->length += received;
+
+    char * start = client->buffer;
+    char * newline;
+    while ((newline = memchr(start, '\n',
+                    client->length - (start - client->buffer)))) {
+        *newline = '\0';
+        if (newline > start && newline[-1] == '\r') newline[-1] = '\0';
+        if (client->skipping) {
+            client->skipping = false;
+            start = newline + 1;
+            continue;
+        } // The end of a request too long, already answered
+
+        solverJob * job = addJob(client, start);
+        start = newline + 1;
+        if (answerFromMaster(job)) continue;
+
+        if (pendingTail) pendingTail->nextPending = job;
+        else pendingHead = job;
+        pendingTail = job;
+    }
+
+    client->length -= start - client->buffer;
+    memmove(client->buffer, start, client->length);
+    if (client->length == SOLVERD_LINE) {
+        if (!client->skipping) {
+            finishJob(addJob(client, ""), "error request too long");
+        }
+        client->skipping = true;
+        client->length = 0;
+    } // The buffer is full without a newline
+    return true;
+}
+
+/**
+ * Give the waiting requests to the idle workers
+ */
+static void dispatchJobs() {
+    for (int index = 0 ; index < workerCount && pendingHead ; index++) {
+        solverWorker * worker = &workers[index];
+        if (worker->job) continue;
+
+        solverJob * job = pendingHead;
+        pendingHead = job->nextPending;
+        if (!pendingHead) pendingTail = NULL;
+
+        worker->job = job;
+        clock_gettime(CLOCK_MONOTONIC, &worker->deadline);
+        worker->deadline.tv_sec += timeout / 1000;
+        worker->deadline.tv_nsec += (timeout % 1000) * 1000000L;
+        if (worker->deadline.tv_nsec >= 1000000000L) {
+            worker->deadline.tv_sec++;
+            worker->deadline.tv_nsec -= 1000000000L;
+        }
+
+        char line[SOLVERD_LINE + 1];
+        int length = snprintf(line, sizeof(line), "%s\n", job->request);
+        writeAll(worker->fd, line, length); // A failure is seen by poll()
+    }
+}
+
+/**
+ * Replace a worker which died or timed out, failing its request
+ */
+static void restartWorker(solverWorker * worker, int listener,
+        const char * reply) {
+    kill(worker->pid, SIGKILL);
+    waitpid(worker->pid, NULL, 0);
+    close(worker->fd);
+    worker->pid = 0;
+    if (worker->job) finishJob(worker->job, reply);
+    startWorker(worker, listener);
+}
+
+/**
+ * Read the replies of a worker
+ */
+static void readWorker(solverWorker * worker, int listener) {
+    ssize_t received = read(worker->fd, worker->buffer + worker->length,
+            SOLVERD_LINE - worker->length);
+    if (received < 0 && errno == EINTR) return;
+    if (received <= 0) {
+        restartWorker(worker, listener, "error solver failed");
+        return;
+    } // The solver exits when it is stuck
+    worker->length += received;
+
+    char * newline = memchr(worker->buffer, '\n', worker->length);
+    if (!newline || !worker->job) return;
+
+    *newline = '\0';
+    storeReply(worker->job, worker->buffer);
+    finishJob(worker->job, worker->buffer);
+    worker->job = NULL;
+    worker->length = 0; // One request at a time, nothing follows the reply
+}
+
+static int openListener() {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        exitFatal("in openListener(), socket path too long");
+    }
+    strcpy(address.sun_path, socketPath);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) exitFatal("in openListener(), unable to create socket");
+    unlink(socketPath);
+    if (bind(listener, (struct sockaddr *) &address, sizeof(address)) < 0
+            || listen(listener, SOLVERD_CLIENTS) < 0) {
+        exitFatal("in openListener(), unable to listen on the socket");
+    }
+    return listener;
+}
+
+/*
+ * Solver daemon
+ * Solves the cubes sent on a Unix socket with a pool of worker processes,
+ * started once. Requests are spread over the idle workers as soon as they
+ * are read, so a client can send a batch of lines and get the replies in the
+ * same order, even if it shuts down its side of the socket once the batch is
+ * sent. The sockets of the clients do not block : the replies a client
+ * does not read yet are kept, and its requests are not read while too many of
+ * them wait for a reply, so a client never stalls the others. The workers are
+ * processes because the solver exits when it is stuck : a worker which dies
+ * or exceeds the time limit is replaced. The master keeps the solutions in a cache, so a cube already solved in any
+ * orientation is answered without a worker.
+ */
+int main(int argc, char **argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    workerCount = cpus > 0 ? cpus : 1;
+
+    int cacheSize = SOLVERD_CACHE;
+    const char * cachePath = NULL;
+    long xcrossNodes = XCROSS_NODES;
+    int xcrossPairs = XCROSS_PAIRS;
+    const char * tablePath = NULL;
+
+    int option;
+    while ((option = getopt(argc, argv, "s:w:t:c:f:d:x:p:l:h")) != -1) {
+        switch (option) {
+            case 's': socketPath = optarg; break;
+            case 'w': workerCount = atoi(optarg); break;
+            case 't': timeout = atoi(optarg); break;
+            case 'c': cacheSize = atoi(optarg); break;
+            case 'f': cachePath = optarg; break;
+            case 'd': shortening = atoi(optarg); break;
+            case 'x': xcrossNodes = atol(optarg); break;
+            case 'p': xcrossPairs = atoi(optarg); break;
+            case 'l': tablePath = optarg; break;
+            default: usage(); return 1;
+        }
+    }
+    if (workerCount <= 0 || timeout <= 0 || cacheSize < 0 || optind != argc
+            || (cachePath && !cacheSize)
+            || shortening < 0 || shortening >= timeout || xcrossNodes < 0
+            || xcrossPairs < 1 || xcrossPairs > XCROSS_SLOTS) {
+        usage();
+        return 1;
+    }
+    if (workerCount > SOLVERD_WORKERS) workerCount = SOLVERD_WORKERS;
+    setXCrossBudget(xcrossNodes);
+    setXCrossPairs(xcrossPairs);
+    if (tablePath && !loadLastLayerTable(tablePath)) {
+        fprintf(stderr, "%s is not a table of the last layer\n", tablePath);
+        return 1;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    requestData = initCube();
+    solvedData = initCube();
+    if (cacheSize) {
+        cache = initSolveCache((size_t) cacheSize << 20, cachePath);
+    } // The cache is loaded before the workers are forked
+    cube * warm = solvedData->copy(solvedData);
+    crossDistance(warm);
+    free(searchXCross(warm, 1, 1));
+    free(solvePairs(warm));
+    free(solveLastLayer(warm));
+    destroyCube(warm); // So are the tables of the solver
+
+    int listener = openListener();
+    for (int index = 0 ; index < workerCount ; index++) {
+        startWorker(&workers[index], listener);
+    }
+    printf("Listening on %s with %d worker(s)", socketPath, workerCount);
+    if (cache) printf(", %d cached solution(s)", cache->entries);
+    printf("\n");
+    fflush(stdout);
+
+    struct pollfd fds[1 + SOLVERD_WORKERS + SOLVERD_CLIENTS];
+    while (!stopped) {
+        int count = 0;
+        fds[count++] = (struct pollfd) {listener, POLLIN, 0};
+        for (int index = 0 ; index < workerCount ; index++) {
+            fds[count++] = (struct pollfd) {workers[index].fd, POLLIN, 0};
+        }
+        for (int index = 0 ; index < SOLVERD_CLIENTS ; index++) {
+            solverClient * client = clients[index];
+            if (!client) continue;
+            short events = !client->draining
+                && client->jobCount < SOLVERD_BACKLOG ? POLLIN : 0;
+            if (client->outputLength) events |= POLLOUT;
+            fds[count++] = (struct pollfd) {client->fd, events, 0};
+        } // A client with too many requests waiting is read once they are sent
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int wait = -1;
+        for (int index = 0 ; index < workerCount ; index++) {
+            if (!workers[index].job) continue;
+            long left = (workers[index].deadline.tv_sec - now.tv_sec) * 1000
+                + (workers[index].deadline.tv_nsec - now.tv_nsec) / 1000000;
+            if (left < 0) left = 0;
+            if (wait < 0 || left < wait) wait = left;
+        } // Waking up at the first time limit
+
+        if (poll(fds, count, wait) < 0) {
+            if (errno == EINTR) continue;
+            exitFatal("in main(), poll failed");
+        }
+
+        for (int index = 0 ; index < workerCount ; index++) {
+            if (fds[1 + index].revents) readWorker(&workers[index], listener);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        for (int index = 0 ; index < workerCount ; index++) {
+            solverWorker * worker = &workers[index];
+            if (worker->job && (now.tv_sec > worker->deadline.tv_sec
+                        || (now.tv_sec == worker->deadline.tv_sec
+                            && now.tv_nsec >= worker->deadline.tv_nsec))) {
+                restartWorker(worker, listener, "error timeout");
+            }
+        }
+
+        int pollIndex = 1 + workerCount;
+        for (int index = 0 ; index < SOLVERD_CLIENTS ; index++) {
+            if (!clients[index]) continue;
+            short revents = fds[pollIndex++].revents;
+            if ((revents & POLLIN && !readClient(clients[index]))
+                    || (revents & (POLLERR | POLLHUP) && !(revents & POLLIN))) {
+                closeClient(index);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, NULL, NULL);
+            int slot = 0;
+            while (slot < SOLVERD_CLIENTS && clients[slot]) slot++;
+            if (fd >= 0 && slot == SOLVERD_CLIENTS) {
+                close(fd);
+            } else if (fd >= 0) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                clients[slot] = (solverClient *) ec_malloc(sizeof(solverClient));
+                memset(clients[slot], 0, sizeof(solverClient));
+                clients[slot]->fd = fd;
+            }
+        }
+
+        dispatchJobs();
+        for (int index = 0 ; index < SOLVERD_CLIENTS ; index++) {
+            solverClient * client = clients[index];
+            if (client && (!flushReplies(client) || (client->draining
+                            && !client->head && !client->outputLength))) {
+                closeClient(index);
+            } // A client which stopped sending is closed once answered
+        }
+    }
+
+    for (int index = 0 ; index < workerCount ; index++) {
+        kill(workers[index].pid, SIGKILL);
+        waitpid(workers[index].pid, NULL, 0);
+    }
+    close(listener);
+    unlink(socketPath);
+    if (cache) {
+        if (cachePath && !saveSolveCache(cache)) {
+            fprintf(stderr, "Unable to save the cache to %s\n", cachePath);
+        }
+        freeSolveCache(cache);
+    }
+    destroyCube(requestData);
+    destroyCube(solvedData);
+    return 0;
+}
@@ -14,59 +14,83 @@ void displayUsage()
             " scramble\n");
     printf("\t-s [seed] : A seed for the scrambling, between 0 "
             "and 2147483647\n");
+    printf("\t-r [file] : record the session (moves and timings) to a file\n");
+    printf("\t-p [file] : play back a recorded session in real time\n");
+    printf("\t-o : on-demand rendering, only redraw the window when something"
+            " changed\n");
+    printf("\t-t [file] : write the timings of the last frames to a CSV file"
+            " on exit\n");
 }
 
-mode argParsing(int argc, char ** argv)
+settings argParsing(int argc, char ** argv)
 {
-    unsigned int seed = time(NULL);
-    if (argc == 3 && (strcmp(argv[1], "-s") == 0)) {
-        char * next;
-        seed = strtol(argv[2], &next, 10) % INT_MAX;
-        srand(seed);
-        printf("Seed is: %d\n", seed);
-        return NORMAL;
+    settings gameSettings = {NORMAL, time(NULL), NULL, NULL, NULL, false,
+        NULL};
+    int option;
+
+    while ((option = getopt(argc, argv, "CS:s:r:p:ot:h")) != -1) {
+        switch (option) {
+            case 'C':
+                gameSettings.gameMode = COMPLETE;
+                break;
+            case 'S':
+                gameSettings.gameMode = SCRAMBLE_SEQ;
+                gameSettings.scramble = optarg;
+                break;
+            case 's':
+                gameSettings.seed = strtol(optarg, NULL, 10) % INT_MAX;
+                break;
+            case 'r':
+                gameSettings.recordPath = optarg;
+                break;
+            case 'p':
+                gameSettings.replayPath = optarg;
+                break;
+            case 'o':
+                gameSettings.onDemand = true;
+                break;
+            case 't':
+                gameSettings.profilePath = optarg;
+                break;
+            default:
+                displayUsage();
+                exit(1);
+        }
     }
-    srand(seed);
-    printf("Seed is: %d\n", seed);
 
-    if (argc < 2) return NORMAL;
-    if (argc > 3) {
+    if (optind < argc) {
         displayUsage();
         exit(1);
     } // Taking care of edge cases the most straightforward way possible.
 
-    mode gameMode = NORMAL;
-    if (argc == 2 && (strcmp(argv[1], "-C") == 0)) return COMPLETE;
-    if (argc == 3 && (strcmp(argv[1], "-S") == 0)) {
-        gameMode = SCRAMBLE_SEQ;
+    srand(gameSettings.seed);
+    printf("Seed is: %d\n", gameSettings.seed);
 
+    if (gameSettings.gameMode == SCRAMBLE_SEQ) {
         // Verification of command sequence validity
-        move * moves = commandParser(argv[2]);
+        move * moves = commandParser(gameSettings.scramble);
         if (!moves) {
             printf("Command string is invalid\n\n");
             displayUsage();
             exit(1);
         }
-        return gameMode;
-   }
+        free(moves);
+    }
 
-    displayUsage();
-    exit(1);
-    return gameMode;
+    return gameSettings;
 }
 
 move * initGame(
         cube * cubeData,
         rubikview * mainView,
-        mode gameMode,
-        char ** argv
+        settings * gameSettings
         )
 {
     // Recovering the scramble sequence
     move * moves;
-    if (gameMode == SCRAMBLE_SEQ) {
-        moves = expandCommand(commandParser(argv[2]));
-    } else if (gameMode == NORMAL) {
+    if (gameSettings->gameMode == SCRAMBLE_SEQ) {
+        moves = expandCommand(commandParser(gameSettings->scramble));
+    } else if (gameSettings->gameMode == NORMAL) {
         moves = randomScramble(16, 60);
     } else {
         moves = (move *) ec_malloc(sizeof(move));
@@ -21,15 +21,36 @@ typedef enum mode {
     COMPLETE
 } mode;
 
+/**
+ * Structure holding everything the player asked for on the command line
+ */
+typedef struct _settings {
+    mode gameMode;          /**< The game mode */
+    unsigned int seed;      /**< The seed used for random scrambles */
+    char * scramble;        /**< The scramble string passed with -S */
+    char * recordPath;      /**< Path of the session log to record, or NULL */
+    char * replayPath;      /**< Path of the session log to replay, or NULL */
+    bool onDemand;          /**< True to redraw only when something changed */
+    char * profilePath;     /**< Path of the CSV file of the frame timings,
+                              or NULL */
+} settings;
+
 /**
  * Displays the command-line usage of the program
  */
 void displayUsage();
 
 /**
- * Parses arguments to resolve the game mode
+ * Parses arguments to resolve the game settings
+ *
+ * Seeds the random generator with the seed given with -s, or with the
+ * current time if none was given.
+ *
+ * @param argc - Number of command-line args
+ * @param argv - Pointer to the standard array of command-line args
+ * @returns the settings of the game
  */
-mode argParsing(int argc, char ** argv);
+settings argParsing(int argc, char ** argv);
 
 /**
  * Initialize the game according to the selected game mode
@@ -39,14 +60,13 @@ mode argParsing(int argc, char ** argv);
  *
  * @param cubeData - Pointer to the cube 2D data structure to init.
  * @param mainView - Pointer to the cube 3D data structure to init.
- * @param gameMode
- * @param argv - Pointer to the standard array of command-line args
+ * @param gameSettings - Pointer to the settings parsed by argParsing()
+ * @returns the scramble sequence applied, terminated by -1
  */
 move * initGame(
         cube * cubeData,
         rubikview * mainView,
-        mode gameMode,
-        char ** argv
+        settings * gameSettings
         );
 
 #endif
@@ -8,21 +8,24 @@ move * commandParser(const char * str) {
         return nothing;
     } // Check if string exists
 
-    // Making a copy of str
+    // Making a copy of str, with its endmark
     char * strCopy = (char *) ec_malloc(sizeof(char)*(strlen(str)+1));
-    strncpy(strCopy, str, strlen(str));
+    memcpy(strCopy, str, strlen(str) + 1);
 
     // Command tokenization
     int tokenNb = 1;
     char ** tokens = (char **) ec_malloc(sizeof(char *) * tokenNb);
 
-    // First call to strtok with start pointer
-    char * cmdToken = strtok(strCopy, " ");
-    do {
+    // First call to strtok_r with start pointer, reentrant so the solver can
+    // run in threads
+    char * savePtr = NULL;
+    char * cmdToken = strtok_r(strCopy, " ", &savePtr);
+    while (cmdToken) {
         tokens[tokenNb-1] = cmdToken;
         tokenNb += 1;
         tokens = (char **) ec_realloc(tokens, sizeof(char *) * tokenNb);
-    } while ((cmdToken = strtok(NULL, " "))); // Next calls with NULL
+        cmdToken = strtok_r(NULL, " ", &savePtr); // Next calls with NULL
+    }
 
     // Convert token in moves
     move * moves;
@@ -30,18 +33,26 @@ move * commandParser(const char * str) {
     int index;
     for (index = 0 ; index < tokenNb-1 ; index++) {
         move currentMove = mapCodeToMove(tokens[index]);
+        if ((int) currentMove == -1) {
+            free(moves);
+            moves = NULL;
+            break;
+        } // Incorrect command
         moves[index] = currentMove;
     }
-    moves[index] = -1; // Endmark for move array
+    if (moves) {
+        moves[index] = -1; // Endmark for move array
+    }
 
     free(tokens);
+    free(strCopy);
     return moves;
 }
 
 char * commandToString(move * moves) {
     // Allocation of max memory that could be necessary
     char * tempCmdStr = (char *) \
-        ec_malloc(sizeof(char) * 4 * sizeOfMoveArray(moves));
+        ec_malloc(sizeof(char) * (4 * sizeOfMoveArray(moves) + 1));
 
     int index = 0;
     move currMove = -1;
@@ -56,8 +67,10 @@ char * commandToString(move * moves) {
 
     // Reallocating the memory needed and freeing the excess memory
     int length = strlen(tempCmdStr);
-    char * cmdStr = (char *) ec_malloc(sizeof(char) * (length));
-    strncpy(cmdStr, tempCmdStr, length);
+    if (length > 0) length--; // Without the last space
+    char * cmdStr = (char *) ec_malloc(sizeof(char) * (length + 1));
+    memcpy(cmdStr, tempCmdStr, length);
+    cmdStr[length] = '\0';
     free(tempCmdStr);
 
     return cmdStr;
@@ -84,7 +97,7 @@ move * randomScramble(int sizeMin, int sizeMax) {
 
     a = 0;
     b= 29;
-    move * generatedMoves = (move *) ec_malloc(sizeof(move) * maxMoves + 1);
+    move * generatedMoves = (move *) ec_malloc(sizeof(move) * (maxMoves + 1));
     int index;
     for (index = 0 ; index < maxMoves ; index++) {
         generatedMoves[index] = (rand() % (b - a + 1)) + a;
@@ -93,21 +106,6 @@ move * randomScramble(int sizeMin, int sizeMax) {
     return generatedMoves;
 }
 
-void scrambleCube(
-        cube * cubeData,
-        rubikview * mainView,
-        move * moves
-        ) {
-
-    int index = 0;
-    move currmove = -1;
-    while(((int) (currmove = moves[index++]) != -1)) {
-        mainView->animate(mainView, currmove, true);
-        cubeData->rotate(cubeData, currmove);
-    }
-    return;
-}
-
 move * expandCommand(move * moves) {
     if (!moves) exitFatal("in expandCommand(), list of moves should not be NULL");
     int allocatedMvs = 4;
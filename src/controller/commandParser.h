@@ -11,7 +11,6 @@
 #include "errorController.h"
 #include "utils.h"
 #include "../model/cube.h"
-#include "../view/view.h"
 #include "commandQueue.h"
 /**
  * Parse and converts a string of commands in an array of moves
@@ -59,18 +58,6 @@ cube * executeBulkCommand(cube * aCube, move * moves);
  */
 move * randomScramble(int sizeMin, int sizeMax);
 
-/**
- * Scrambles the cube according a given sequence of moves
- *
- * @param cubeData - Pointer to the 2D cube data to scramble
- * @param cubeView - Pointer to the 3D cube data to scramble
- * @param moves - array of n+1 moves, the last one being the -1 endmark
- */
-void scrambleCube(
-        cube * cubeData,
-        rubikview * cubeView,
-        move * moves
-        );
 /**
  * Expands a list with double moves in a list with sequence of two moves
  *
@@ -2,32 +2,55 @@
  * @file commandQueue.c
  */
 #include "commandQueue.h"
+#include "packedMoves.h"
 
-typedef struct _moveLink {
-    move cmd;
-    struct _moveLink * next;
-} moveLink;
+#define QUEUE_INITIAL_CAPACITY 16 // Must be a power of 2
 
 typedef struct movequeue {
-    moveLink * head;
-    moveLink * tail;
+    unsigned char * data;   // circular buffer of moves packed on 6 bits
+    int start;              // index of the head in the buffer
+    int size;               // number of moves in the queue
+    int capacity;           // number of moves that fit in the buffer
+    unsigned long revision; // stamp of the last modification
 } movequeue, movestack;
 
+static unsigned long revisionClock = 0; // shared, no two queues get the same
+                                        // stamp
+
+/**
+ * Returns the index in the buffer of the nth move from the head
+ */
+static inline int bufferIndex(movequeue * queue, int nth) {
+    return (queue->start + nth) & (queue->capacity - 1);
+}
+
 /**
- * Function to create a new link for the queue/stack linked list
- * @param cmd, command code to store in new link
- * @returns a new moveLink
+ * Doubles the capacity of the queue buffer
+ *
+ * The moves are copied to the new buffer in order, starting at index 0
+ * @param queue, pointer to the queue to grow
  */
-moveLink * initMoveLink(move cmd) {
-    moveLink * link = (moveLink * ) ec_malloc(sizeof(moveLink));
-    link->next = NULL;
-    link->cmd = cmd;
-    return link;
+static void growQueue(movequeue * queue) {
+    int capacity = queue->capacity * 2;
+    unsigned char * data = (unsigned char *) ec_malloc(
+            PACKED_MOVES_BYTES(capacity));
+    for (int index = 0 ; index < queue->size ; index++) {
+        writePackedMove(data, index,
+                readPackedMove(queue->data, bufferIndex(queue, index)));
+    }
+    free(queue->data);
+    queue->data = data;
+    queue->start = 0;
+    queue->capacity = capacity;
 }
 
 movequeue * initQueue() {
     movequeue * newQueue = (movequeue *) ec_malloc(sizeof(movequeue));
-    newQueue->tail = newQueue->head = NULL;
+    newQueue->capacity = QUEUE_INITIAL_CAPACITY;
+    newQueue->data = (unsigned char *) ec_malloc(
+            PACKED_MOVES_BYTES(QUEUE_INITIAL_CAPACITY));
+    newQueue->start = newQueue->size = 0;
+    newQueue->revision = ++revisionClock;
     return newQueue;
 }
 
@@ -36,26 +59,21 @@ movestack * initStack() {
 }
 
 movequeue * enqueue(movequeue * queue, move cmd) {
-    moveLink * newLink = initMoveLink(cmd);
-    if (isEmpty(queue)) {
-        queue->head = newLink;
-        queue->tail = newLink;
-    } else {
-        queue->tail->next = newLink;
-        queue->tail = newLink;
-    }
+    if (isEmpty(queue)) queue->start = 0;
+    if (queue->size == queue->capacity) growQueue(queue);
+    writePackedMove(queue->data, bufferIndex(queue, queue->size), cmd);
+    queue->size++;
+    queue->revision = ++revisionClock;
     return queue;
 }
 
 movestack * push(movestack * stack, move toAdd) {
-    moveLink * newLink = initMoveLink(toAdd);
-    if (isEmpty(stack)){
-        stack->head = newLink;
-        stack->tail = newLink;
-    } else {
-         newLink->next = stack->head;
-         stack->head = newLink;
-    }
+    if (isEmpty(stack)) stack->start = 0;
+    if (stack->size == stack->capacity) growQueue(stack);
+    stack->start = bufferIndex(stack, -1); // The head moves back by one move
+    writePackedMove(stack->data, stack->start, toAdd);
+    stack->size++;
+    stack->revision = ++revisionClock;
     return stack;
 }
 
@@ -63,15 +81,10 @@ move dequeue(movequeue * queue) {
     if (isEmpty(queue)) {
         return -1;
     }
-    moveLink * temp = queue->head;
-    if (temp == queue->tail) { // queue is now empty
-        queue->head = queue->tail = NULL;
-    } else {
-        queue->head = temp->next;
-    }
-
-    move cmd = temp->cmd;
-    free(temp); // freeing old head
+    move cmd = readPackedMove(queue->data, queue->start);
+    queue->start = bufferIndex(queue, 1);
+    queue->size--;
+    queue->revision = ++revisionClock;
     return cmd;
 }
 
@@ -82,8 +95,7 @@ move pop(movestack * stack) {
 _Bool isEmpty(movequeue * queue) {
     if (!queue)
         exitFatal("in queue(), a queue must be initialized before use !");
-    // if head and tail are NULL, queue is empty
-    return (!queue->head && !queue->tail);
+    return queue->size == 0;
 }
 
 void printQueue(movequeue * queue) {
@@ -92,16 +104,15 @@ void printQueue(movequeue * queue) {
         return;
     }
 
-    moveLink * curr = queue->head;
-    while (curr != NULL) {
-        printf("[%s]", mapMoveToCode(curr->cmd));
-        curr = curr->next;
+    for (int index = 0 ; index < queue->size ; index++) {
+        move cmd = readPackedMove(queue->data, bufferIndex(queue, index));
+        printf("[%s]", mapMoveToCode(cmd));
     }
     printf("\n");
 }
 
 void freeQueue(movequeue * queue) {
-    while ((int)dequeue(queue) != -1); // freeing all links
+    free(queue->data);
     free(queue);
 }
 
@@ -112,12 +123,9 @@ void freeStack(movestack * stack) {
 move * head(movequeue * queue, int nb) {
     move * moves = (move *) ec_malloc(sizeof(move)*(nb+1));
 
-    moveLink * currentLink = queue->head;
     int i = 0;
-    while(i < nb) {
-        if (currentLink == NULL) break;
-        moves[i++] = currentLink->cmd; // saving cmd
-        currentLink = currentLink->next;
+    for ( ; i < nb && i < queue->size ; i++) {
+        moves[i] = readPackedMove(queue->data, bufferIndex(queue, i));
     }
     moves[i] = -1; // Endmark
     return moves;
@@ -132,27 +140,24 @@ int sizeOfMoveArray(move * moves) {
     return nb;
 }
 
+unsigned long queueRevision(mvqueue queue) {
+    return queue->revision;
+}
+
 int sizeOfMoveQueue(mvqueue queue) {
     if (isEmpty(queue)) return 0;
-    int nb = 0;
-    moveLink * curr = queue->head;
-    while(curr != NULL) {
-        nb += 1;
-        curr = curr->next;
-    }
-
-    return nb;
+    return queue->size;
 }
 
 mvqueue toMvQueue(move * moves) {
     mvqueue queue = initQueue();
-
-    move currmove = -1;
-
-    while((int)(currmove = *(moves++)) != -1){
-        enqueue(queue, currmove);
-    }
-
+    int size = sizeOfMoveArray(moves) - 1;
+    while (queue->capacity < size) queue->capacity *= 2;
+    queue->data = (unsigned char *) ec_realloc(queue->data,
+            PACKED_MOVES_BYTES(queue->capacity));
+    packMoveBuffer(queue->data, moves, size); // Starts at index 0
+    queue->size = size;
+    queue->revision = ++revisionClock;
     return queue;
 }
 
@@ -162,11 +167,13 @@ move * toMvArray(mvqueue queue) {
     int size = sizeOfMoveQueue(queue);
 
     mvArray = (move *) ec_malloc(sizeof(move) * (size+1));
-    moveLink * curr = queue->head;
     int index = 0;
+    if (queue->start + size <= queue->capacity && (queue->start & 3) == 0) {
+        unpackMoveBuffer(mvArray, queue->data + queue->start / 4 * 3, size);
+        index = size;
+    } // Bulk decoding when the moves are contiguous and aligned on a group
     for (; index < size ; index++) {
-        *(mvArray+index) = curr->cmd;
-        curr = curr->next;
+        *(mvArray+index) = readPackedMove(queue->data, bufferIndex(queue, index));
     }
     *(mvArray+index) = -1;
     return mvArray;
@@ -178,14 +185,13 @@ move * mvCat(move * array1, move * array2) {
     int size2 = sizeOfMoveArray(array2);
     arrayCat = (move *) ec_malloc(sizeof(move) * (size1+size2-1));
     int i = 0;
-    for ( ; i < size1 ; i++) {
+    for ( ; i < size1 - 1 ; i++) {
         *(arrayCat+i) = *(array1+i);
-    }
+    } // Copy of array1 without its endmark
 
-    i-=1;
-    for ( ; i-size1 <= size2 ; i++) {
-        *(arrayCat+i) = *(array2+(i-size1));
-    }
+    for (int j = 0 ; j < size2 ; j++) {
+        *(arrayCat+i+j) = *(array2+j);
+    } // Copy of array2 with its endmark
 
     return arrayCat;
 }
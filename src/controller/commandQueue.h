@@ -103,6 +103,17 @@ int sizeOfMoveArray(move * moves);
  */
 int sizeOfMoveQueue(mvqueue queue);
 
+/**
+ * Returns the revision of a mvqueue
+ *
+ * The revision changes every time the queue/stack is modified, and is never
+ * shared by two queues : comparing it to a saved one tells if a cache built
+ * from the queue is still valid, even if the queue has been replaced.
+ *
+ * @param queue movequeue pointer to the queue/stack data structure.
+ */
+unsigned long queueRevision(mvqueue queue);
+
 /**
  * Converts an array of moves to a mvqueue
  */
@@ -0,0 +1,143 @@
+/**
+ * @file crossTable.c
+ */
+
+#include "crossTable.h"
+
+/**
+ * The facelets of the edges, the moves and the distances, built once
+ */
+typedef struct _crossData {
+    tile facelets[CROSS_EDGE_FACELETS];     // The facelets of the edges
+    // The facelet where each move of faceMoves brings each facelet
+    unsigned char moves[CROSS_MOVES][CROSS_EDGE_FACELETS];
+    unsigned char distances[CROSS_TABLE_SIZE];  // Moves of each state
+} crossData;
+
+static void * _Atomic sharedData = NULL;
+
+/**
+ * Returns the state of the cross of a redressed cube
+ */
+static int readState(crossData * data, cube * aCube) {
+    int state = 0;
+    for (int edge = 0 ; edge < 4 ; edge++) {
+        state = state * CROSS_EDGE_FACELETS
+            + readCrossEdge(aCube, data->facelets, edge);
+    }
+    return state;
+}
+
+/**
+ * Splits a state in the facelets of the 4 white facelets
+ */
+static void decodeState(int state, int * facelets) {
+    for (int edge = 3 ; edge >= 0 ; edge--) {
+        facelets[edge] = state % CROSS_EDGE_FACELETS;
+        state /= CROSS_EDGE_FACELETS;
+    }
+}
+
+/**
+ * Returns the state reached by a move of faceMoves from decoded facelets
+ */
+static int applyMove(crossData * data, const int * facelets, int moveIndex) {
+    const unsigned char * moved = data->moves[moveIndex];
+    return ((moved[facelets[0]] * CROSS_EDGE_FACELETS + moved[facelets[1]])
+            * CROSS_EDGE_FACELETS + moved[facelets[2]])
+        * CROSS_EDGE_FACELETS + moved[facelets[3]];
+}
+
+/**
+ * Builds the moves of the facelets and the distances of the states
+ */
+static void * buildCrossData() {
+    crossData * data = (crossData *) ec_malloc(sizeof(crossData));
+    listFacelets(NULL, data->facelets);
+    for (int moveIndex = 0 ; moveIndex < CROSS_MOVES ; moveIndex++) {
+        faceletMoves(data->facelets, CROSS_EDGE_FACELETS,
+                &faceMoves[moveIndex], 1, data->moves[moveIndex]);
+    }
+
+    // Breadth-first search from the solved cross
+    memset(data->distances, CROSS_UNKNOWN, CROSS_TABLE_SIZE);
+    int * queue = (int *) ec_malloc(sizeof(int) * CROSS_TABLE_SIZE);
+    cube * solved = initCube();
+    queue[0] = readState(data, solved);
+    destroyCube(solved);
+    data->distances[queue[0]] = 0;
+    for (int head = 0, tail = 1 ; head < tail ; head++) {
+        int facelets[4];
+        decodeState(queue[head], facelets);
+        for (int moveIndex = 0 ; moveIndex < CROSS_MOVES ; moveIndex++) {
+            int next = applyMove(data, facelets, moveIndex);
+            if (data->distances[next] == CROSS_UNKNOWN) {
+                data->distances[next] = data->distances[queue[head]] + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+    free(queue);
+    return data;
+}
+
+/**
+ * Returns the table, built by the first call
+ */
+static crossData * getCrossData() {
+    return (crossData *) lazyTable(&sharedData, buildCrossData);
+}
+
+/**
+ * Returns the state of the cross of a cube in any orientation
+ */
+static int crossState(crossData * data, cube * self) {
+    cube * redressed = self->copy(self);
+    redressCube(redressed);
+    int state = readState(data, redressed);
+    destroyCube(redressed);
+    return state;
+}
+
+const unsigned char * crossDistances() {
+    return getCrossData()->distances;
+}
+
+int crossDistance(cube * self) {
+    crossData * data = getCrossData();
+    return data->distances[crossState(data, self)];
+}
+
+char * solveCross(cube * self) {
+    crossData * data = getCrossData();
+    char * movements = (char *) ec_malloc(sizeof(char)
+            * (CROSS_MAX_DEPTH * 3 + 8));
+    *movements = '\0';
+
+    int faces[6];
+    redressedFaces(self, faces);
+
+    int state = crossState(data, self);
+    while (data->distances[state] > 0) {
+        int facelets[4];
+        decodeState(state, facelets);
+        int moveIndex = 0;
+        int next = applyMove(data, facelets, moveIndex);
+        while (data->distances[next] != data->distances[state] - 1) {
+            next = applyMove(data, facelets, ++moveIndex);
+        } // A move one step closer to the cross
+
+        move played = unredressMove(faces, faceMoves[moveIndex]);
+        self->rotate(self, played);
+        strcat(movements, mapMoveToCode(played));
+        strcat(movements, " ");
+        state = next;
+    }
+
+    // The next steps start with the cross down, as doWhiteCross() leaves it
+    char * position = positionCommand(self, 'g', 'y');
+    strcat(movements, position);
+    free(position);
+    positionCube(self, 'g', 'y');
+    return movements;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file crossTable.h
+ * Optimal white cross from a table of distances
+ *
+ * The state of the cross is where the white facelets of the 4 white edges are,
+ * among the 24 facelets of the edges, which makes 24 * 22 * 20 * 18 = 190080
+ * states. A breadth-first search from the solved cross over the 18 face moves
+ * gives the distance of every state, at most 8 moves. The cross is then solved
+ * by playing, from any state, a move bringing it one move closer.
+ *
+ * The table is built at the first call, in a few milliseconds, and shared by
+ * the threads. The states are read on the cube redressed with green on front
+ * and white on top, and the moves are played on the faces of the same centers,
+ * so the cube is not turned.
+ */
+
+#ifndef CROSS_TABLE_H
+#define CROSS_TABLE_H
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../model/cube.h"
+#include "../model/cubelet.h"
+#include "patternComparator.h"
+#include "solverTables.h"
+#include "utils.h"
+
+#define CROSS_EDGE_FACELETS 24      /**< Facelets of the edges of a cube */
+#define CROSS_TABLE_SIZE 331776     /**< 24^4 indexes, 190080 of them valid */
+#define CROSS_MOVES 18              /**< The face moves */
+#define CROSS_MAX_DEPTH 8           /**< Moves of the farthest cross */
+#define CROSS_UNKNOWN 0xFF          /**< Distance of an invalid index */
+
+/**
+ * Returns the table of the distances of the cross, built by the first call
+ *
+ * The state of a cube redressed with green on front and white on top is
+ * ((g * 24 + r) * 24 + o) * 24 + b, with g, r, o and b the places of the white
+ * facelets of the green, red, orange and blue edges. A place is the index of
+ * the facelet among the facelets of the edges (see isEdge()), face after face
+ * and row by row.
+ *
+ * @returns the CROSS_TABLE_SIZE distances, CROSS_UNKNOWN for the indexes which
+ *  are not states
+ */
+const unsigned char * crossDistances();
+
+/**
+ * Returns the number of moves of an optimal white cross
+ *
+ * @param self the cube, which is not modified
+ * @returns 0 to CROSS_MAX_DEPTH
+ */
+int crossDistance(cube * self);
+
+/**
+ * Does an optimal white cross, first step of trueSolve()
+ *
+ * @param self the cube, on which the moves are played
+ * @returns the space separated moves, to be freed
+ */
+char * solveCross(cube * self);
+
+#endif
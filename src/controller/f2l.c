@@ -20,7 +20,7 @@ bool edgePlaced(cube *self){
 
 
 char *doWhiteCross(cube* self){
-	char *movements = ec_malloc(sizeof(char)*500);
+	char *movements = ec_malloc(sizeof(char)*STEP_MOVES_LENGTH);
 	//  debug("start");
 	edge e;
 	char colors[4] ={'o','b','r','g'};
@@ -29,25 +29,20 @@ char *doWhiteCross(cube* self){
 	{
 		//debug("On repasse dans whiteCrossDone");
 		//debug("On passe dans edgePlaced");
-		printCube(self);
 
 		for(int i=0; i <4; i++){
 			e = searchWhiteEdge(self, colors[i]);
-			char * strPosition = NULL;
 			if(getFaceColor(self,e.tiles[1]) == 'y'){
-				strPosition = positionCommand(self, getFaceColor(self,e.tiles[0]),'y');
-				strcat(movements, strPosition);
+				catPositionCommand(movements, self, getFaceColor(self,e.tiles[0]),'y');
 				positionCube(self,getFaceColor(self,e.tiles[0]),'y');
 			}
 			else if(getFaceColor(self,e.tiles[1]) == 'w'){
-				strPosition = positionCommand(self, getFaceColor(self,e.tiles[0]),'y');
-				strcat(movements,positionCommand(self, getFaceColor(self,e.tiles[0]),'y'));
+				catPositionCommand(movements, self, getFaceColor(self,e.tiles[0]),'y');
 				//strcat(movements," ");
 				positionCube(self,getFaceColor(self,e.tiles[0]),'y');
 			}
 			else{
-				strPosition = positionCommand(self, getFaceColor(self,e.tiles[1]),'y');
-				strcat(movements,positionCommand(self, getFaceColor(self,e.tiles[1]),'y'));
+				catPositionCommand(movements, self, getFaceColor(self,e.tiles[1]),'y');
 				//strcat(movements," ");
 				positionCube(self,getFaceColor(self,e.tiles[1]),'y');
 			}
@@ -55,18 +50,13 @@ char *doWhiteCross(cube* self){
 			if(ifPair(self,e,e.tiles[1].face)){
 				while(correctPositionCross(self,e)==false){
 					self->rotate(self,F);
-					strcat(movements, "F ");
+					catMoves(movements, "F ");
 					e = searchWhiteEdge(self, colors[i]);
 
 				}
 			} else {
-				debug("So far so good line 71");
-				printEdge(self,e);
-				debug("Before printing cube");
 				//printCube(self);
 				if(e.tiles[0].col == 2 && e.tiles[1].col == 0) {
-					debug("Debug printing cube");
-					printCube(self);
 					self->rotate(self,F);
 					self->rotate(self,U);
 					self->rotate(self,Fi);
@@ -75,13 +65,10 @@ char *doWhiteCross(cube* self){
 					//						printf("Null\n");
 					//					fprintf(stderr, "[%s]\n", movements);
 					//					fprintf(stderr, "After fprintf, before strcat\n");
-					strcat(movements, "F U Fi ");
+					catMoves(movements, "F U Fi ");
 
 				}
 				else if (e.tiles[0].col == 0 && e.tiles[1].col == 2) {
-					debug("stuck2\n");
-					debug("Debug printing cube");
-					printCube(self);
 					self->rotate(self,Fi);
 					self->rotate(self,U);
 					self->rotate(self,F);
@@ -90,22 +77,17 @@ char *doWhiteCross(cube* self){
 					//					if (movements == NULL)
 					//						printf("Null\n");
 					//					fprintf(stderr, "before strcat %s\n", movements);
-					strcat(movements, "Fi U F ");
+					catMoves(movements, "Fi U F ");
 				}
 				else if((isEdgeOnFace(e,D)) \
 						&& (self->cube[U][2][1] != 'w' \
 							&& self->cube[F][0][1] != 'w'))
 				{
-					debug("else if 2\n");
-					fprintf(stderr, "Cube is :\n");
-					printCube(self);
-					fprintf(stderr, "\n");
 					self->rotate(self,F2);
 					//					if (movements == NULL)
 					//						printf("Null\n");
 					//					fprintf(stderr, "[%s]\n", movements);
-					strcat(movements, "F F ");
-					fprintf(stderr, "[%s]\n", movements);
+					catMoves(movements, "F F ");
 				} else if((isEdgeOnFace(e,D)) \
 						&& (self->cube[F][0][1] == 'w' \
 							|| self->cube[U][2][1] == 'w'))
@@ -113,12 +95,11 @@ char *doWhiteCross(cube* self){
 					//printCube(self);
 					while(self->cube[F][0][1] == 'w' || self->cube[U][2][1] == 'w'){
 						self->rotate(self,U);
-						strcat(movements, "U ");
+						catMoves(movements, "U ");
 					}
 					self->rotate(self,F2);
-					strcat(movements, "F F ");//Case where two edges are on the same column
+					catMoves(movements, "F F ");//Case where two edges are on the same column
 				} else {
-					debug("This is else\n");
 					// printEdge(self, e);
 					// printCube(self);
 
@@ -131,9 +112,7 @@ char *doWhiteCross(cube* self){
 						//fprintf(stderr, "str : [%s]\n", str);
 						//fprintf(stderr, "color :[%c]\n", color);
 						//strcat(movements, str);
-						fprintf(stderr, "[%s]\n", movements);
-						strPosition = positionCommand(self,getColorTile(self,e.tiles[1]),'y');
-						strcat(movements, strPosition);
+						catPositionCommand(movements, self,getColorTile(self,e.tiles[1]),'y');
 						positionCube(self,getColorTile(self,e.tiles[1]),'y');
 						while((((self->cube[F][0][1] != getColorTile(self,e.tiles[0])) \
 									&& (self->cube[U][2][1] != getColorTile(self,e.tiles[1]))) \
@@ -141,21 +120,21 @@ char *doWhiteCross(cube* self){
 									&& (self->cube[U][2][1] != getColorTile(self,e.tiles[0])))) \
 								&& ((getColorTile(self,e.tiles[1]) != self->cube[F][1][1]))) {
 							self->rotate(self,U);
-							strcat(movements, "U ");
+							catMoves(movements, "U ");
 							e = searchWhiteEdge(self, colors[i]);
 						}
 						self->rotate(self,U);
-						strcat(movements, "U ");
+						catMoves(movements, "U ");
 					}
 					else
 					{
-						strcat(movements,positionCommand(self, getColorTile(self,e.tiles[0]),'y'));
+						catPositionCommand(movements, self, getColorTile(self,e.tiles[0]),'y');
 						positionCube(self,getColorTile(self,e.tiles[0]),'y');
 						e = searchWhiteEdge(self, colors[i]);
 						while((self->cube[F][0][1] != getColorTile(self,e.tiles[0])) \
 								&& (self->cube[U][2][1] != getColorTile(self,e.tiles[0]))) {
 							self->rotate(self,U);
-							strcat(movements, "U ");
+							catMoves(movements, "U ");
 							e = searchWhiteEdge(self, colors[i]);
 						}
 
@@ -168,7 +147,7 @@ char *doWhiteCross(cube* self){
 						self->rotate(self,Ri);
 						self->rotate(self,F);
 						self->rotate(self,R);
-						strcat(movements, "Ui Ri F R ");
+						catMoves(movements, "Ui Ri F R ");
 					}
 				}
 			}
@@ -179,14 +158,14 @@ char *doWhiteCross(cube* self){
 		char colors[4] ={'o','b','r','g'};
 		for(int i=0; i <4; i++){
 			e = searchWhiteEdge(self, colors[i]);
-			strcat(movements,positionCommand(self, colors[i], 'y'));
+			catPositionCommand(movements, self, colors[i], 'y');
 			positionCube(self,colors[i],'y');
 			if(isEdgeOnFace(e,U)){
 				while(correctPositionCross(self, e) == false){
 					if(self->cube[U][2][1] == 'w' \
 							&& self->cube[F][0][1] == self->cube[F][1][1] ){
 						self->rotate(self,F2);
-						strcat(movements, "F2 ");
+						catMoves(movements, "F2 ");
 					}
 					else if(self->cube[F][0][1] == 'w' \
 							&& self->cube[U][2][1] == self->cube[F][1][1] ){
@@ -194,11 +173,11 @@ char *doWhiteCross(cube* self){
 						self->rotate(self,Ri);
 						self->rotate(self,F);
 						self->rotate(self,R);
-						strcat(movements, "Ui Ri F R ");
+						catMoves(movements, "Ui Ri F R ");
 					}
 					else{
 						self->rotate(self,U);
-						strcat(movements, "U ");
+						catMoves(movements, "U ");
 					}
 					e = searchWhiteEdge(self, colors[i]);
 				}
@@ -351,6 +330,7 @@ bool firstLayerDone(cube *self){
 		}
 	}
 	bool test = patternMatches(self,clone);
+	destroyCube(clone);
 	return test;
 }
 
@@ -386,10 +366,6 @@ bool secondLayerDone(cube *self){
 		}
 	}
 	bool test = patternMatches(clone, pattern);
-	debug("pattern");
-	printCube(pattern);
-	debug("clone");
-	printCube(clone);
 
 	destroyCube(clone);
 	destroyCube(pattern);
@@ -398,7 +374,7 @@ bool secondLayerDone(cube *self){
 
 char *orientWhiteCorners(cube *self){
 	corner elt = {0};
-	char *movements = ec_malloc(sizeof(char)*400);
+	char *movements = ec_malloc(sizeof(char)*STEP_MOVES_LENGTH);
 	*movements = '\0';
 	char corners[4][2] = {{'o','b'},{'b','r'},{'r','g'}, {'g','o'}};
 	char faceColor;
@@ -418,30 +394,30 @@ char *orientWhiteCorners(cube *self){
 
 				}
 				//printf("face color %c\n",faceColor);
-				strcat(movements,positionCommand(self,faceColor,'y'));
+				catPositionCommand(movements, self, faceColor,'y');
 				positionCube(self,faceColor,'y');
 				elt = searchWhiteCorner(self, corners[i][0], corners[i][1]);
 				if(isCornerOnFace(elt,R)){
 					self->rotate(self,R);
 					self->rotate(self,U);
 					self->rotate(self,Ri);
-					strcat(movements, "R U Ri ");}
+					catMoves(movements, "R U Ri ");}
 				else{
 					self->rotate(self,Li);
 					self->rotate(self,Ui);
 					self->rotate(self,L);
-					strcat(movements, "Li Ui L ");
+					catMoves(movements, "Li Ui L ");
 				}
 				elt = searchWhiteCorner(self, corners[i][0], corners[i][1]);
 
 			}//Moving corner to the top
-			strcat(movements,positionCommand(self,corners[i][0],'y'));
+			catPositionCommand(movements, self, corners[i][0],'y');
 			positionCube(self,corners[i][0],'y');
 			elt = searchWhiteCorner(self, corners[i][0], corners[i][1]);
 
 			while(isCornerOnFace(elt,F)==false || isCornerOnFace(elt,R)==false){
 				self->rotate(self,U);
-				strcat(movements, "U ");
+				catMoves(movements, "U ");
 				elt = searchWhiteCorner(self, corners[i][0], corners[i][1]);
 			}
 			elt = searchWhiteCorner(self, corners[i][0], corners[i][1]);
@@ -450,7 +426,7 @@ char *orientWhiteCorners(cube *self){
 				self->rotate(self,R);
 				self->rotate(self,U);
 				self->rotate(self,Ri);
-				strcat(movements, "R U Ri ");
+				catMoves(movements, "R U Ri ");
 			}
 			else if(self->cube[F][0][2] == corners[i][1])
 			{
@@ -461,7 +437,7 @@ char *orientWhiteCorners(cube *self){
 				self->rotate(self,R);
 				self->rotate(self,U);
 				self->rotate(self,Ri);
-				strcat(movements, "R U2 Ri Ui R U Ri ");
+				catMoves(movements, "R U2 Ri Ui R U Ri ");
 			}
 			else
 			{
@@ -469,12 +445,11 @@ char *orientWhiteCorners(cube *self){
 				self->rotate(self,F);
 				self->rotate(self,R);
 				self->rotate(self,Fi);
-				strcat(movements, "Ri F R Fi ");
+				catMoves(movements, "Ri F R Fi ");
 			}
 			elt = searchWhiteCorner(self, corners[i][0], corners[i][1]);
 		}
 	}
-	printCube(self);
 	return movements;
 }
 
@@ -482,7 +457,7 @@ char *orientWhiteCorners(cube *self){
 
 
 char *placeSecondLayer(cube *self){
-	char *movements = ec_malloc(sizeof(char)*600);
+	char *movements = ec_malloc(sizeof(char)*STEP_MOVES_LENGTH);
 	*movements = '\0';
 	char edges[4][2]= {{'b','r'},{'b','o'},{'g','o'}, {'g','r'}};
 	char colors[2] = {'b','g'};
@@ -498,20 +473,20 @@ char *placeSecondLayer(cube *self){
 	self->rotate(self,Ri);
 	self->rotate(self,Fi);
 	self->rotate(self,R);
-	strcat(movements, "U R Ui Ri F Ri Fi R "); // Execute one time the right algo to be sure that no edges stay stuck.
+	catMoves(movements, "U R Ui Ri F Ri Fi R "); // Execute one time the right algo to be sure that no edges stay stuck.
 	}
 
 	while(!secondLayerDone(self))
 	{
 		for(int faces = 0; faces < 2;faces++){
 			for(int e = 0; e < 4;e++){
-				strcat(movements,positionCommand(self,colors[faces],'y'));
+				catPositionCommand(movements, self, colors[faces],'y');
 				positionCube(self,colors[faces],'y');
 				elt = searchEdge(self, edges[e][0], edges[e][1]);
 				if(isEdgeOnFace(elt,U)){
 					while(!isEdgeOnFace(elt,F)){
 						self->rotate(self,U);
-						strcat(movements, "U ");
+						catMoves(movements, "U ");
 						elt = searchEdge(self, edges[e][0], edges[e][1]);
 					}
 					if (self->cube[F][0][1] == self->cube[F][1][1] \
@@ -525,7 +500,7 @@ char *placeSecondLayer(cube *self){
 						self->rotate(self,Ri);
 						self->rotate(self,Fi);
 						self->rotate(self,R);
-						strcat(movements, "U R Ui Ri F Ri Fi R ");
+						catMoves(movements, "U R Ui Ri F Ri Fi R ");
 					}
 					else if (self->cube[F][0][1] == self->cube[F][1][1] \
 							&& self->cube[U][2][1] == self->cube[L][1][1])
@@ -538,7 +513,7 @@ char *placeSecondLayer(cube *self){
 						self->rotate(self,F);
 						self->rotate(self,Ui);
 						self->rotate(self,Fi);
-						strcat(movements, "Ui Li U L U F Ui Fi ");
+						catMoves(movements, "Ui Li U L U F Ui Fi ");
 
 					}
 					else if (self->cube[F][0][1] == self->cube[L][1][1] \
@@ -560,7 +535,7 @@ char *placeSecondLayer(cube *self){
 						self->rotate(self,F);
 						self->rotate(self,Ui);
 						self->rotate(self,Fi);
-						strcat(movements, "Ui Li U L U F Ui Fi Ui Li U L U F Ui Fi ");
+						catMoves(movements, "Ui Li U L U F Ui Fi Ui Li U L U F Ui Fi ");
 					}
 					else if( self->cube[F][0][1] == self->cube[R][1][1] \
 							&& self->cube[U][2][1] == self->cube[F][1][1])
@@ -581,7 +556,7 @@ char *placeSecondLayer(cube *self){
 						self->rotate(self,Ri);
 						self->rotate(self,Fi);
 						self->rotate(self,R);
-						strcat(movements, "U R Ui Ri F Ri Fi R U R Ui Ri F Ri Fi R ");
+						catMoves(movements, "U R Ui Ri F Ri Fi R U R Ui Ri F Ri Fi R ");
 					}
 				}
 
@@ -606,7 +581,7 @@ char *placeSecondLayer(cube *self){
 						self->rotate(self,Ri);
 						self->rotate(self,Fi);
 						self->rotate(self,R);
-						strcat(movements, "U R Ui Ri F Ri Fi R U2 U R Ui Ri F Ri Fi R ");
+						catMoves(movements, "U R Ui Ri F Ri Fi R U2 U R Ui Ri F Ri Fi R ");
 
 					}
 					else if(  (self->cube[F][1][1] != self->cube[F][1][2] \
@@ -620,14 +595,14 @@ char *placeSecondLayer(cube *self){
 						self->rotate(self,Fi);
 						self->rotate(self,R);
 						self->rotate(self,U2);
-						strcat(movements, "R Ui Ri F Ri Fi R U2 ");
+						catMoves(movements, "R Ui Ri F Ri Fi R U2 ");
 					}
 
 					else
 					{
 
 						self->rotate(self,Ui);
-						strcat(movements, "Ui ");
+						catMoves(movements, "Ui ");
 elt = searchEdge(self, edges[e][0], edges[e][1]);
 
 					}
@@ -656,7 +631,7 @@ elt = searchEdge(self, edges[e][0], edges[e][1]);
 						self->rotate(self,Fi);
 						self->rotate(self,R);
 						self->rotate(self,U2);
-						strcat(movements, "Ui Li U L U F Ui Fi Ui Ui U R Ui Ri F Ri Fi R U2 ");
+						catMoves(movements, "Ui Li U L U F Ui Fi Ui Ui U R Ui Ri F Ri Fi R U2 ");
 
 					}
 					else if(  (self->cube[F][1][1] != self->cube[F][1][0] \
@@ -671,25 +646,23 @@ elt = searchEdge(self, edges[e][0], edges[e][1]);
 						self->rotate(self,Ui);
 						self->rotate(self,Fi);
 						self->rotate(self,U2);
-						strcat(movements, "Ui Li U L U F Ui Fi U2 ");
+						catMoves(movements, "Ui Li U L U F Ui Fi U2 ");
 					}
 									else
 					{
 						self->rotate(self,Ui);
-						strcat(movements, "Ui ");
+						catMoves(movements, "Ui ");
 					}
 
 				}
 				else
 				{
 					self->rotate(self,Ui);
-					strcat(movements, "Ui ");
+					catMoves(movements, "Ui ");
 elt = searchEdge(self, edges[e][0], edges[e][1]);
 
 				}
 
-				debug("WTF ? There is no case ?");
-				printCube(self);
 
 			}
 		}
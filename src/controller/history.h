@@ -7,7 +7,6 @@
 
 #include "commandQueue.h"
 #include "../model/cube.h"
-#include "../view/view.h"
 #include "errorController.h"
 
 /**
@@ -32,14 +31,5 @@ move popCmd(mvstack history);
  */
 void clearHistory(mvstack history);
 
-/**
- * Cancels the last move in the history
- *
- * @param cubeData - A pointer to the 2D cube data to modifiy
- * @param mainView - A pointer to the 3D cube data to modify
- * @param history - A stack of moves representing the history of moves
- */
-void cancelMove(cube * cubeData, rubikview * mainView, mvstack history);
-
 
 #endif
@@ -0,0 +1,343 @@
+/**
+ * @file lastLayerTable.c
+ */
+
+#include "lastLayerTable.h"
+
+static const char lastLayerMagic[4] = {'R', 'B', 'K', 'L'};
+
+/**
+ * The facelets of the up layer and the colours of its pieces, built once
+ */
+typedef struct _lastLayerData {
+    tile corners[LAST_LAYER_CORNERS];   // 3 facelets per corner, turning
+    tile edges[LAST_LAYER_EDGES];       // The up facelet, then the side one
+    char cornerColours[4][3];           // The colours of each solved corner
+    char edgeColours[4];                // The side colour of each solved edge
+} lastLayerData;
+
+/**
+ * A mapped table
+ */
+typedef struct _lastLayerTable {
+    const unsigned char * data;     // The file
+    size_t size;                    // Size of the file
+    const unsigned char * moves;    // The packed moves of the algorithms
+    unsigned long moveCount;        // Number of moves of all the algorithms
+} lastLayerTable;
+
+static void * _Atomic sharedData = NULL;
+static lastLayerTable * _Atomic sharedTable = NULL;
+static pthread_once_t defaultTable = PTHREAD_ONCE_INIT;
+
+/**
+ * Reads an offset of the table
+ */
+static unsigned long readOffset(const unsigned char * data, int index) {
+    const unsigned char * bytes = data + LAST_LAYER_HEADER_SIZE + 4 * index;
+    return bytes[0] | bytes[1] << 8 | bytes[2] << 16
+        | (unsigned long) bytes[3] << 24;
+}
+
+/**
+ * Returns the index of a facelet among the 54 facelets of a cube
+ */
+static int faceletLabel(tile facelet) {
+    return facelet.face * 9 + facelet.row * 3 + facelet.col;
+}
+
+/**
+ * Lists the facelets of the up layer : those of the first corner and of the
+ * first edge of the up face, then those reached by each turn of the up face.
+ * The facelets of every corner are thus listed turning the same way, which is
+ * what makes the sum of the twists a multiple of 3.
+ */
+static void * buildLastLayerData() {
+    lastLayerData * data = (lastLayerData *) ec_malloc(sizeof(lastLayerData));
+    tile corner = {U, 0, 0};
+    tile edge = {U, 0, 1};
+    adjacentTiles cornerSides = getAdjacentTiles(corner);
+    data->corners[0] = corner;
+    data->corners[1] = cornerSides.tiles[0];
+    data->corners[2] = cornerSides.tiles[1];
+    data->edges[0] = edge;
+    data->edges[1] = getAdjacentTiles(edge).tiles[0];
+
+    tile destinations[54];
+    const move upTurn = U;
+    labelledMoves(&upTurn, 1, destinations);
+    for (int index = 3 ; index < LAST_LAYER_CORNERS ; index++) {
+        data->corners[index] =
+            destinations[faceletLabel(data->corners[index - 3])];
+    }
+    for (int index = 2 ; index < LAST_LAYER_EDGES ; index++) {
+        data->edges[index] = destinations[faceletLabel(data->edges[index - 2])];
+    }
+
+    cube * solved = positionCube(initCube(), 'g', 'y');
+    for (int piece = 0 ; piece < 4 ; piece++) {
+        for (int index = 0 ; index < 3 ; index++) {
+            data->cornerColours[piece][index] =
+                getColorTile(solved, data->corners[piece * 3 + index]);
+        }
+        data->edgeColours[piece] =
+            getColorTile(solved, data->edges[piece * 2 + 1]);
+    }
+    destroyCube(solved);
+    return data;
+}
+
+/**
+ * Returns the facelets, built by the first call
+ */
+static lastLayerData * getLastLayerData() {
+    return (lastLayerData *) lazyTable(&sharedData, buildLastLayerData);
+}
+
+bool readLastLayer(cube * self, lastLayerState * state) {
+    lastLayerData * data = getLastLayerData();
+    int found = 0;
+    for (int place = 0 ; place < 4 ; place++) {
+        char colours[3];
+        int yellow = -1;
+        for (int index = 0 ; index < 3 ; index++) {
+            colours[index] =
+                getColorTile(self, data->corners[place * 3 + index]);
+            if (colours[index] == 'y') yellow = index;
+        }
+        if (yellow == -1) return false;
+
+        char next = colours[(yellow + 1) % 3];
+        char last = colours[(yellow + 2) % 3];
+        int piece = 0;
+        while (piece < 4 && (data->cornerColours[piece][1] != next
+                    || data->cornerColours[piece][2] != last)) {
+            piece++;
+        } // The corner of the same colours in the same order
+        if (piece == 4) return false;
+        state->corners[piece] = place * 3 + yellow;
+        found |= 1 << piece;
+    }
+
+    for (int place = 0 ; place < 4 ; place++) {
+        char up = getColorTile(self, data->edges[place * 2]);
+        char side = getColorTile(self, data->edges[place * 2 + 1]);
+        if (up != 'y' && side != 'y') return false;
+        char colour = up == 'y' ? side : up;
+        int piece = 0;
+        while (piece < 4 && data->edgeColours[piece] != colour) piece++;
+        if (piece == 4) return false;
+        state->edges[piece] = place * 2 + (up == 'y' ? 0 : 1);
+        found |= 1 << (piece + 4);
+    }
+    if (found != 0xFF) return false;
+
+    int twists = 0;
+    for (int piece = 0 ; piece < 4 ; piece++) {
+        twists += state->corners[piece] % 3;
+    }
+    if (twists % 3) return false;
+
+    // The permutations of the corners and of the edges have the same parity
+    int inversions = 0;
+    for (int piece = 0 ; piece < 4 ; piece++) {
+        for (int other = piece + 1 ; other < 4 ; other++) {
+            inversions += state->corners[piece] / 3 > state->corners[other] / 3;
+            inversions += state->edges[piece] / 2 > state->edges[other] / 2;
+        }
+    }
+    return inversions % 2 == 0;
+}
+
+/**
+ * Returns the rank of a permutation of 4 places, in lexicographic order
+ */
+static int permutationRank(const int * places) {
+    const int factorials[4] = {6, 2, 1, 1};
+    int rank = 0;
+    for (int index = 0 ; index < 4 ; index++) {
+        int smaller = 0;
+        for (int next = index + 1 ; next < 4 ; next++) {
+            smaller += places[next] < places[index];
+        }
+        rank += smaller * factorials[index];
+    }
+    return rank;
+}
+
+int lastLayerIndex(const lastLayerState * state) {
+    int cornerPlaces[4], edgePlaces[4];
+    int twists = 0, flips = 0;
+    for (int piece = 0 ; piece < 4 ; piece++) {
+        cornerPlaces[piece] = state->corners[piece] / 3;
+        edgePlaces[piece] = state->edges[piece] / 2;
+        if (piece < 3) {
+            twists = twists * 3 + state->corners[piece] % 3;
+            flips = flips * 2 + state->edges[piece] % 2;
+        }
+    }
+
+    // The ranks 2k and 2k + 1 only differ by a swap of the last two places, so
+    // the parity of the corners tells which one the edges are
+    int permutation = permutationRank(cornerPlaces) * 12
+        + permutationRank(edgePlaces) / 2;
+    return (permutation * 27 + twists) * 8 + flips;
+}
+
+bool lastLayerMoves(const move * moves,
+        unsigned char corners[LAST_LAYER_CORNERS],
+        unsigned char edges[LAST_LAYER_EDGES]) {
+    lastLayerData * data = getLastLayerData();
+    int count = 0;
+    while ((int) moves[count] != -1) count++;
+    tile destinations[54];
+    labelledMoves(moves, count, destinations);
+
+    int kept = 0;
+    for (int label = 0 ; label < 54 ; label++) {
+        tile facelet = {label / 9, label / 3 % 3, label % 3};
+        int corner = faceletIndex(data->corners, LAST_LAYER_CORNERS, facelet);
+        int edge = faceletIndex(data->edges, LAST_LAYER_EDGES, facelet);
+        if (corner != -1) {
+            int reached = faceletIndex(data->corners, LAST_LAYER_CORNERS,
+                    destinations[label]);
+            if (reached == -1) return false;
+            corners[corner] = reached;
+        } else if (edge != -1) {
+            int reached = faceletIndex(data->edges, LAST_LAYER_EDGES,
+                    destinations[label]);
+            if (reached == -1) return false;
+            edges[edge] = reached;
+        } else if (faceletLabel(destinations[label]) == label) {
+            kept++;
+        }
+    }
+    return kept == 54 - LAST_LAYER_CORNERS - LAST_LAYER_EDGES;
+}
+
+/**
+ * Keeps the default table from being loaded
+ */
+static void skipDefaultTable() {
+}
+
+bool loadLastLayerTable(const char * path) {
+    if (!path) {
+        pthread_once(&defaultTable, skipDefaultTable);
+        return !atomic_load(&sharedTable);
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat fileStat;
+    size_t indexSize = LAST_LAYER_HEADER_SIZE + 4 * (LAST_LAYER_STATES + 1);
+    if (fstat(fd, &fileStat) == -1 || (size_t) fileStat.st_size < indexSize) {
+        close(fd);
+        return false;
+    }
+
+    void * data = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid once the file is closed
+    if (data == MAP_FAILED) return false;
+
+    const unsigned char * bytes = data;
+    unsigned long moveCount = readOffset(bytes, LAST_LAYER_STATES);
+    if (memcmp(bytes, lastLayerMagic, sizeof(lastLayerMagic)) != 0
+            || bytes[4] != LAST_LAYER_VERSION
+            || indexSize + PACKED_MOVES_BYTES(moveCount)
+            > (size_t) fileStat.st_size) {
+        munmap(data, fileStat.st_size);
+        return false;
+    } // Not a table, or a truncated one
+
+    lastLayerTable * table =
+        (lastLayerTable *) ec_malloc(sizeof(lastLayerTable));
+    table->data = bytes;
+    table->size = fileStat.st_size;
+    table->moves = bytes + indexSize;
+    table->moveCount = moveCount;
+
+    lastLayerTable * loaded = NULL;
+    if (!atomic_compare_exchange_strong(&sharedTable, &loaded, table)) {
+        munmap(data, fileStat.st_size);
+        free(table);
+    } // A table is already loaded
+    return true;
+}
+
+/**
+ * Loads the default table if no table was loaded : LAST_LAYER_PATH next to the
+ * executable, else in the working directory
+ */
+static void loadDefaultTable() {
+    if (atomic_load(&sharedTable)) return;
+
+    char path[PATH_MAX];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length > 0) {
+        path[length] = '\0';
+        char * directory = strrchr(path, '/');
+        if (directory && directory + 1 + sizeof(LAST_LAYER_PATH)
+                <= path + sizeof(path)) {
+            strcpy(directory + 1, LAST_LAYER_PATH);
+            if (loadLastLayerTable(path)) return;
+        }
+    }
+    loadLastLayerTable(LAST_LAYER_PATH);
+}
+
+char * solveLastLayer(cube * self) {
+    char * movements = (char *) ec_malloc(sizeof(char) * STEP_MOVES_LENGTH);
+    *movements = '\0';
+    catPositionCommand(movements, self, 'g', 'y');
+    positionCube(self, 'g', 'y');
+
+    pthread_once(&defaultTable, loadDefaultTable);
+    lastLayerTable * table = atomic_load(&sharedTable);
+    lastLayerState state;
+    if (table && readLastLayer(self, &state)) {
+        int index = lastLayerIndex(&state);
+        unsigned long first = readOffset(table->data, index);
+        unsigned long last = readOffset(table->data, index + 1);
+        if (first <= last && last <= table->moveCount) {
+            for (unsigned long rank = first ; rank < last ; rank++) {
+                move played = readPackedMove(table->moves, rank);
+                self->rotate(self, played);
+                catMoves(movements, mapMoveToCode(played));
+                catMoves(movements, " ");
+            }
+            return movements;
+        }
+    } // Else the file is corrupted or the first two layers are not done
+
+    char * (*steps[4])(cube *) = {
+        doYellowCross, orientYellowCorners,
+        placeEdgesLastLayer, orientCornersLastLayer
+    };
+    char * volatile stepMoves[4] = {NULL, NULL, NULL, NULL};
+    char * volatile held = movements;   // Not freed yet by catMoves()
+    jmp_buf recovery;
+    jmp_buf * previous = recoverStuckSteps(NULL);
+    if (previous) {
+        if (setjmp(recovery)) {
+            free(held);
+            for (int step = 0 ; step < 4 ; step++) free(stepMoves[step]);
+            recoverStuckSteps(previous);
+            longjmp(*previous, 1);
+        } // The stuck step freed its moves, the other moves are freed here
+        recoverStuckSteps(&recovery);
+    }
+
+    for (int step = 0 ; step < 4 ; step++) {
+        stepMoves[step] = steps[step](self);
+    }
+    held = NULL; // From now on, catMoves() frees movements if it jumps back
+    for (int step = 0 ; step < 4 ; step++) {
+        catMoves(movements, stepMoves[step]);
+        free(stepMoves[step]);
+        stepMoves[step] = NULL;
+    }
+    recoverStuckSteps(previous);
+    return movements;
+}
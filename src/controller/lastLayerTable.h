@@ -0,0 +1,120 @@
+/**
+ * @file lastLayerTable.h
+ * Last layer solved at once from a table of algorithms
+ *
+ * Once the first two layers are done, the last layer has 62208 states : the
+ * 4! places of its corners times the 4! / 2 places of its edges of the same
+ * parity, the 3^3 twists of 3 corners (the 4th one follows) and the 2^3 flips
+ * of 3 edges. The turns of the up face are part of the state, so an algorithm
+ * of the table ends with the last layer solved.
+ *
+ * The table is computed offline by tools/gen1lll.c and mapped from a file :
+ * the magic "RBKL", the format version, then LAST_LAYER_STATES + 1 offsets on
+ * 4 bytes (little-endian) and the moves of all the algorithms packed on 6 bits
+ * (see packedMoves.h). The algorithm of the state i is made of the moves
+ * [offset i, offset i + 1[. The moves are played on the cube with green on
+ * front and yellow up.
+ *
+ * The state of a cube is read from where the yellow facelet of each corner and
+ * of each edge of the last layer is, among the 12 facelets of the corners and
+ * the 8 facelets of the edges of the up layer. The 3 facelets of every corner
+ * are listed turning the same way, so the place of its yellow facelet is its
+ * twist.
+ */
+
+#ifndef LAST_LAYER_TABLE_H
+#define LAST_LAYER_TABLE_H
+
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../model/cube.h"
+#include "../model/cubelet.h"
+#include "oll.h"
+#include "packedMoves.h"
+#include "patternComparator.h"
+#include "pll.h"
+#include "solverTables.h"
+#include "utils.h"
+
+#define LAST_LAYER_VERSION 1
+#define LAST_LAYER_STATES 62208         /**< 24 * 12 * 27 * 8 */
+#define LAST_LAYER_CORNERS 12           /**< Facelets of the corners */
+#define LAST_LAYER_EDGES 8              /**< Facelets of the edges */
+#define LAST_LAYER_HEADER_SIZE 5        /**< Magic and version */
+#define LAST_LAYER_PATH "lastlayer.tbl" /**< Default table, by the executable */
+
+/**
+ * The places of the yellow facelets of the last layer
+ *
+ * The place of a corner facelet is 3 times the corner of the up layer plus the
+ * rank of the facelet in the corner, from its up facelet. The place of an edge
+ * facelet is 2 times the edge plus 1 for its side facelet.
+ */
+typedef struct _lastLayerState {
+    unsigned char corners[4];   /**< Yellow facelet of each corner */
+    unsigned char edges[4];     /**< Yellow facelet of each edge */
+} lastLayerState;
+
+/**
+ * Reads the state of the last layer of a cube with green on front and yellow
+ * up, whose first two layers are done
+ *
+ * @param self the cube, which is not modified
+ * @param state set with the places of the pieces
+ * @returns false if the up layer does not hold a valid last layer
+ */
+bool readLastLayer(cube * self, lastLayerState * state);
+
+/**
+ * Returns the index of a state, from 0 to LAST_LAYER_STATES - 1
+ */
+int lastLayerIndex(const lastLayerState * state);
+
+/**
+ * Computes where moves bring the facelets of the last layer
+ *
+ * @param moves the moves, terminated by -1
+ * @param corners set with the place reached from each corner facelet
+ * @param edges set with the place reached from each edge facelet
+ * @returns false if the moves do not keep the first two layers
+ */
+bool lastLayerMoves(const move * moves,
+        unsigned char corners[LAST_LAYER_CORNERS],
+        unsigned char edges[LAST_LAYER_EDGES]);
+
+/**
+ * Maps a table generated by tools/gen1lll.c
+ *
+ * The first table loaded is kept, and shared by the threads and the processes
+ * forked afterwards. Without a call, solveLastLayer() loads LAST_LAYER_PATH
+ * from the directory of the executable, or else from the working directory.
+ *
+ * @param path the file of the table, NULL to keep the default table from being
+ *  loaded, so the last layer is solved in 4 steps
+ * @returns false if the file is missing or is not a valid table, or if a table
+ *  is already loaded when path is NULL
+ */
+bool loadLastLayerTable(const char * path);
+
+/**
+ * Solves the last layer once the first two layers are done, last step of
+ * trueSolve()
+ *
+ * The cube is first turned with green on front and yellow up. Without a table,
+ * the last layer is solved in 4 steps with doYellowCross(),
+ * orientYellowCorners(), placeEdgesLastLayer() and orientCornersLastLayer().
+ *
+ * @param self the cube, on which the moves are played
+ * @returns the space separated moves, to be freed
+ */
+char * solveLastLayer(cube * self);
+
+#endif
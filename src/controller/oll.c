@@ -37,6 +37,7 @@ bool yellowFaceDone(cube *self){
         }
     }
     bool test = patternMatches(self,clone);
+    destroyCube(clone);
     return test;
 }
 
@@ -49,12 +50,12 @@ void crossAlgorithm(cube *self, char *movements, int nb){
         self->rotate(self,Ri);
         self->rotate(self,Ui);
         self->rotate(self,Fi);
-        strcat(movements, "F R U Ri Ui Fi ");
+        catMoves(movements, "F R U Ri Ui Fi ");
     }
 }
 
 char * doYellowCross(cube *self){
-    char *movements = ec_malloc(sizeof(char)*1000);
+    char *movements = ec_malloc(sizeof(char)*STEP_MOVES_LENGTH);
     *movements = '\0';
 
     bool crossDone = yellowCrossDone(self);
@@ -92,7 +93,7 @@ void rightOLL(cube *self, char *movements, int nb){
         self->rotate(self, R);
         self->rotate(self, Ui);
         self->rotate(self, Ri);
-        strcat(movements, "R U2 Ri Ui R Ui Ri ");
+        catMoves(movements, "R U2 Ri Ui R Ui Ri ");
     }
 }
 
@@ -106,13 +107,13 @@ void leftOLL(cube *self, char *movements, int nb){
         self->rotate(self, Li);
         self->rotate(self, U);
         self->rotate(self, L);
-        strcat(movements, "Li Ui Ui L U Li U L ");
+        catMoves(movements, "Li Ui Ui L U Li U L ");
     }
 }
 
 
 char * orientYellowCorners(cube *self){
-    char *movements = ec_malloc(sizeof(char)*1001);
+    char *movements = ec_malloc(sizeof(char)*STEP_MOVES_LENGTH);
 	*movements = '\0';
     while(!yellowFaceDone(self)){
         if(self->cube[F][0][0] == 'y' \
@@ -166,27 +167,26 @@ char * orientYellowCorners(cube *self){
         {
             rightOLL(self,movements,1);
             self->rotate(self,U);
+            catMoves(movements, "U ");
             rightOLL(self,movements,1);
         }
         else
         {
             self->rotate(self,U);
-            strcat(movements,"U ");
+            catMoves(movements, "U ");
         }
     }
-    printCube(self);
     return movements;
 }
 
 
 
 int findYellowPattern(cube *self, char * movements){
-strcat(movements,positionCommand(self, 'g', 'y'));
+catPositionCommand(movements, self, 'g', 'y');
     positionCube(self,'g','y');
     bool foundPattern = false;
     int pattern = 1;
     int rotation = 0;
-    debug("findYellowPattern() start");
     // printCube(self);
     while(!foundPattern && rotation <= 3) {
         if(
@@ -194,23 +194,20 @@ strcat(movements,positionCommand(self, 'g', 'y'));
             && self->cube[U][1][1] == 'y'
             && self->cube[U][1][0] == 'y'
         ) {
-            debug("findYellowPattern() return 2");
             return 2;
         } else if (
                     self->cube[U][1][1] == 'y'
                     && self->cube[U][1][0] == 'y'
                     && self->cube[U][1][2] == 'y'
                 ){
-            debug("findYellowPattern() return 3");
             return 3;
         }
         self->rotate(self, U);
-        strcat(movements,"U ");
+        catMoves(movements, "U ");
         rotation++;
     }
     if(!foundPattern){
         return 1;
     }
-    debug("findYellowPattern(), return 1");
     return pattern;
 }
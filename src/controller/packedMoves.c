@@ -0,0 +1,38 @@
+/**
+ * @file packedMoves.c
+ */
+
+#include "packedMoves.h"
+
+void packMoveBuffer(unsigned char * data, const move * moves, int nb) {
+    int index = 0;
+    for ( ; index + 4 <= nb ; index += 4) {
+        unsigned int group = (moves[index] & PACKED_MOVE_MASK)
+            | (moves[index + 1] & PACKED_MOVE_MASK) << 6
+            | (moves[index + 2] & PACKED_MOVE_MASK) << 12
+            | (moves[index + 3] & PACKED_MOVE_MASK) << 18;
+        *data++ = group;
+        *data++ = group >> 8;
+        *data++ = group >> 16;
+    } // 4 moves fill exactly 3 bytes
+
+    for ( ; index < nb ; index++) {
+        writePackedMove(data, index & 3, moves[index]);
+    } // Remaining moves of the last incomplete group
+}
+
+void unpackMoveBuffer(move * moves, const unsigned char * data, int nb) {
+    int index = 0;
+    for ( ; index + 4 <= nb ; index += 4) {
+        unsigned int group = data[0] | data[1] << 8 | data[2] << 16;
+        data += 3;
+        moves[index] = (move) (group & PACKED_MOVE_MASK);
+        moves[index + 1] = (move) ((group >> 6) & PACKED_MOVE_MASK);
+        moves[index + 2] = (move) ((group >> 12) & PACKED_MOVE_MASK);
+        moves[index + 3] = (move) ((group >> 18) & PACKED_MOVE_MASK);
+    }
+
+    for ( ; index < nb ; index++) {
+        moves[index] = readPackedMove(data, index & 3);
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ * @file packedMoves.h
+ * Compact storage of sequences of moves
+ *
+ * Every code of the move enum (the 60 moves and the RETURN, RESTART and
+ * SOLVE_PLS commands) fits in 6 bits, so a packed array stores 4 moves in 3
+ * bytes instead of 4 moves in 16 bytes for an array of move. The length of the
+ * sequence is kept by the caller beside the data, there is no -1 endmark.
+ *
+ * Move i is stored on the bits [6i, 6i+6[ of the data, least significant bits
+ * first.
+ */
+
+#ifndef PACKED_MOVES_H
+#define PACKED_MOVES_H
+
+#include <string.h>
+#include "../model/cube.h"
+#include "utils.h"
+
+#define PACKED_MOVE_BITS 6
+#define PACKED_MOVE_MASK 0x3F
+
+/**
+ * Returns the number of bytes needed to pack nb moves
+ */
+#define PACKED_MOVES_BYTES(nb) (((nb) * PACKED_MOVE_BITS + 7) / 8)
+
+/**
+ * Packs nb moves to data
+ *
+ * Bulk encoding working 4 moves (3 bytes) at a time. data must hold at least
+ * PACKED_MOVES_BYTES(nb) bytes.
+ */
+void packMoveBuffer(unsigned char * data, const move * moves, int nb);
+
+/**
+ * Unpacks nb moves from data
+ *
+ * Bulk decoding working 4 moves (3 bytes) at a time.
+ */
+void unpackMoveBuffer(move * moves, const unsigned char * data, int nb);
+
+/**
+ * Returns the move at a given index of packed data
+ */
+static inline move readPackedMove(const unsigned char * data, int index) {
+    int bit = index * PACKED_MOVE_BITS;
+    int value = data[bit >> 3] >> (bit & 7);
+    if ((bit & 7) > 8 - PACKED_MOVE_BITS) {
+        value |= data[(bit >> 3) + 1] << (8 - (bit & 7));
+    } // The move overlaps two bytes
+    return (move) (value & PACKED_MOVE_MASK);
+}
+
+/**
+ * Writes the move at a given index of packed data
+ */
+static inline void writePackedMove(unsigned char * data, int index, move cmd) {
+    int bit = index * PACKED_MOVE_BITS;
+    int shift = bit & 7;
+    unsigned char * byte = data + (bit >> 3);
+    byte[0] = (byte[0] & ~(PACKED_MOVE_MASK << shift))
+        | ((cmd & PACKED_MOVE_MASK) << shift);
+    if (shift > 8 - PACKED_MOVE_BITS) {
+        byte[1] = (byte[1] & ~(PACKED_MOVE_MASK >> (8 - shift)))
+            | ((cmd & PACKED_MOVE_MASK) >> (8 - shift));
+    }
+}
+
+#endif
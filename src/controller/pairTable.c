@@ -0,0 +1,237 @@
+/**
+ * @file pairTable.c
+ */
+
+#include "pairTable.h"
+
+/**
+ * Moves of a turn of the up face or of a trigger of a slot
+ */
+typedef struct _pairMacro {
+    move moves[3];      // The moves, as many as size
+    int size;           // Number of moves
+    int slot;           // The slot moved, -1 for a turn of the up face
+} pairMacro;
+
+/**
+ * The facelets, the macros and the moves of every state, built once
+ */
+typedef struct _pairData {
+    tile corners[PAIR_FACELETS];    // The facelets of the corners
+    tile edges[PAIR_FACELETS];      // The facelets of the edges
+    pairMacro macros[PAIR_MACROS];
+    // The facelet where each macro brings each facelet
+    unsigned char cornerMoves[PAIR_MACROS][PAIR_FACELETS];
+    unsigned char edgeMoves[PAIR_MACROS][PAIR_FACELETS];
+    char colours[PAIR_SLOTS][2];    // The colours of the sides of each slot
+    int solvedStates[PAIR_SLOTS];   // The state of each solved pair
+    // Moves of each state, for each slot and each set of slots allowed
+    unsigned char distances[PAIR_SLOTS][1 << PAIR_SLOTS][PAIR_STATES];
+} pairData;
+
+static void * _Atomic sharedData = NULL;
+
+/**
+ * Returns the state of the pair of a slot, on a cube with yellow up
+ */
+static int readState(pairData * data, cube * aCube, int slot) {
+    int corner, edge;
+    readPair(aCube, data->corners, data->edges, data->colours[slot], &corner,
+            &edge);
+    return corner * PAIR_FACELETS + edge;
+}
+
+/**
+ * Returns the state reached by a macro
+ */
+static int applyMacro(pairData * data, int state, int macro) {
+    return data->cornerMoves[macro][state / PAIR_FACELETS] * PAIR_FACELETS
+        + data->edgeMoves[macro][state % PAIR_FACELETS];
+}
+
+/**
+ * Sets the up turns and the 6 triggers of each slot : with A the left side of
+ * the slot and B its right side, B U Bi, B Ui Bi, B U2 Bi, Ai U A, Ai Ui A and
+ * Ai U2 A
+ */
+static void setMacros(pairData * data) {
+    const move upTurns[3] = {U, Ui, U2};
+    int macro = 0;
+    for (int turn = 0 ; turn < 3 ; turn++) {
+        data->macros[macro].moves[0] = upTurns[turn];
+        data->macros[macro].size = 1;
+        data->macros[macro++].slot = -1;
+    }
+    for (int slot = 0 ; slot < PAIR_SLOTS ; slot++) {
+        move left = sideFaces[slot];
+        move right = sideFaces[slot + 1];
+        for (int turn = 0 ; turn < 3 ; turn++) {
+            pairMacro * rightTrigger = &data->macros[macro++];
+            rightTrigger->moves[0] = right;
+            rightTrigger->moves[1] = upTurns[turn];
+            rightTrigger->moves[2] = inverseMove(right);
+            pairMacro * leftTrigger = &data->macros[macro++];
+            leftTrigger->moves[0] = inverseMove(left);
+            leftTrigger->moves[1] = upTurns[turn];
+            leftTrigger->moves[2] = left;
+            rightTrigger->size = leftTrigger->size = 3;
+            rightTrigger->slot = leftTrigger->slot = slot;
+        }
+    }
+}
+
+/**
+ * Searches the moves of every state of the pair of a slot, with the triggers
+ * of the slots of a set only, from the solved pair
+ */
+static void searchDistances(pairData * data, int slot, int allowed) {
+    unsigned char * distances = data->distances[slot][allowed];
+    memset(distances, PAIR_UNKNOWN, PAIR_STATES);
+    distances[data->solvedStates[slot]] = 0;
+
+    // The macros cost 1 or 3 moves, so the states are expanded by number of
+    // moves rather than in the order they are found
+    int farthest = 0;
+    for (int moves = 0 ; moves <= farthest ; moves++) {
+        for (int state = 0 ; state < PAIR_STATES ; state++) {
+            if (distances[state] != moves) continue;
+            for (int macro = 0 ; macro < PAIR_MACROS ; macro++) {
+                pairMacro * current = &data->macros[macro];
+                if (current->slot != -1 && !(allowed & 1 << current->slot)) {
+                    continue;
+                }
+                int next = applyMacro(data, state, macro);
+                if (moves + current->size < distances[next]) {
+                    distances[next] = moves + current->size;
+                    if (distances[next] > farthest) farthest = distances[next];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Builds the moves of the facelets and of the states of the pairs
+ */
+static void * buildPairData() {
+    pairData * data = (pairData *) ec_malloc(sizeof(pairData));
+    listFacelets(data->corners, data->edges);
+    setMacros(data);
+    for (int macro = 0 ; macro < PAIR_MACROS ; macro++) {
+        pairMacro * current = &data->macros[macro];
+        faceletMoves(data->corners, PAIR_FACELETS, current->moves,
+                current->size, data->cornerMoves[macro]);
+        faceletMoves(data->edges, PAIR_FACELETS, current->moves,
+                current->size, data->edgeMoves[macro]);
+    }
+
+    cube * solved = positionCube(initCube(), 'g', 'y');
+    slotColours(solved, data->colours);
+    for (int slot = 0 ; slot < PAIR_SLOTS ; slot++) {
+        data->solvedStates[slot] = readState(data, solved, slot);
+    }
+    destroyCube(solved);
+
+    for (int slot = 0 ; slot < PAIR_SLOTS ; slot++) {
+        for (int allowed = 0 ; allowed < 1 << PAIR_SLOTS ; allowed++) {
+            if (allowed & 1 << slot) searchDistances(data, slot, allowed);
+        }
+    }
+    return data;
+}
+
+/**
+ * Returns the tables, built by the first call
+ */
+static pairData * getPairData() {
+    return (pairData *) lazyTable(&sharedData, buildPairData);
+}
+
+/**
+ * Solves the pairs in an order, on a cube with yellow up
+ *
+ * @param work the cube, on which the moves are played
+ * @param order the 4 slots, in the order to solve them
+ * @param moves set with the moves played, terminated by -1, of
+ *  PAIR_SLOTS * PAIR_MAX_MOVES + 1 moves
+ * @returns the number of moves, -1 if a pair is out of reach
+ */
+static int playOrder(pairData * data, cube * work, const int * order,
+        move * moves) {
+    int size = 0;
+    for (int index = 0 ; index < PAIR_SLOTS ; index++) {
+        int states[PAIR_SLOTS];
+        int allowed = 0;
+        for (int slot = 0 ; slot < PAIR_SLOTS ; slot++) {
+            states[slot] = readState(data, work, slot);
+            if (states[slot] != data->solvedStates[slot]) allowed |= 1 << slot;
+        } // The slots not solved may be moved
+
+        int slot = order[index];
+        if (!(allowed & 1 << slot)) continue;
+        unsigned char * distances = data->distances[slot][allowed];
+        int state = states[slot];
+        if (distances[state] == PAIR_UNKNOWN) return -1;
+
+        while (distances[state] > 0) {
+            int macro = 0;
+            int next = state;
+            for ( ; macro < PAIR_MACROS ; macro++) {
+                pairMacro * current = &data->macros[macro];
+                if (current->slot != -1 && !(allowed & 1 << current->slot)) {
+                    continue;
+                }
+                next = applyMacro(data, state, macro);
+                if (distances[next] + current->size == distances[state]) break;
+            } // A macro bringing the pair closer
+
+            for (int step = 0 ; step < data->macros[macro].size ; step++) {
+                moves[size] = data->macros[macro].moves[step];
+                work->rotate(work, moves[size++]);
+            }
+            state = next;
+        }
+    }
+    moves[size] = -1;
+    return size;
+}
+
+char * solvePairs(cube * self) {
+    pairData * data = getPairData();
+    char * movements = (char *) ec_malloc(sizeof(char) * STEP_MOVES_LENGTH);
+    *movements = '\0';
+    catPositionCommand(movements, self, 'g', 'y');
+    positionCube(self, 'g', 'y');
+
+    move best[PAIR_SLOTS * PAIR_MAX_MOVES + 1];
+    move moves[PAIR_SLOTS * PAIR_MAX_MOVES + 1];
+    int bestSize = -1;
+    for (int code = 0 ; code < 1 << 2 * PAIR_SLOTS ; code++) {
+        int order[PAIR_SLOTS];
+        int used = 0;
+        for (int index = 0 ; index < PAIR_SLOTS ; index++) {
+            order[index] = code >> 2 * index & 3;
+            used |= 1 << order[index];
+        }
+        if (used != (1 << PAIR_SLOTS) - 1) continue;
+        // The 24 orders of the slots, as 4 digits in base 4
+
+        cube * work = self->copy(self);
+        int size = playOrder(data, work, order, moves);
+        destroyCube(work);
+        if (size >= 0 && (bestSize < 0 || size < bestSize)) {
+            memcpy(best, moves, sizeof(move) * (size + 1));
+            bestSize = size;
+        }
+    }
+    if (bestSize < 0) {
+        exitFatal("in solvePairs(), a pair is out of reach, the cross is not done");
+    }
+
+    for (int index = 0 ; index < bestSize ; index++) {
+        self->rotate(self, best[index]);
+        catMoves(movements, mapMoveToCode(best[index]));
+        catMoves(movements, " ");
+    }
+    return movements;
+}
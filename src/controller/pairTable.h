@@ -0,0 +1,52 @@
+/**
+ * @file pairTable.h
+ * First two layers solved pair by pair from a table of insertions
+ *
+ * Once the white cross is done, each slot between two side faces is solved
+ * with its pair : the white corner and the edge of the two colours of the
+ * slot. The state of a pair is where the white facelet of its corner is among
+ * the 24 facelets of the corners, and where the facelet of the first colour of
+ * its edge is among the 24 facelets of the edges, which makes 576 states.
+ *
+ * The pairs are moved by the turns of the up face and by the triggers of the
+ * slots, such as R U Ri for the front right slot, which only move the up layer
+ * and their slot. The cross and the slots left alone are thus kept. For each
+ * slot and each set of slots which may be moved, a search from the solved pair
+ * gives the moves of every state, and the pair is solved by playing the
+ * macros bringing it closer. The 24 orders of the slots are tried, and the
+ * order with the fewest moves is kept.
+ *
+ * The tables are built at the first call and shared by the threads.
+ */
+
+#ifndef PAIR_TABLE_H
+#define PAIR_TABLE_H
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../model/cube.h"
+#include "../model/cubelet.h"
+#include "patternComparator.h"
+#include "solverTables.h"
+#include "utils.h"
+
+#define PAIR_SLOTS TABLE_SLOTS   /**< Slots of the first two layers */
+#define PAIR_FACELETS 24        /**< Facelets of the corners, or of the edges */
+#define PAIR_STATES 576         /**< States of a pair, 24 * 24 */
+#define PAIR_MACROS 27          /**< Up turns and triggers of the slots */
+#define PAIR_MAX_MOVES 64       /**< Moves bounding the insertion of a pair */
+#define PAIR_UNKNOWN 0xFF       /**< Moves of a state out of reach */
+
+/**
+ * Solves the 4 pairs of the first two layers, once the white cross is done
+ *
+ * The cube is first turned with green on front and yellow up. Exits if a
+ * pair cannot be reached, which only happens when the cross is not done.
+ *
+ * @param self the cube, on which the moves are played
+ * @returns the space separated moves, to be freed
+ */
+char * solvePairs(cube * self);
+
+#endif
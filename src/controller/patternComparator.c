@@ -28,8 +28,8 @@ _Bool patternMatches(cube * aCube, cube * refPattern) {
     _Bool comparison = currentCube->equals(currentCube, pattern);
 
     // free copies
-    free(currentCube);
-    free(pattern);
+    destroyCube(currentCube);
+    destroyCube(pattern);
     return comparison;
 }
 
@@ -53,7 +53,7 @@ char * positionCommand(cube * aCube, char frontFace, char upFace) {
     if (frontPos != F) {
         firstMove = !firstMove;
         commandSize = 4;
-        command = (char *) malloc(sizeof(char)*commandSize);
+        command = (char *) ec_malloc(sizeof(char)*commandSize);
         switch(frontPos) {
             case(R):
                 strncpy(command, "y ", 3);
@@ -77,7 +77,8 @@ char * positionCommand(cube * aCube, char frontFace, char upFace) {
                 break;
         }
     } else {
-        command = (char *) malloc(sizeof(char));
+        commandSize = 1;
+        command = (char *) ec_malloc(sizeof(char));
         *command = '\0';
     } // According to frontFace center position, choose command
 
@@ -89,7 +90,7 @@ char * positionCommand(cube * aCube, char frontFace, char upFace) {
     while(copy->cube[++upPos][1][1] != upFace);
     if (upPos != U) {
         commandSize += 4;
-        command = (char *) realloc(command, sizeof(char) * commandSize);
+        command = (char *) ec_realloc(command, sizeof(char) * commandSize);
         switch(upPos) {
             case(L):
                 strncat(command, "z ", 3);
@@ -106,15 +107,43 @@ char * positionCommand(cube * aCube, char frontFace, char upFace) {
         }
     }
     destroyCube(copy); // Freeing data copy
-    if(command == NULL){
-    command = "";
-    }
     return command;
 }
 
+/**
+ * The recovery point of the solver of each thread, NULL to exit
+ */
+static _Thread_local jmp_buf * stuckRecovery = NULL;
+
+jmp_buf * recoverStuckSteps(jmp_buf * recovery) {
+    jmp_buf * previous = stuckRecovery;
+    stuckRecovery = recovery;
+    return previous;
+}
+
+char * catMoves(char * movements, const char * moves) {
+    if (strlen(movements) + strlen(moves) >= STEP_MOVES_LENGTH) {
+        if (!stuckRecovery) {
+            exitFatal("in catMoves(), too many moves, the solver is stuck");
+        }
+        free(movements);
+        longjmp(*stuckRecovery, 1);
+    } // Bounding the loops of the steps
+    return strcat(movements, moves);
+}
+
+char * catPositionCommand(char * movements, cube * aCube, char frontFace, char upFace) {
+    char command[8];
+    char * position = positionCommand(aCube, frontFace, upFace);
+    strcpy(command, position);
+    free(position); // Freed before catMoves() may leave the step
+    return catMoves(movements, command);
+}
+
 move * positionCmd(cube * aCube, char frontFace, char upFace) {
     char * cmd = positionCommand(aCube, frontFace, upFace);
     move * moves = commandParser(cmd);
+    free(cmd);
     return moves;
 }
 
@@ -125,14 +154,16 @@ cube * positionCube(cube * aCube, char frontFace, char upFace) {
     } // Recovering command to position cube
 
 
-    char * token = strtok(commands, " ");
+    char * savePtr = NULL;
+    char * token = strtok_r(commands, " ", &savePtr);
     int i = 0;
     move moves[2] = {-1, -1};
     while (i < 2 && token) {
         moves[i] = mapCodeToMove(token);
-        token = strtok(NULL, " ");
+        token = strtok_r(NULL, " ", &savePtr);
         i++;
     } // Command tokenization and parsing to enum move
+    free(commands);
 
     i = -1;
     while(++i < 2 && (int) moves[i] != -1) {
@@ -161,3 +192,31 @@ cube * redressCube(cube * aCube) {
     return aCube;
 }
 
+
+/**
+ * The patterns of patternCube(), set up from a solved cube by their moves
+ */
+static const struct {
+    const char * name;
+    const char * moves;
+} namedPatterns[] = {
+    {"checkerboard", "R2 L2 U2 D2 F2 B2"},
+    {"superflip", "U R2 F B R B2 R U2 L B2 R Ui Di R2 F Ri L B2 U2 F2"},
+    {"cubeincube", "F L F Ui R U F2 L2 Ui Li B Di Bi L2 U"},
+    {"sixspots", "U Di R Li F Bi U Di"},
+    {"crosses", "R2 Li D F2 Ri Di Ri L Ui D R D B2 Ri U D2"},
+    {"stripes", "F U F R L2 B Di R D2 L Di B R2 L F U F"},
+    {NULL, NULL}
+};
+
+cube * patternCube(const char * name) {
+    for (int index = 0 ; namedPatterns[index].name ; index++) {
+        if (!strcmp(name, namedPatterns[index].name)) {
+            move * moves = commandParser(namedPatterns[index].moves);
+            cube * pattern = executeBulkCommand(initCube(), moves);
+            free(moves);
+            return pattern;
+        }
+    }
+    return NULL;
+}
@@ -1,10 +1,14 @@
 #ifndef PATTERN_COMPARATOR_H
 #define PATTERN_COMPARATOR_H
 
+#include <setjmp.h>
 #include "../model/cube.h"
 #include "debugController.h"
 #include "commandParser.h"
 
+#define STEP_MOVES_LENGTH 4096  /**< Size of the moves of a step of the solver,
+                                the longest ones take about 1200 chars */
+
 /**
  * Compare a cube with a given pattern to see if there is a match
  *
@@ -29,6 +33,54 @@ _Bool patternMatches(cube * aCube, cube * refPattern);
  */
 char * positionCommand(cube * aCube, char frontFace, char upFace);
 
+/**
+ * Returns the moves to perform to reach a specific orientation
+ *
+ * @returns an array of max two moves terminated by -1, to be freed
+ * @see positionCommand()
+ */
+move * positionCmd(cube * aCube, char frontFace, char upFace);
+
+/**
+ * Sets where the solver of the calling thread goes back when a step is stuck
+ *
+ * When a step is stuck, its moves are freed and the thread jumps back to the
+ * recovery point with the value 1, instead of exiting. A step calling other
+ * steps sets its own recovery point to free its moves, then jumps back to the
+ * previous one.
+ *
+ * @param recovery the recovery point, NULL to exit when a step is stuck
+ * @returns the previous recovery point
+ */
+jmp_buf * recoverStuckSteps(jmp_buf * recovery);
+
+/**
+ * Appends moves to the moves of a step of the solver
+ *
+ * Exits if the moves do not fit in STEP_MOVES_LENGTH chars, which means the
+ * step is stuck in a loop, unless the thread has a recovery point (see
+ * recoverStuckSteps()).
+ *
+ * @param movements the moves of the step, allocated with STEP_MOVES_LENGTH
+ * @param moves the space separated moves to append
+ *
+ * @returns movements
+ */
+char * catMoves(char * movements, const char * moves);
+
+/**
+ * Appends the commands to reach a specific orientation to a string
+ *
+ * @param movements the moves of a step, allocated with STEP_MOVES_LENGTH
+ * @param aCube the cube to position
+ * @param frontFace the color of the face to be on front
+ * @param upFace the color of the face to be up
+ *
+ * @returns movements
+ * @see positionCommand()
+ */
+char * catPositionCommand(char * movements, cube * aCube, char frontFace, char upFace);
+
 /**
  * Positions the cube according to two reference faces
  *
@@ -48,4 +100,15 @@ cube * positionCube(cube * aCube, char frontFace, char upFace);
  * @params aCube pointer to the cube to redress
  */
 cube * redressCube(cube * aCube);
+
+/**
+ * Returns a cube showing a pattern, to be set up with solveBetween()
+ *
+ * The patterns are "checkerboard", "superflip", "cubeincube", "sixspots",
+ * "crosses" and "stripes", with green on front and white on top.
+ *
+ * @params name the name of the pattern
+ * @returns a new cube, or NULL if the pattern is unknown
+ */
+cube * patternCube(const char * name);
 #endif
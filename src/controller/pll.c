@@ -23,6 +23,8 @@ int isLastLayerEdgesPlaced(cube *self){
 	positionCube(pattern,'g','y');
 	positionCube(pattern,'g','y');
 	test = patternMatches(clone,pattern);
+	destroyCube(clone);
+	destroyCube(pattern);
 	if(test){
 		return 1;
 	}
@@ -51,14 +53,13 @@ bool isCorrectPosition(cube *self){
 	positionCube(clone,'g','y');
 	positionCube(pattern,'g','y');
 	bool test = false;
-	for(int i = 0; i <4; i++){
+	for(int i = 0; i <4 && !test; i++){
 		clone->rotate(clone,U);
 		test = patternMatches(clone,pattern);
-		if(test){
-			return true;
-		}
 	}
-	return false;
+	destroyCube(clone);
+	destroyCube(pattern);
+	return test;
 }
 
 
@@ -79,22 +80,21 @@ void *inverseEdges(cube *self, char *movements)
 	self->rotate(self,U);
 	self->rotate(self,Ri);
 	self->rotate(self,Fi);
-	strcat(movements, "R U Ri Ui Ri F R2 Ui Ri Ui R U Ri Fi ");
+	catMoves(movements, "R U Ri Ui Ri F R2 Ui Ri Ui R U Ri Fi ");
 	return NULL;
 }
 
 
 char *placeEdgesLastLayer(cube *self){
-	char *movements = ec_malloc(sizeof(char)*600);
+	char *movements = ec_malloc(sizeof(char)*STEP_MOVES_LENGTH);
 	*movements = '\0';
-	strcat(movements,positionCommand(self,'g','y'));
+	catPositionCommand(movements, self, 'g','y');
 	positionCube(self,'g','y');
 	if(!isLastLayerEdgesPlaced(self)){
 		while(self->cube[F][0][1] != 'g'){
 			self->rotate(self,U);
-			strcat(movements,"U ");
+			catMoves(movements, "U ");
 		}
-		printCube(self);
 	}
 	while(!isLastLayerEdgesPlaced(self)){
 		while(self->cube[F][0][1] != 'g' || self->cube[B][0][1] != 'b'){
@@ -110,13 +110,12 @@ char *placeEdgesLastLayer(cube *self){
 			self->rotate(self,U);
 			self->rotate(self,R);
 			self->rotate(self,R);
-			strcat(movements, "Ri U Ri Ui Ri Ui Ri U R U R R ");
+			catMoves(movements, "Ri U Ri Ui Ri Ui Ri U R U R R ");
 		}
 		if(self->cube[L][0][1] == 'o' && self->cube[R][0][1] == 'r'){
 			inverseEdges(self, movements);
 		}
 	}
-	printCube(self);
 	return movements;
 }
 
@@ -127,11 +126,13 @@ bool isLastLayerDone(cube *self){
 	positionCube(clone,'g','y');
 	positionCube(pattern,'g','y');
 	bool test = patternMatches(clone,pattern);
+	destroyCube(clone);
+	destroyCube(pattern);
 	return test;
 }
 
 char *orientCornersLastLayer(cube *self){
-	char *movements = ec_malloc(sizeof(char)*600);
+	char *movements = ec_malloc(sizeof(char)*STEP_MOVES_LENGTH);
 	*movements = '\0';
 	bool finished =false;
 	if(!isLastLayerDone(self)){
@@ -147,12 +148,12 @@ char *orientCornersLastLayer(cube *self){
 		self->rotate(self,Bi);
 		self->rotate(self,R);
 		self->rotate(self,R);
-		strcat(movements, "Ri F Ri Bi Bi R Fi Ri Bi Bi R R ");}
+		catMoves(movements, "Ri F Ri Bi Bi R Fi Ri Bi Bi R R ");}
 	while(!isLastLayerDone(self) || finished == false){
 		for(int i=0; i<4; i++){
 			if(finished == false){
 				self->rotate(self,U);
-				strcat(movements,"U ");
+				catMoves(movements, "U ");
 			}
 			if(((self->cube[F][0][0] == self->cube[F][0][1]) \
 						&& (self->cube[L][0][2] == self->cube[L][0][1])) && finished == false)
@@ -169,19 +170,17 @@ char *orientCornersLastLayer(cube *self){
 				self->rotate(self,Bi);
 				self->rotate(self,R);
 				self->rotate(self,R);
-				strcat(movements, "Ri F Ri Bi Bi R Fi Ri Bi Bi R R ");
+				catMoves(movements, "Ri F Ri Bi Bi R Fi Ri Bi Bi R R ");
 				for(int e=0; e<4; e++){
 					if(isLastLayerDone(self)){
 						finished = true;
 					}
 					if(finished ==false){
 						self->rotate(self,U);
-						strcat(movements,"U ");
+						catMoves(movements, "U ");
 					}
 				}
 			}
-			printf("%d\n",finished);
-			printCube(self);
 		}
 		if(finished ==false)
 		{	self->rotate(self,Ri);
@@ -196,7 +195,7 @@ char *orientCornersLastLayer(cube *self){
 			self->rotate(self,Bi);
 			self->rotate(self,R);
 			self->rotate(self,R);
-			strcat(movements, "Ri F Ri Bi Bi R Fi Ri Bi Bi R R ");}
+			catMoves(movements, "Ri F Ri Bi Bi R Fi Ri Bi Bi R R ");}
 
 	}
 	return movements;
@@ -0,0 +1,242 @@
+/**
+ * @file session.c
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "session.h"
+
+#define SESSION_HEADER_SIZE 10 // magic, version, tick and seed
+
+static const char sessionMagic[4] = {'R', 'B', 'K', 'S'};
+
+/**
+ * Returns the milliseconds elapsed since start on the monotonic clock
+ */
+static unsigned long elapsedMs(struct timespec start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start.tv_sec) * 1000
+        + (now.tv_nsec - start.tv_nsec) / 1000000;
+}
+
+/**
+ * Writes an unsigned integer of size bytes in little-endian order
+ */
+static void writeLittleEndian(FILE * file, unsigned long value, int size) {
+    for (int index = 0 ; index < size ; index++) {
+        fputc((value >> (8 * index)) & 0xFF, file);
+    }
+}
+
+/**
+ * Reads an unsigned integer of size bytes in little-endian order
+ */
+static unsigned long readLittleEndian(const unsigned char * data, int size) {
+    unsigned long value = 0;
+    for (int index = 0 ; index < size ; index++) {
+        value |= (unsigned long) data[index] << (8 * index);
+    }
+    return value;
+}
+
+/**
+ * Writes a scramble block : a count followed by the moves packed on 6 bits
+ */
+static void writeScrambleBlock(FILE * file, move * moves) {
+    int size = sizeOfMoveArray(moves) - 1;
+    unsigned char * packed = (unsigned char *) \
+        ec_malloc(PACKED_MOVES_BYTES(size) + 1);
+    packMoveBuffer(packed, moves, size);
+    writeLittleEndian(file, size, 2);
+    fwrite(packed, 1, PACKED_MOVES_BYTES(size), file);
+    free(packed);
+}
+
+/**
+ * Writes a record header : the code and the delta since the previous record
+ */
+static void writeRecord(sessionLog * self, int code) {
+    unsigned long tick = elapsedMs(self->start) / SESSION_TICK_MS;
+    unsigned long delta = tick - self->lastTick;
+    self->lastTick = tick;
+
+    // The 2 upper bits tell how many bytes are needed to store the delta
+    int sizeClass = delta == 0 ? 0 : delta <= 0xFF ? 1 : delta <= 0xFFFF ? 2 : 3;
+    int deltaSizes[4] = {0, 1, 2, 4};
+
+    fputc((sizeClass << 6) | code, self->file);
+    writeLittleEndian(self->file, delta, deltaSizes[sizeClass]);
+}
+
+sessionLog * openSessionLog(const char * path, unsigned int seed,
+        move * initSequence) {
+    sessionLog * self = (sessionLog *) ec_malloc(sizeof(sessionLog));
+    self->file = fopen(path, "wb");
+    if (!self->file) {
+        exitFatal("in openSessionLog(), could not create the session log");
+    }
+    clock_gettime(CLOCK_MONOTONIC, &self->start);
+    self->lastTick = 0;
+
+    fwrite(sessionMagic, 1, sizeof(sessionMagic), self->file);
+    fputc(SESSION_VERSION, self->file);
+    fputc(SESSION_TICK_MS, self->file);
+    writeLittleEndian(self->file, seed, 4);
+    writeScrambleBlock(self->file, initSequence);
+    fflush(self->file);
+    return self;
+}
+
+void recordMove(sessionLog * self, move cmd) {
+    if (!self) return;
+    writeRecord(self, cmd);
+    fflush(self->file); // A crash should not lose the end of the session
+}
+
+void recordScramble(sessionLog * self, move * initSequence) {
+    if (!self) return;
+    writeRecord(self, SESSION_SCRAMBLE_CODE);
+    writeScrambleBlock(self->file, initSequence);
+    fflush(self->file);
+}
+
+void closeSessionLog(sessionLog * self) {
+    if (!self) return;
+    fclose(self->file);
+    free(self);
+}
+
+sessionReplay * openSessionReplay(const char * path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return NULL;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || fileStat.st_size < SESSION_HEADER_SIZE) {
+        close(fd);
+        return NULL;
+    }
+
+    void * data = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid once the file is closed
+    if (data == MAP_FAILED) return NULL;
+
+    const unsigned char * bytes = data;
+    if (memcmp(bytes, sessionMagic, sizeof(sessionMagic)) != 0
+            || bytes[4] != SESSION_VERSION) {
+        munmap(data, fileStat.st_size);
+        return NULL;
+    } // Not a session log, or not one we know how to read
+
+    sessionReplay * self = (sessionReplay *) ec_malloc(sizeof(sessionReplay));
+    self->data = bytes;
+    self->size = fileStat.st_size;
+    self->tick = bytes[5];
+    self->seed = readLittleEndian(bytes + 6, 4);
+    self->offset = SESSION_HEADER_SIZE;
+    self->lastTick = 0;
+    self->headerRead = false;
+    clock_gettime(CLOCK_MONOTONIC, &self->start);
+    return self;
+}
+
+/**
+ * Decodes a scramble block at offset
+ * @returns the offset after the block, 0 if the block is truncated
+ */
+static size_t decodeScramble(sessionReplay * self, size_t offset,
+        sessionEvent * event) {
+    if (offset + 2 > self->size) return 0;
+    int size = readLittleEndian(self->data + offset, 2);
+    offset += 2;
+    if (offset + PACKED_MOVES_BYTES(size) > self->size) return 0;
+
+    event->type = SESSION_SCRAMBLE;
+    event->cmd = (move)-1;
+    event->scramble = self->data + offset;
+    event->scrambleSize = size;
+    return offset + PACKED_MOVES_BYTES(size);
+}
+
+/**
+ * Decodes the event at the current offset without consuming it
+ * @returns the offset of the next event, 0 at the end of the log
+ */
+static size_t decodeEvent(sessionReplay * self, sessionEvent * event,
+        unsigned long * tick) {
+    if (!self->headerRead) {
+        *tick = 0;
+        event->time = 0;
+        return decodeScramble(self, self->offset, event);
+    } // The init sequence is the first event
+
+    size_t offset = self->offset;
+    if (offset >= self->size) return 0;
+
+    int deltaSizes[4] = {0, 1, 2, 4};
+    unsigned char header = self->data[offset++];
+    int deltaSize = deltaSizes[header >> 6];
+    int code = header & 0x3F;
+
+    if (offset + deltaSize > self->size) return 0;
+    *tick = self->lastTick + readLittleEndian(self->data + offset, deltaSize);
+    offset += deltaSize;
+    event->time = *tick * self->tick;
+
+    if (code == SESSION_SCRAMBLE_CODE) {
+        return decodeScramble(self, offset, event);
+    }
+
+    event->type = SESSION_MOVE;
+    event->cmd = (move) code;
+    event->scramble = NULL;
+    event->scrambleSize = 0;
+    return offset;
+}
+
+bool readSessionEvent(sessionReplay * self, sessionEvent * event) {
+    unsigned long tick;
+    size_t next = decodeEvent(self, event, &tick);
+    if (!next) {
+        self->offset = self->size; // Truncated or finished log
+        return false;
+    }
+    self->offset = next;
+    self->lastTick = tick;
+    self->headerRead = true;
+    return true;
+}
+
+bool nextDueSessionEvent(sessionReplay * self, sessionEvent * event) {
+    unsigned long tick;
+    size_t next = decodeEvent(self, event, &tick);
+    if (!next) {
+        self->offset = self->size;
+        return false;
+    }
+    if (event->time > elapsedMs(self->start)) return false;
+
+    self->offset = next;
+    self->lastTick = tick;
+    self->headerRead = true;
+    return true;
+}
+
+bool sessionReplayFinished(sessionReplay * self) {
+    return self->headerRead && self->offset >= self->size;
+}
+
+move * sessionScramble(const sessionEvent * event) {
+    move * moves = (move *) ec_malloc(sizeof(move) * (event->scrambleSize + 1));
+    unpackMoveBuffer(moves, event->scramble, event->scrambleSize);
+    moves[event->scrambleSize] = (move)-1;
+    return moves;
+}
+
+void closeSessionReplay(sessionReplay * self) {
+    if (!self) return;
+    munmap((void *) self->data, self->size);
+    free(self);
+}
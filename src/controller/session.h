@@ -0,0 +1,177 @@
+/**
+ * @file session.h
+ * Binary recording and playback of game sessions
+ *
+ * A session log is an append-only file made of a header followed by a stream
+ * of records:
+ *
+ *  * Header : the magic "RBKS", the format version, the duration of a tick in
+ *    milliseconds, the seed of the game and the init sequence of the game as a
+ *    scramble block
+ *  * Move record : one byte holding the move code on its 6 lower bits and the
+ *    size of the time delta on its 2 upper bits, followed by 0, 1, 2 or 4
+ *    bytes of delta (in ticks) since the previous record
+ *  * Scramble record : a move record with the SESSION_SCRAMBLE_CODE code,
+ *    followed by a scramble block. It is written each time the game restarts
+ *
+ * The RETURN and SOLVE_PLS commands are recorded as they are received. A
+ * RETURN record is always followed by the move that cancelled the last one, so
+ * that the log can be applied to a cube by skipping the commands.
+ *
+ * A scramble block is a 2 bytes count followed by the moves packed on 6 bits
+ * (see packedMoves.h).
+ * All multi-byte integers are little-endian.
+ */
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "../model/cube.h"
+#include "commandQueue.h"
+#include "packedMoves.h"
+#include "utils.h"
+#include "errorController.h"
+
+#define SESSION_VERSION 2
+#define SESSION_TICK_MS 10      /**< Resolution of the recorded timings */
+#define SESSION_SCRAMBLE_CODE 63 /**< Move code announcing a scramble block */
+
+/**
+ * Type of the events read from a session log
+ */
+typedef enum {
+    SESSION_MOVE,       /**< A move applied to the cube */
+    SESSION_SCRAMBLE    /**< A new game, scrambled from a solved cube */
+} sessionEventType;
+
+/**
+ * An event read from a session log
+ */
+typedef struct _sessionEvent {
+    sessionEventType type;          /**< The type of the event */
+    move cmd;                       /**< The move for a SESSION_MOVE */
+    unsigned long time;             /**< Milliseconds since the session start */
+    const unsigned char * scramble; /**< Packed scramble moves */
+    int scrambleSize;               /**< Number of moves in the scramble */
+} sessionEvent;
+
+/**
+ * A session being recorded
+ */
+typedef struct _sessionLog {
+    FILE * file;            /**< The log file, opened for writing */
+    struct timespec start;  /**< Time of the session start */
+    unsigned long lastTick; /**< Tick of the last record written */
+} sessionLog;
+
+/**
+ * A session log mapped in memory for playback
+ */
+typedef struct _sessionReplay {
+    const unsigned char * data; /**< The mapped file */
+    size_t size;                /**< The size of the mapped file */
+    size_t offset;              /**< Offset of the next record to read */
+    unsigned int seed;          /**< The seed of the recorded game */
+    unsigned int tick;          /**< Duration of a tick in milliseconds */
+    unsigned long lastTick;     /**< Tick of the last record read */
+    bool headerRead;            /**< True once the init scramble is read */
+    struct timespec start;      /**< Time of the playback start */
+} sessionReplay;
+
+/**
+ * Creates a session log and writes its header
+ *
+ * @param path - Path of the file to create. An existing file is overwritten
+ * @param seed - The seed of the game
+ * @param initSequence - The init sequence of the game, terminated by -1
+ * @returns a pointer to the new session log
+ */
+sessionLog * openSessionLog(const char * path, unsigned int seed,
+        move * initSequence);
+
+/**
+ * Appends a move to the session log
+ *
+ * Does nothing if the log is NULL, so recording can be disabled by not opening
+ * a log.
+ *
+ * @param self - Pointer to the session log
+ * @param cmd - The move that has been applied to the cube
+ */
+void recordMove(sessionLog * self, move cmd);
+
+/**
+ * Appends a new game to the session log
+ *
+ * Does nothing if the log is NULL.
+ *
+ * @param self - Pointer to the session log
+ * @param initSequence - The scramble of the new game, terminated by -1
+ */
+void recordScramble(sessionLog * self, move * initSequence);
+
+/**
+ * Flushes and closes the session log
+ *
+ * @param self - Pointer to the session log, may be NULL
+ */
+void closeSessionLog(sessionLog * self);
+
+/**
+ * Maps a session log in memory for playback
+ *
+ * @param path - Path of the session log
+ * @returns a pointer to the replay, NULL if the file is not a valid log
+ */
+sessionReplay * openSessionReplay(const char * path);
+
+/**
+ * Reads the next event of the log, whatever its time
+ *
+ * The first event of a log is always the SESSION_SCRAMBLE of the init sequence.
+ * A truncated record at the end of the file is considered as the end of the
+ * log.
+ *
+ * @param self - Pointer to the replay
+ * @param event - Pointer to the event to fill
+ * @returns false when the end of the log is reached
+ */
+bool readSessionEvent(sessionReplay * self, sessionEvent * event);
+
+/**
+ * Reads the next event of the log if it is due
+ *
+ * The time of the events is compared to the time elapsed since the replay has
+ * been opened, so that the session is played back in real time.
+ *
+ * @param self - Pointer to the replay
+ * @param event - Pointer to the event to fill
+ * @returns true if an event was due and has been read
+ */
+bool nextDueSessionEvent(sessionReplay * self, sessionEvent * event);
+
+/**
+ * Returns true when every event of the log has been read
+ */
+bool sessionReplayFinished(sessionReplay * self);
+
+/**
+ * Converts the scramble of a SESSION_SCRAMBLE event to an array of moves
+ *
+ * @param event - Pointer to the scramble event
+ * @returns an array of moves terminated by -1. Must be freed when not needed.
+ */
+move * sessionScramble(const sessionEvent * event);
+
+/**
+ * Unmaps the session log and frees the replay
+ *
+ * @param self - Pointer to the replay, may be NULL
+ */
+void closeSessionReplay(sessionReplay * self);
+
+#endif
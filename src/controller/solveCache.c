@@ -0,0 +1,370 @@
+/**
+ * @file solveCache.c
+ */
+
+#include <stdint.h>
+#include "solveCache.h"
+
+#define SOLVE_CACHE_BUCKETS 256     // Initial number of buckets
+#define SOLVE_CACHE_MAX_MOVES 0xFFFF    // Moves of a solution in the file
+
+static const char solveCacheMagic[4] = {'R', 'B', 'K', 'C'};
+
+/**
+ * Colours of the centers of a redressed cube, in the order of the faces
+ */
+static const char redressedColours[] = "gbrowy";
+
+/**
+ * Returns the number of moves of an array terminated by -1
+ */
+static int countMoves(const move * moves) {
+    int size = 0;
+    while ((int) moves[size] != -1) size++;
+    return size;
+}
+
+/**
+ * Appends a move to a sequence, cancelling it with the last move if they are
+ * inverse
+ *
+ * @returns the new size of the sequence
+ */
+static int appendReduced(move * moves, int size, move cmd) {
+    if (size > 0 && moves[size - 1] == inverseMove(cmd)) {
+        return size - 1;
+    }
+    moves[size] = cmd;
+    return size + 1;
+}
+
+/**
+ * Computes the key of a cube and the rotations redressing it
+ *
+ * @param aCube the cube, which is not modified
+ * @param key the key, of SOLVE_CACHE_KEY_BYTES bytes
+ * @returns the rotations redressing the cube terminated by -1, to be freed, or
+ * NULL if the cube has unknown colours
+ */
+static move * cubeKey(cube * aCube, unsigned char * key) {
+    move * position = positionCmd(aCube, 'g', 'w');
+    move * rotations = expandCommand(position);
+    free(position);
+
+    cube * redressed = aCube->copy(aCube);
+    executeBulkCommand(redressed, rotations);
+
+    memset(key, 0, SOLVE_CACHE_KEY_BYTES);
+    int bit = 0;
+    for (int face = F ; face <= D ; face++) {
+        for (int index = 0 ; index < 3 ; index++) {
+            for (int jindex = 0 ; jindex < 3 ; jindex++) {
+                if (index == 1 && jindex == 1) continue; // Centers are fixed
+                char colour = redressed->cube[face][index][jindex];
+                const char * found = strchr(redressedColours, colour);
+                if (colour == '\0' || !found) {
+                    destroyCube(redressed);
+                    free(rotations);
+                    return NULL;
+                } // Blank facelets of a pattern
+                int value = found - redressedColours;
+                key[bit >> 3] |= value << (bit & 7);
+                if ((bit & 7) > 5) {
+                    key[(bit >> 3) + 1] |= value >> (8 - (bit & 7));
+                } // The facelet overlaps two bytes
+                bit += 3;
+            }
+        }
+    }
+
+    destroyCube(redressed);
+    return rotations;
+}
+
+/**
+ * FNV-1a hash of a key
+ */
+static unsigned int hashKey(const unsigned char * key) {
+    uint32_t hash = 2166136261u;
+    for (int index = 0 ; index < SOLVE_CACHE_KEY_BYTES ; index++) {
+        hash = (hash ^ key[index]) * 16777619u;
+    }
+    return hash;
+}
+
+static size_t entryBytes(int size) {
+    return sizeof(solveCacheEntry) + PACKED_MOVES_BYTES(size);
+}
+
+static solveCacheEntry * findEntry(solveCache * self,
+        const unsigned char * key, unsigned int hash) {
+    solveCacheEntry * entry = self->buckets[hash & (self->bucketCount - 1)];
+    while (entry && (entry->hash != hash
+                || memcmp(entry->key, key, SOLVE_CACHE_KEY_BYTES))) {
+        entry = entry->nextInBucket;
+    }
+    return entry;
+}
+
+/**
+ * Removes an entry from the list of recently used entries
+ */
+static void unlinkEntry(solveCache * self, solveCacheEntry * entry) {
+    if (entry->newer) entry->newer->older = entry->older;
+    else self->newest = entry->older;
+    if (entry->older) entry->older->newer = entry->newer;
+    else self->oldest = entry->newer;
+}
+
+/**
+ * Puts an entry at the head of the list of recently used entries
+ */
+static void touchEntry(solveCache * self, solveCacheEntry * entry) {
+    entry->newer = NULL;
+    entry->older = self->newest;
+    if (self->newest) self->newest->newer = entry;
+    else self->oldest = entry;
+    self->newest = entry;
+}
+
+static void removeEntry(solveCache * self, solveCacheEntry * entry) {
+    solveCacheEntry ** link =
+        &self->buckets[entry->hash & (self->bucketCount - 1)];
+    while (*link != entry) link = &(*link)->nextInBucket;
+    *link = entry->nextInBucket;
+
+    unlinkEntry(self, entry);
+    self->entries--;
+    self->bytes -= entryBytes(entry->size);
+    free(entry);
+}
+
+/**
+ * Doubles the number of buckets
+ */
+static void growBuckets(solveCache * self) {
+    unsigned int bucketCount = self->bucketCount * 2;
+    solveCacheEntry ** buckets = (solveCacheEntry **) \
+        ec_malloc(sizeof(solveCacheEntry *) * bucketCount);
+    memset(buckets, 0, sizeof(solveCacheEntry *) * bucketCount);
+
+    for (unsigned int index = 0 ; index < self->bucketCount ; index++) {
+        solveCacheEntry * entry = self->buckets[index];
+        while (entry) {
+            solveCacheEntry * next = entry->nextInBucket;
+            entry->nextInBucket = buckets[entry->hash & (bucketCount - 1)];
+            buckets[entry->hash & (bucketCount - 1)] = entry;
+            entry = next;
+        }
+    }
+
+    free(self->buckets);
+    self->buckets = buckets;
+    self->bucketCount = bucketCount;
+}
+
+/**
+ * Adds an entry for a key, replacing the entry of the key if any, and evicts
+ * the least recently used entries over the size of the cache
+ */
+static void insertEntry(solveCache * self, const unsigned char * key,
+        const move * moves, int size) {
+    unsigned int hash = hashKey(key);
+    solveCacheEntry * previous = findEntry(self, key, hash);
+    if (previous) removeEntry(self, previous);
+
+    solveCacheEntry * entry = (solveCacheEntry *) ec_malloc(entryBytes(size));
+    memcpy(entry->key, key, SOLVE_CACHE_KEY_BYTES);
+    entry->hash = hash;
+    entry->size = size;
+    packMoveBuffer(entry->moves, moves, size);
+
+    if ((unsigned int) self->entries >= self->bucketCount) growBuckets(self);
+    solveCacheEntry ** bucket = &self->buckets[hash & (self->bucketCount - 1)];
+    entry->nextInBucket = *bucket;
+    *bucket = entry;
+    touchEntry(self, entry);
+    self->entries++;
+    self->bytes += entryBytes(size);
+
+    while (self->bytes > self->maxBytes && self->oldest) {
+        removeEntry(self, self->oldest);
+    }
+}
+
+/**
+ * Loads the entries of a cache file, up to the first invalid one
+ */
+static void loadSolveCache(solveCache * self, FILE * file) {
+    unsigned char header[5];
+    if (fread(header, 1, 5, file) != 5
+            || memcmp(header, solveCacheMagic, 4)
+            || header[4] != SOLVE_CACHE_VERSION) {
+        return;
+    }
+
+    unsigned char key[SOLVE_CACHE_KEY_BYTES];
+    unsigned char sizeBytes[2];
+    unsigned char * data = (unsigned char *) \
+        ec_malloc(PACKED_MOVES_BYTES(SOLVE_CACHE_MAX_MOVES));
+    move * moves = (move *) ec_malloc(sizeof(move) * SOLVE_CACHE_MAX_MOVES);
+    while (fread(key, 1, SOLVE_CACHE_KEY_BYTES, file) == SOLVE_CACHE_KEY_BYTES
+            && fread(sizeBytes, 1, 2, file) == 2) {
+        int size = sizeBytes[0] | sizeBytes[1] << 8;
+        if (fread(data, 1, PACKED_MOVES_BYTES(size), file)
+                != (size_t) PACKED_MOVES_BYTES(size)) {
+            break;
+        }
+        unpackMoveBuffer(moves, data, size);
+
+        int index = 0;
+        while (index < size && (int) moves[index] < 30) index++;
+        if (index < size) break; // Only single moves are stored
+
+        insertEntry(self, key, moves, size);
+    }
+    free(data);
+    free(moves);
+}
+
+solveCache * initSolveCache(size_t maxBytes, const char * path) {
+    solveCache * self = (solveCache *) ec_malloc(sizeof(solveCache));
+    self->bucketCount = SOLVE_CACHE_BUCKETS;
+    self->buckets = (solveCacheEntry **) \
+        ec_malloc(sizeof(solveCacheEntry *) * self->bucketCount);
+    memset(self->buckets, 0, sizeof(solveCacheEntry *) * self->bucketCount);
+    self->newest = NULL;
+    self->oldest = NULL;
+    self->entries = 0;
+    self->bytes = 0;
+    self->maxBytes = maxBytes;
+    self->hits = 0;
+    self->misses = 0;
+    self->path = NULL;
+
+    if (path) {
+        self->path = (char *) ec_malloc(sizeof(char) * (strlen(path) + 1));
+        strcpy(self->path, path);
+        FILE * file = fopen(path, "rb");
+        if (file) {
+            loadSolveCache(self, file);
+            fclose(file);
+        } // No file yet on the first run
+    }
+    return self;
+}
+
+move * lookupSolveCache(solveCache * self, cube * aCube) {
+    unsigned char key[SOLVE_CACHE_KEY_BYTES];
+    move * rotations = cubeKey(aCube, key);
+    solveCacheEntry * entry = rotations
+        ? findEntry(self, key, hashKey(key)) : NULL;
+    if (!entry) {
+        free(rotations);
+        self->misses++;
+        return NULL;
+    }
+
+    unlinkEntry(self, entry);
+    touchEntry(self, entry);
+    self->hits++;
+
+    // The rotations redressing the cube, then the solution of the redressed
+    // cube
+    int rotationCount = countMoves(rotations);
+    move * solution = (move *) \
+        ec_malloc(sizeof(move) * (rotationCount + entry->size + 1));
+    int size = 0;
+    for (int index = 0 ; index < rotationCount ; index++) {
+        size = appendReduced(solution, size, rotations[index]);
+    }
+    for (int index = 0 ; index < entry->size ; index++) {
+        size = appendReduced(solution, size,
+                readPackedMove(entry->moves, index));
+    }
+    solution[size] = -1;
+
+    free(rotations);
+    return solution;
+}
+
+void storeSolveCache(solveCache * self, cube * aCube, move * solution) {
+    unsigned char key[SOLVE_CACHE_KEY_BYTES];
+    move * rotations = cubeKey(aCube, key);
+    if (!rotations) return;
+
+    cube * work = executeBulkCommand(aCube->copy(aCube), solution);
+    cube * solved = initCube();
+    bool solves = patternMatches(work, solved);
+    destroyCube(work);
+    destroyCube(solved);
+    if (!solves) {
+        free(rotations);
+        return;
+    } // Only the checked solutions are stored, and saved to the file
+
+    // The solution of the redressed cube undoes the rotations first
+    int rotationCount = countMoves(rotations);
+    int solutionCount = countMoves(solution);
+    move * moves = (move *) \
+        ec_malloc(sizeof(move) * (rotationCount + solutionCount + 1));
+    int size = 0;
+    for (int index = rotationCount - 1 ; index >= 0 ; index--) {
+        size = appendReduced(moves, size, inverseMove(rotations[index]));
+    }
+    for (int index = 0 ; index < solutionCount ; index++) {
+        size = appendReduced(moves, size, solution[index]);
+    }
+
+    solveCacheEntry * previous = findEntry(self, key, hashKey(key));
+    if (size <= SOLVE_CACHE_MAX_MOVES && (!previous || previous->size > size)) {
+        insertEntry(self, key, moves, size);
+    } // Keeping the shortest solution
+
+    free(moves);
+    free(rotations);
+}
+
+move * cachedSolve(solveCache * self, cube * aCube) {
+    move * solution = lookupSolveCache(self, aCube);
+    if (!solution) {
+        solution = neutralSolve(aCube);
+        storeSolveCache(self, aCube, solution);
+    }
+    return solution;
+}
+
+bool saveSolveCache(solveCache * self) {
+    if (!self->path) return false;
+
+    char * tempPath = (char *) ec_malloc(sizeof(char) * (strlen(self->path) + 5));
+    sprintf(tempPath, "%s.tmp", self->path);
+    FILE * file = fopen(tempPath, "wb");
+    if (!file) {
+        free(tempPath);
+        return false;
+    }
+
+    fwrite(solveCacheMagic, 1, 4, file);
+    fputc(SOLVE_CACHE_VERSION, file);
+    for (solveCacheEntry * entry = self->oldest ; entry ; entry = entry->newer) {
+        fwrite(entry->key, 1, SOLVE_CACHE_KEY_BYTES, file);
+        fputc(entry->size & 0xFF, file);
+        fputc(entry->size >> 8, file);
+        fwrite(entry->moves, 1, PACKED_MOVES_BYTES(entry->size), file);
+    } // Loaded back in the same order, the recent entries stay recent
+
+    bool written = !ferror(file);
+    written = fclose(file) == 0 && written;
+    written = written && rename(tempPath, self->path) == 0;
+    if (!written) remove(tempPath);
+    free(tempPath);
+    return written;
+}
+
+void freeSolveCache(solveCache * self) {
+    while (self->oldest) removeEntry(self, self->oldest);
+    free(self->buckets);
+    free(self->path);
+    free(self);
+}
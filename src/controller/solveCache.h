@@ -0,0 +1,122 @@
+/**
+ * @file solveCache.h
+ * Cache of the solutions of the solver
+ *
+ * The solutions are stored for the cube redressed with green on front and
+ * white on top (see redressCube()), so the 24 orientations of a cube share
+ * the same entry. A solution found in the cache starts with the x, y, z
+ * rotations bringing the cube to that orientation.
+ *
+ * The cube is the key of the cache : the 48 facelets which are not centers,
+ * packed on 3 bits each. The least recently used entries are evicted when the
+ * cache exceeds its size.
+ *
+ * The cache may be saved to a file and loaded back. The file is the magic
+ * "RBKC", the format version, then the entries from the least to the most
+ * recently used : the key, the number of moves on 2 bytes (little-endian) and
+ * the moves packed on 6 bits (see packedMoves.h).
+ */
+
+#ifndef SOLVE_CACHE_H
+#define SOLVE_CACHE_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../model/cube.h"
+#include "commandParser.h"
+#include "packedMoves.h"
+#include "patternComparator.h"
+#include "solver.h"
+#include "utils.h"
+
+#define SOLVE_CACHE_VERSION 2       /**< 2 : only checked solutions */
+#define SOLVE_CACHE_KEY_BYTES 18    /**< 48 facelets on 3 bits */
+
+/**
+ * A solution of the cache
+ */
+typedef struct _solveCacheEntry {
+    unsigned char key[SOLVE_CACHE_KEY_BYTES];   /**< The redressed cube */
+    unsigned int hash;                      /**< Hash of the key */
+    struct _solveCacheEntry * nextInBucket; /**< Next entry of the bucket */
+    struct _solveCacheEntry * newer;        /**< Next more recently used */
+    struct _solveCacheEntry * older;        /**< Next less recently used */
+    int size;                               /**< Number of moves */
+    unsigned char moves[];                  /**< The packed solution */
+} solveCacheEntry;
+
+/**
+ * A cache of solutions, with the least recently used evicted first
+ */
+typedef struct _solveCache {
+    solveCacheEntry ** buckets;     /**< Hash table of the entries */
+    unsigned int bucketCount;       /**< Number of buckets, a power of 2 */
+    solveCacheEntry * newest;       /**< The most recently used entry */
+    solveCacheEntry * oldest;       /**< The least recently used entry */
+    int entries;                    /**< Number of entries */
+    size_t bytes;                   /**< Memory used by the entries */
+    size_t maxBytes;                /**< Memory allowed for the entries */
+    unsigned long hits;             /**< Number of solutions found */
+    unsigned long misses;           /**< Number of solutions not found */
+    char * path;                    /**< The file of the cache, or NULL */
+} solveCache;
+
+/**
+ * Creates a cache, loading the entries of its file if it exists
+ *
+ * An invalid file is loaded up to its first invalid entry.
+ *
+ * @param maxBytes - Memory allowed for the entries
+ * @param path - The file of the cache, NULL for a cache only in memory
+ * @returns a pointer to the new cache
+ */
+solveCache * initSolveCache(size_t maxBytes, const char * path);
+
+/**
+ * Looks for the solution of a cube, counting a hit or a miss
+ *
+ * @param self - The cache
+ * @param aCube - The cube to solve, in any orientation
+ * @returns the solution of the cube terminated by -1, to be freed, or NULL if
+ * the cube is not in the cache
+ */
+move * lookupSolveCache(solveCache * self, cube * aCube);
+
+/**
+ * Stores the solution of a cube, as the most recently used entry
+ *
+ * A solution longer than the one already stored for the cube is ignored, as
+ * well as moves which do not solve the cube.
+ *
+ * @param self - The cache
+ * @param aCube - The cube solved, in any orientation
+ * @param solution - The solution of the cube, without double moves
+ */
+void storeSolveCache(solveCache * self, cube * aCube, move * solution);
+
+/**
+ * Returns the solution of a cube from the cache, or from neutralSolve() stored
+ * in the cache
+ *
+ * @param self - The cache
+ * @param aCube - The cube to solve
+ * @returns the solution terminated by -1, to be freed
+ */
+move * cachedSolve(solveCache * self, cube * aCube);
+
+/**
+ * Writes the cache to its file
+ *
+ * The file is replaced at once, so a crash keeps the previous file.
+ *
+ * @returns false if the cache has no file or it cannot be written
+ */
+bool saveSolveCache(solveCache * self);
+
+/**
+ * Frees the cache and its entries, without saving it
+ */
+void freeSolveCache(solveCache * self);
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file solveRepair.c
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include "solveRepair.h"
+
+/**
+ * The moves tried by a repair : the face moves and the rotations
+ */
+static const move repairMoves[] = {
+    F, B, R, L, U, D, Fi, Bi, Ri, Li, Ui, Di, x, y, z, xi, yi, zi
+};
+
+/**
+ * State of a repair search
+ */
+typedef struct _repairSearch {
+    solvePath * path;                       // The path to reach
+    cube * work;                            // The cube, moved by the search
+    unsigned char state[SOLVE_STATE_BYTES]; // The state of work
+    move current[SOLVE_REPAIR_DEPTH];       // The moves tried
+    move best[SOLVE_REPAIR_DEPTH];          // The best repair found
+    int bestDepth;                          // Number of moves of best
+    int bestIndex;                          // The state of the path it reaches
+    int bestCost;                           // Moves of best and moves left
+    const struct timespec * until;          // Deadline, or NULL
+    volatile int * cancel;                  // Cancel flag, or NULL
+    long nodes;                             // Nodes searched
+    bool stopped;                           // Stopped by until or cancel
+} repairSearch;
+
+static void readState(cube * aCube, unsigned char * state) {
+    for (int face = F ; face <= D ; face++) {
+        for (int index = 0 ; index < 3 ; index++) {
+            memcpy(state + face * 9 + index * 3, aCube->cube[face][index], 3);
+        }
+    }
+}
+
+/**
+ * FNV-1a hash of a state
+ */
+static unsigned int hashState(const unsigned char * state) {
+    uint32_t hash = 2166136261u;
+    for (int index = 0 ; index < SOLVE_STATE_BYTES ; index++) {
+        hash = (hash ^ state[index]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Returns the slot of a state in the hash table, or the free slot where it
+ * goes
+ */
+static int findSlot(solvePath * self, const unsigned char * state) {
+    int slot = hashState(state) & (self->slotCount - 1);
+    while (self->slots[slot] != -1 && memcmp(state,
+                self->states + self->slots[slot] * SOLVE_STATE_BYTES,
+                SOLVE_STATE_BYTES)) {
+        slot = (slot + 1) & (self->slotCount - 1);
+    } // Linear probing
+    return slot;
+}
+
+solvePath * initSolvePath(cube * aCube, move * solution) {
+    solvePath * self = (solvePath *) ec_malloc(sizeof(solvePath));
+    self->size = 0;
+    while ((int) solution[self->size] != -1) self->size++;
+    self->moves = (move *) ec_malloc(sizeof(move) * (self->size + 1));
+    memcpy(self->moves, solution, sizeof(move) * (self->size + 1));
+
+    self->states = (unsigned char *) \
+        ec_malloc(SOLVE_STATE_BYTES * (self->size + 1));
+    self->slotCount = 16;
+    while (self->slotCount < 2 * (self->size + 1)) self->slotCount *= 2;
+    self->slots = (int *) ec_malloc(sizeof(int) * self->slotCount);
+    memset(self->slots, -1, sizeof(int) * self->slotCount);
+
+    cube * work = aCube->copy(aCube);
+    for (int index = 0 ; index <= self->size ; index++) {
+        unsigned char * state = self->states + index * SOLVE_STATE_BYTES;
+        readState(work, state);
+        self->slots[findSlot(self, state)] = index;
+        if (index < self->size) work->rotate(work, self->moves[index]);
+    } // A state met twice keeps its last index, with the fewest moves left
+    destroyCube(work);
+    return self;
+}
+
+/**
+ * Returns true if the deadline is reached or the search is cancelled
+ */
+static bool stopRepair(repairSearch * search) {
+    if (search->cancel && *search->cancel) return true;
+    if (!search->until) return false;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > search->until->tv_sec
+        || (now.tv_sec == search->until->tv_sec
+                && now.tv_nsec >= search->until->tv_nsec);
+}
+
+/**
+ * Depth-first search of the repairs, bounded by the best one found
+ */
+static void searchRepair(repairSearch * search, int depth, int maxDepth) {
+    if (++search->nodes % SOLVE_REPAIR_CHECK == 0 && stopRepair(search)) {
+        search->stopped = true;
+    }
+    if (search->stopped) return;
+    readState(search->work, search->state);
+    int slot = search->path->slots[findSlot(search->path, search->state)];
+    if (slot != -1 && depth + search->path->size - slot < search->bestCost) {
+        memcpy(search->best, search->current, sizeof(move) * depth);
+        search->bestDepth = depth;
+        search->bestIndex = slot;
+        search->bestCost = depth + search->path->size - slot;
+    }
+    if (depth == maxDepth || depth + 1 >= search->bestCost) return;
+
+    for (unsigned int index = 0 ; index < sizeof(repairMoves) / sizeof(move) ;
+            index++) {
+        move cmd = repairMoves[index];
+        if (depth > 0 && search->current[depth - 1] == inverseMove(cmd)) {
+            continue;
+        } // Cancelling the last move
+        if (depth > 1 && search->current[depth - 1] == cmd
+                && search->current[depth - 2] == cmd) {
+            continue;
+        } // Three times the same move is its inverse
+
+        search->current[depth] = cmd;
+        search->work->rotate(search->work, cmd);
+        searchRepair(search, depth + 1, maxDepth);
+        search->work->rotate(search->work, inverseMove(cmd));
+    }
+}
+
+move * repairSolvePath(solvePath * self, cube * aCube, int maxDepth,
+        const struct timespec * until, volatile int * cancel) {
+    if (maxDepth > SOLVE_REPAIR_DEPTH) maxDepth = SOLVE_REPAIR_DEPTH;
+
+    repairSearch search;
+    search.path = self;
+    search.work = aCube->copy(aCube);
+    search.bestDepth = 0;
+    search.bestIndex = -1;
+    search.bestCost = INT_MAX;
+    search.until = until;
+    search.cancel = cancel;
+    search.nodes = 0;
+    search.stopped = false;
+    searchRepair(&search, 0, maxDepth);
+    destroyCube(search.work);
+    if (search.bestIndex == -1) return NULL;
+
+    move * repaired = (move *) ec_malloc(sizeof(move) * (search.bestCost + 1));
+    memcpy(repaired, search.best, sizeof(move) * search.bestDepth);
+    memcpy(repaired + search.bestDepth, self->moves + search.bestIndex,
+            sizeof(move) * (self->size - search.bestIndex + 1));
+    return repaired; // The endmark of the path ends the repaired solution
+}
+
+void freeSolvePath(solvePath * self) {
+    free(self->moves);
+    free(self->states);
+    free(self->slots);
+    free(self);
+}
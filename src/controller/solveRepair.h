@@ -0,0 +1,78 @@
+/**
+ * @file solveRepair.h
+ * Repair of a solution when the player leaves it
+ *
+ * A solvePath keeps the states of the cube along a solution. When the player
+ * makes a move which is not the next move of the solution, a short search
+ * looks for a sequence of at most SOLVE_REPAIR_DEPTH moves bringing the cube
+ * back to one of these states, and the solution continues from there. When the
+ * cube is too far from the path, it has to be solved again.
+ *
+ * The states are compared as they are, orientation included, since the moves
+ * following a state depend on the orientation.
+ */
+
+#ifndef SOLVE_REPAIR_H
+#define SOLVE_REPAIR_H
+
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "../model/cube.h"
+#include "commandQueue.h"
+#include "utils.h"
+
+#define SOLVE_REPAIR_DEPTH 4    /**< Maximum length of a repair */
+#define SOLVE_STATE_BYTES 54    /**< Facelets of a state of the path */
+#define SOLVE_REPAIR_CHECK 1024 /**< Nodes between two checks of the stop */
+
+/**
+ * The states of the cube along a solution
+ */
+typedef struct _solvePath {
+    move * moves;           /**< The solution, terminated by -1 */
+    int size;               /**< Number of moves of the solution */
+    unsigned char * states; /**< The size + 1 states, the state k being the
+                              cube before the move k */
+    int * slots;            /**< Hash table of the states, -1 if free */
+    int slotCount;          /**< Number of slots, a power of 2 */
+} solvePath;
+
+/**
+ * Records the states of a cube along a solution
+ *
+ * @param aCube - The cube before the solution, which is not modified
+ * @param solution - The solution, without double moves
+ * @returns a pointer to the new path
+ */
+solvePath * initSolvePath(cube * aCube, move * solution);
+
+/**
+ * Looks for the shortest way to finish the solution from a cube
+ *
+ * Every sequence of at most maxDepth moves (the face moves and the rotations
+ * of the whole cube) is tried. The sequence reaching a state of the path with
+ * the fewest moves left, repair and end of the solution together, is kept.
+ *
+ * The deadline and the cancel flag are checked every SOLVE_REPAIR_CHECK
+ * nodes. When one of them stops the search, the best repair found so far is
+ * returned.
+ *
+ * @param self - The path
+ * @param aCube - The cube, which is not modified
+ * @param maxDepth - Maximum length of the repair
+ * @param until - The time on the monotonic clock when the search stops, or
+ * NULL
+ * @param cancel - The search stops when it becomes non zero, or NULL
+ * @returns the moves of the repair followed by the end of the solution,
+ * terminated by -1 and to be freed, or NULL if the path is out of reach
+ */
+move * repairSolvePath(solvePath * self, cube * aCube, int maxDepth,
+        const struct timespec * until, volatile int * cancel);
+
+/**
+ * Frees the path and its states
+ */
+void freeSolvePath(solvePath * self);
+
+#endif
@@ -61,114 +61,470 @@ move * fakeSolve(move * initSequence, mvstack history) {
 	return solvesequence;
 }
 
+/**
+ * Returns the number of moves of an array terminated by -1
+ */
+static int countMoves(move * moves) {
+	int size = 0;
+	while ((int) moves[size] != -1) size++;
+	return size;
+}
+
+/**
+ * Plays the steps of the method on a cube
+ *
+ * @param work the cube, solved by the steps
+ * @param stepMoves set with the moves of each step, to be freed, and left
+ *  untouched for the steps not done when a step is stuck
+ */
+static void playSteps(cube * work, char ** stepMoves) {
+	char * (*steps[SOLVER_STEPS])(cube *) = {
+		solveXCross, solvePairs, solveLastLayer
+	};
+	for (int step = 0; step < SOLVER_STEPS; step++) {
+		stepMoves[step] = steps[step](work);
+	}
+}
+
+/**
+ * Concatenates and frees the moves of the steps
+ *
+ * @returns the moves, terminated by -1, to be freed by the caller
+ */
+static move * joinSteps(char ** stepMoves) {
+	size_t length = 1;
+	for (int step = 0; step < SOLVER_STEPS; step++) {
+		length += strlen(stepMoves[step]);
+	}
+
+	// Concatenating the steps in a buffer of the right size
+	char * solution = (char *) ec_malloc(sizeof(char) * length);
+	*solution = '\0';
+	for (int step = 0; step < SOLVER_STEPS; step++) {
+		strcat(solution, stepMoves[step]);
+		free(stepMoves[step]);
+	}
+
+	move * moves = commandParser(solution);
+	free(solution);
+	move * expanded = expandCommand(moves);
+	free(moves);
+	return expanded;
+}
+
 move * trueSolve(cube *self){
-	//cube * goal = initCube();
 	cube * work = self->copy(self);
+	char * stepMoves[SOLVER_STEPS];
+	playSteps(work, stepMoves);
+	destroyCube(work);
+	move * solution = joinSteps(stepMoves);
+
+	// The moves are played on a copy, a step could return other moves than
+	// the ones it played
+	work = executeBulkCommand(self->copy(self), solution);
+	cube * solved = initCube();
+	bool solves = patternMatches(work, solved);
+	destroyCube(work);
+	destroyCube(solved);
+	if (!solves) exitFatal("in trueSolve(), the moves found do not solve the cube");
+	return solution;
+}
+
+/**
+ * Solving of a cube with the colours turned so that one colour is white
+ */
+typedef struct _neutralAttempt {
+	cube * recoloured;                  // The cube with the colours turned
+	char * stepMoves[SOLVER_STEPS];     // The moves of the steps done
+	move * solution;                    // The solution, NULL if stuck
+	bool done;                          // Set once solved, under poolLock
+	struct _neutralAttempt * next;      // Next attempt waiting for a thread
+} neutralAttempt;
+
+/**
+ * The threads solving the attempts of neutralSolve(), started once and shared
+ * by all the calls
+ */
+static pthread_once_t poolStarted = PTHREAD_ONCE_INIT;
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poolQueued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t poolSolved = PTHREAD_COND_INITIALIZER;
+static neutralAttempt * poolQueue = NULL;   // Attempts waiting for a thread
+
+/**
+ * Returns the cube with its colours turned as the centers of a solved cube
+ * turned to have a colour up, so that this colour becomes white
+ *
+ * The colours are turned as by a rotation of the whole cube, so the cube is
+ * still a valid cube, and a solution of it solves the original cube.
+ */
+static cube * recolourCube(cube * self, char colour) {
+	cube * solved = initCube();
+	cube * turned = initCube();
+	positionCube(turned, colour == 'g' || colour == 'b' ? 'r' : 'g', colour);
+	char colours[256] = {0};
+	for (int face = F; face <= D; face++) {
+		colours[(unsigned char) turned->cube[face][1][1]] =
+			solved->cube[face][1][1];
+	}
+	destroyCube(solved);
+	destroyCube(turned);
+
+	cube * recoloured = self->copy(self);
+	for (int face = F; face <= D; face++) {
+		for (int row = 0; row < 3; row++) {
+			for (int col = 0; col < 3; col++) {
+				recoloured->cube[face][row][col] =
+					colours[(unsigned char) self->cube[face][row][col]];
+			}
+		}
+	}
+	return recoloured;
+}
+
+/**
+ * Solves the cube of an attempt, with a recovery point when a step is stuck
+ */
+static void * solveAttempt(void * data) {
+	neutralAttempt * attempt = (neutralAttempt *) data;
+	cube * work = attempt->recoloured->copy(attempt->recoloured);
+	for (int step = 0; step < SOLVER_STEPS; step++) {
+		attempt->stepMoves[step] = NULL;
+	}
+	attempt->solution = NULL;
+
+	jmp_buf recovery;
+	if (setjmp(recovery)) {
+		for (int step = 0; step < SOLVER_STEPS; step++) {
+			free(attempt->stepMoves[step]);
+		}
+	} else {
+		recoverStuckSteps(&recovery);
+		playSteps(work, attempt->stepMoves);
+		attempt->solution = joinSteps(attempt->stepMoves);
+	} // A stuck step jumps back with its moves freed
+	recoverStuckSteps(NULL);
+	destroyCube(work);
+	return NULL;
+}
+
+/**
+ * Solves an attempt and wakes up the thread waiting for it
+ */
+static void finishAttempt(neutralAttempt * attempt) {
+	solveAttempt(attempt);
+	pthread_mutex_lock(&poolLock);
+	attempt->done = true;
+	pthread_cond_broadcast(&poolSolved);
+	pthread_mutex_unlock(&poolLock);
+}
+
+/**
+ * Main loop of a thread of the pool : solves the queued attempts
+ */
+static void * poolThread(void * unused) {
+	(void) unused;
+	while (true) {
+		pthread_mutex_lock(&poolLock);
+		while (!poolQueue) pthread_cond_wait(&poolQueued, &poolLock);
+		neutralAttempt * attempt = poolQueue;
+		poolQueue = attempt->next;
+		pthread_mutex_unlock(&poolLock);
+		finishAttempt(attempt);
+	}
+	return NULL;
+}
+
+/**
+ * Starts a thread for each colour but white, which is solved by the caller
+ */
+static void startPool() {
+	for (int index = 1; index < SOLVER_COLOURS; index++) {
+		pthread_t thread;
+		if (!pthread_create(&thread, NULL, poolThread, NULL)) {
+			pthread_detach(thread);
+		}
+	} // Without threads, the callers solve their attempts themselves
+}
+
+/**
+ * Takes an attempt back from the queue if no thread took it yet
+ */
+static bool unqueueAttempt(neutralAttempt * attempt) {
+	pthread_mutex_lock(&poolLock);
+	neutralAttempt ** queued = &poolQueue;
+	while (*queued && *queued != attempt) queued = &(*queued)->next;
+	bool found = *queued != NULL;
+	if (found) *queued = attempt->next;
+	pthread_mutex_unlock(&poolLock);
+	return found;
+}
+
+move * neutralSolve(cube * self) {
+	const char colours[SOLVER_COLOURS] = {'w', 'y', 'g', 'b', 'r', 'o'};
+	neutralAttempt attempts[SOLVER_COLOURS];
+	for (int index = 0; index < SOLVER_COLOURS; index++) {
+		attempts[index].recoloured = recolourCube(self, colours[index]);
+		attempts[index].done = false;
+	}
+
+	pthread_once(&poolStarted, startPool);
+	pthread_mutex_lock(&poolLock);
+	for (int index = SOLVER_COLOURS - 1; index > 0; index--) {
+		attempts[index].next = poolQueue;
+		poolQueue = &attempts[index];
+	}
+	pthread_cond_broadcast(&poolQueued);
+	pthread_mutex_unlock(&poolLock);
+
+	// The white cross is solved by the calling thread, which then solves the
+	// attempts no thread of the pool took yet
+	finishAttempt(&attempts[0]);
+	for (int index = 1; index < SOLVER_COLOURS; index++) {
+		if (unqueueAttempt(&attempts[index])) finishAttempt(&attempts[index]);
+	}
+	pthread_mutex_lock(&poolLock);
+	for (int index = 1; index < SOLVER_COLOURS; index++) {
+		while (!attempts[index].done) {
+			pthread_cond_wait(&poolSolved, &poolLock);
+		}
+	}
+	pthread_mutex_unlock(&poolLock);
+
+	// The shortest solution which solves the cube is kept
+	move * best = NULL;
+	int bestSize = 0;
+	cube * solved = initCube();
+	for (int index = 0; index < SOLVER_COLOURS; index++) {
+		destroyCube(attempts[index].recoloured);
+		move * solution = attempts[index].solution;
+		if (!solution) continue;
+
+		cube * work = executeBulkCommand(self->copy(self), solution);
+		bool solves = patternMatches(work, solved);
+		destroyCube(work);
+		int size = countMoves(solution);
+		if (solves && (!best || size < bestSize)) {
+			free(best);
+			best = solution;
+			bestSize = size;
+		} else {
+			free(solution);
+		}
+	}
+	destroyCube(solved);
+
+	if (!best) exitFatal("in neutralSolve(), no colour gives moves solving the cube");
+	return best;
+}
+
+/**
+ * Returns the microseconds elapsed since start on the monotonic clock
+ */
+static long elapsedUs(struct timespec * start) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) * 1000000L
+		+ (now.tv_nsec - start->tv_nsec) / 1000;
+}
+
+/**
+ * Returns true if two cubes are in the same state, orientation included
+ */
+static bool sameState(cube * aCube, cube * bCube) {
+	for (int face = F; face <= D; face++) {
+		for (int index = 0; index < 3; index++) {
+			if (memcmp(aCube->cube[face][index], bCube->cube[face][index], 3)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Fills the moves equal to a rotation, a move and the inverse rotation, for
+ * the 6 rotations x, y, z, xi, yi, zi and the 30 single moves
+ */
+static void conjugateMoves(move conjugates[6][30]) {
+	move rotations[6] = {x, y, z, xi, yi, zi};
+	cube * conjugated = initCube();
+	cube * candidate = initCube();
+	for (int rotation = 0; rotation < 6; rotation++) {
+		for (move cmd = F; cmd < F2; cmd++) {
+			conjugated->rotate(conjugated, rotations[rotation]);
+			conjugated->rotate(conjugated, cmd);
+			conjugated->rotate(conjugated, inverseMove(rotations[rotation]));
+
+			move found = F;
+			candidate->rotate(candidate, found);
+			while (!sameState(conjugated, candidate)) {
+				candidate->rotate(candidate, inverseMove(found));
+				candidate->rotate(candidate, ++found);
+			} // A rotation only renames the faces
+			candidate->rotate(candidate, inverseMove(found));
+			conjugated->rotate(conjugated, inverseMove(found));
+			conjugates[rotation][cmd] = found;
+		}
+	}
+	destroyCube(conjugated);
+	destroyCube(candidate);
+}
+
+/**
+ * Appends a move to a solution, merging it with the last moves
+ *
+ * @returns the new size of the solution
+ */
+static int appendMerged(move * moves, int size, move cmd) {
+	int last = size - 1;
+	if (last > 0 && (int) cmd % 15 < 6 && (int) moves[last] % 15 < 6
+			&& moves[last] % 15 / 2 == cmd % 15 / 2
+			&& moves[last] % 15 != cmd % 15) {
+		last--;
+	} // Skipping a turn of the opposite face, which commutes with cmd
+
+	if (last >= 0 && moves[last] == inverseMove(cmd)) {
+		memmove(moves + last, moves + last + 1,
+			sizeof(move) * (size - last - 1));
+		return size - 1;
+	}
+	if (last == size - 1 && size > 1
+			&& moves[size - 1] == cmd && moves[size - 2] == cmd) {
+		return appendMerged(moves, size - 2, inverseMove(cmd));
+	} // Three times a move is its inverse
+	moves[size] = cmd;
+	return size + 1;
+}
+
+/**
+ * Removes the rotations of the whole cube from a solution, the moves
+ * following a rotation being renamed, and merges the moves
+ *
+ * @param moves the solution, simplified in place
+ * @param conjugates the moves renamed by the rotations
+ * @returns the new size of the solution
+ */
+static int simplifySolution(move * moves, move conjugates[6][30]) {
+	move renamed[30]; // The moves renamed by the rotations met so far
+	for (move cmd = F; cmd < F2; cmd++) renamed[cmd] = cmd;
+
+	int size = 0;
+	for (int index = 0; (int) moves[index] != -1; index++) {
+		move cmd = moves[index];
+		int rotation = cmd == x ? 0 : cmd == y ? 1 : cmd == z ? 2
+			: cmd == xi ? 3 : cmd == yi ? 4 : cmd == zi ? 5 : -1;
+		if (rotation == -1) {
+			size = appendMerged(moves, size, renamed[cmd]);
+			continue;
+		}
+
+		move previous[30];
+		memcpy(previous, renamed, sizeof(previous));
+		for (move next = F; next < F2; next++) {
+			renamed[next] = previous[conjugates[rotation][next]];
+		}
+	} // The last rotations are dropped : the cube is solved in any orientation
+	moves[size] = -1;
+	return size;
+}
+
+move * anytimeSolve(cube * self, long deadline, solveCallback callback, void * data, volatile int * cancel) {
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	struct timespec until = start;
+	until.tv_sec += deadline / 1000000L;
+	until.tv_nsec += (deadline % 1000000L) * 1000L;
+	if (until.tv_nsec >= 1000000000L) {
+		until.tv_sec++;
+		until.tv_nsec -= 1000000000L;
+	}
+
+	move * best = neutralSolve(self);
+	int bestSize = countMoves(best);
+	bool searching = !callback || callback(best, elapsedUs(&start), data);
+
+	move conjugates[6][30];
+	conjugateMoves(conjugates);
+	move * candidate = (move *) ec_malloc(sizeof(move) * (bestSize + 1));
+	memcpy(candidate, best, sizeof(move) * (bestSize + 1));
+	if (simplifySolution(candidate, conjugates) < bestSize) {
+		free(best);
+		best = candidate;
+		bestSize = countMoves(best);
+		searching = searching
+			&& (!callback || callback(best, elapsedUs(&start), data));
+	} else {
+		free(candidate);
+	}
+
+	// Looking for shortcuts from every state along the solution, longer ones
+	// at each pass
+	solvePath * path = initSolvePath(self, best);
+	cube * work = self->copy(self);
+	int position = 0;
+	int depth = 1;
+	while (searching && depth <= SOLVE_REPAIR_DEPTH
+			&& elapsedUs(&start) < deadline && !(cancel && *cancel)) {
+		if (position == bestSize) {
+			destroyCube(work);
+			work = self->copy(self);
+			position = 0;
+			depth++;
+			continue;
+		} // Next pass
+
+		move * repaired = repairSolvePath(path, work, depth, &until, cancel);
+		int repairedSize = repaired ? countMoves(repaired) : bestSize;
+		if (repairedSize < bestSize - position) {
+			candidate = (move *) \
+				ec_malloc(sizeof(move) * (position + repairedSize + 1));
+			memcpy(candidate, best, sizeof(move) * position);
+			memcpy(candidate + position, repaired,
+				sizeof(move) * (repairedSize + 1));
+			simplifySolution(candidate, conjugates);
+
+			free(best);
+			best = candidate;
+			bestSize = countMoves(best);
+			searching = !callback || callback(best, elapsedUs(&start), data);
+
+			freeSolvePath(path);
+			path = initSolvePath(self, best);
+			destroyCube(work);
+			work = self->copy(self);
+			if (position > bestSize) position = bestSize;
+			for (int index = 0; index < position; index++) {
+				work->rotate(work, best[index]);
+			} // The merges may have changed the moves before position
+		} else {
+			work->rotate(work, best[position++]);
+		}
+		free(repaired);
+	}
+
+	freeSolvePath(path);
+	destroyCube(work);
+	return best;
+}
+
+move * solveBetween(cube * from, cube * to, long deadline) {
+	cube * relative = relativeCube(from, to);
+	if (!relative) return NULL;
+	move * solution = anytimeSolve(relative, deadline, NULL, NULL, NULL);
+	destroyCube(relative);
 
-	char * whiteCrossStr = doWhiteCross(work);
-//	move *whiteCross = commandParser(whiteCrossStr);
-//	free(whiteCrossStr);
-//
-////	if ( goal->equals(goal, work)) {
-////		return expandCommand(whiteCross);
-////	}
-////
-//	//return expandCommand(whiteCross);
-//
-//	fprintf(stderr, "After doWhiteCross(), so far so good\n");
-//	move * disp = whiteCross;
-//	printMoveArray(disp);
-//	printCube(work);
-//
-	char * whiteCornersStr = orientWhiteCorners(work);
-	strcat(whiteCrossStr,whiteCornersStr);
-//	move * whiteCorners = commandParser(whiteCornersStr);
-//	free(whiteCornersStr);
-//	move * tempdisp = disp;
-//	disp = mvCat(whiteCorners, whiteCorners);
-//	free(tempdisp);
-//	fprintf(stderr, "After orientWhiteCorners(), so far so good\n");
-//	printMoveArray(disp);
-//	printCube(work);
-	char * placeSecondStr = placeSecondLayer(work);
-	strcat(whiteCrossStr,placeSecondStr);
-
-//	move * placeSecond = commandParser(placeSecondStr);
-//	free(placeSecondStr);
-//	tempdisp = disp;
-//	disp = mvCat(whiteCorners, placeSecond);
-//	free(tempdisp);
-//	fprintf(stderr, "After placeSecondLayer(), so far so good\n");
-//	printMoveArray(disp);
-//	printCube(work);
-
-	char * yellowCrossStr = doYellowCross(work);
-strcat(whiteCrossStr,yellowCrossStr);
-
-//	move * yellowCross = commandParser(yellowCrossStr);
-//	free(yellowCrossStr);
-//	tempdisp = disp;
-//	disp = mvCat(disp, yellowCross);
-//	free(tempdisp);
-//	fprintf(stderr, "After doYellowCross(), so far so good\n");
-//	printMoveArray(disp);
-//	printCube(work);
-//
-	char * yellowCornersStr = orientYellowCorners(work);
-strcat(whiteCrossStr, yellowCornersStr);
-
-//	move * yellowCorners = commandParser(yellowCornersStr);
-//	free(yellowCornersStr);
-//
-//	tempdisp = disp;
-//	disp = mvCat(disp, yellowCorners);
-//	free(tempdisp);
-//	fprintf(stderr, "After orientYellowCorners(), so far so good\n");
-//	printMoveArray(disp);
-//	printCube(work);
-//
-	char * placeEdgesLLStr = placeEdgesLastLayer(work);
-strcat(whiteCrossStr, placeEdgesLLStr);
-//	move * placeEdgesLL = commandParser(placeEdgesLLStr);
-//	free(placeEdgesLLStr);
-//	tempdisp = disp;
-//	disp = mvCat(disp, placeEdgesLL);
-//	free(tempdisp);
-//	fprintf(stderr, "After placeEdgesLastLayer(), so far so good\n");
-//	printMoveArray(disp);
-//	printCube(work);
-//
-char * orientCornersLLStr = orientCornersLastLayer(work);
-strcat(whiteCrossStr, orientCornersLLStr);
-//	move * orientCornersLL = commandParser(orientCornersLLStr);
-//
-move * disp = commandParser(whiteCrossStr);
-//	free(orientCornersLLStr);
-//
-//	tempdisp = disp;
-//	disp = mvCat(disp, orientCornersLL);
-//	free(tempdisp);
-//	fprintf(stderr, "After orientCornersLastLayer(), so far so good\n");
-//	printMoveArray(disp);
-//	printCube(work);
-
-	/*
-	   destroyCube(work);
-	   move * temp = mvCat(whiteCross,whiteCorners);
-	   free(whiteCross);
-	   free(whiteCorners);
-	   temp = mvCat(temp, placeSecond);
-	   free(placeSecond);
-	   temp = mvCat(temp, yellowCross);
-	   free(yellowCross);
-	   temp = mvCat(temp, yellowCorners);
-	   free(yellowCorners);
-	   temp = mvCat(temp, placeEdgesLL);
-	   free(placeEdgesLL);
-	   temp = mvCat(temp, orientCornersLL);
-	   free(orientCornersLL);
-	   */
-
-	return expandCommand(disp);
+	// The solution leaves the stickers in place, the cube may still have to
+	// be turned as the second one
+	cube * work = from->copy(from);
+	executeBulkCommand(work, solution);
+	move * rotations = positionCmd(work, to->cube[F][1][1], to->cube[U][1][1]);
+	move * expanded = expandCommand(rotations);
+	move * moves = mvCat(solution, expanded);
 
+	free(rotations);
+	free(expanded);
+	free(solution);
+	destroyCube(work);
+	return moves;
 }
@@ -1,13 +1,36 @@
 #ifndef SOLVER_H
 #define SOLVER_H
 
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <time.h>
 #include "../model/cube.h"
-#include "../view/view.h"
+#include "../model/facelets.h"
 #include "commandQueue.h"
 #include "utils.h"
+#include "crossTable.h"
+#include "pairTable.h"
+#include "xcrossSearch.h"
+#include "lastLayerTable.h"
 #include "f2l.h"
 #include "oll.h"
 #include "pll.h"
+#include "patternComparator.h"
+#include "solveRepair.h"
+
+#define SOLVER_STEPS 3  /**< Number of steps of trueSolve() */
+#define SOLVER_COLOURS 6    /**< Colours of the cross tried by neutralSolve() */
+
+/**
+ * Function called by anytimeSolve() with each solution found
+ *
+ * @param solution the moves, terminated by -1, only valid during the call
+ * @param elapsed the microseconds since anytimeSolve() was called
+ * @param data the data given to anytimeSolve()
+ * @returns false to stop the search
+ */
+typedef bool (*solveCallback)(move * solution, long elapsed, void * data);
 
 /**
  * Cheats to solve the cube
@@ -19,7 +42,74 @@ move * fakeSolve(move * initSequence, mvstack history);
 
 /**
  *  Solve the cube using the simplified Fridrich’s method
+ *
+ *  The cube is not modified, and no state is shared between calls, so several
+ *  cubes may be solved at once from different threads. The moves found are
+ *  checked on a copy of the cube : the solver exits if they do not solve it.
+ *
+ *  @returns the moves, terminated by -1, to be freed by the caller
  */
 move * trueSolve(cube * self);
 
+/**
+ *  Solve the cube from the cross of each colour, and keep the shortest
+ *
+ *  The colours of the cube are turned so that each colour in turn becomes
+ *  white, as by a rotation of the whole cube, and the 6 cubes are solved with
+ *  the steps of trueSolve() : the white one by the calling thread, the others
+ *  by a pool of threads started by the first call and shared by all the calls.
+ *  The moves of each one solve the original cube, which is checked. A step
+ *  which is stuck only stops the solving of its colour, and the moves of its
+ *  steps are freed.
+ *
+ *  The cube is not modified. Each solution is checked on a copy of the cube,
+ *  and the solver exits if none of the colours gives one solving it, as
+ *  trueSolve() does.
+ *
+ *  @returns the shortest solution which solves the cube, terminated by -1, to
+ *   be freed by the caller
+ */
+move * neutralSolve(cube * self);
+
+/**
+ *  Solve the cube at once, then look for shorter solutions until a deadline
+ *
+ *  The solution of neutralSolve() is given to the callback at once. It is then
+ *  shortened : the rotations of the whole cube are removed, the moves
+ *  cancelling each other are merged, and the solution is searched for parts
+ *  which can be skipped with 1 move, then with 2 moves and so on up to
+ *  SOLVE_REPAIR_DEPTH moves (see repairSolvePath()). Every solution strictly
+ *  shorter than the previous one is given to the callback. The solutions
+ *  found may leave the cube in any orientation.
+ *
+ *  @param self the cube, which is not modified
+ *  @param deadline the time allowed to the search, in microseconds
+ *  @param callback the function called with each solution, may be NULL
+ *  @param data given to the callback
+ *  @param cancel if not NULL, the search stops as soon as it is not 0, as when
+ *   it is set from another thread
+ *
+ *  @returns the shortest solution found, terminated by -1, to be freed by the
+ *   caller
+ */
+move * anytimeSolve(cube * self, long deadline, solveCallback callback, void * data, volatile int * cancel);
+
+/**
+ *  Find the moves leading from a cube to another one
+ *
+ *  The relative cube of the two cubes (see relativeCube()) is solved with
+ *  anytimeSolve(), then the rotations turning the cube as the second one are
+ *  appended, so the two cubes are equal orientation included once the moves
+ *  are applied to the first one. It is used to set up a pattern from any
+ *  position.
+ *
+ *  @param from the cube to start from, which is not modified
+ *  @param to the cube to reach
+ *  @param deadline the time allowed to shorten the moves, in microseconds
+ *
+ *  @returns the moves, terminated by -1, to be freed by the caller, or NULL if
+ *   the two cubes do not have the same stickers
+ */
+move * solveBetween(cube * from, cube * to, long deadline);
+
 #endif
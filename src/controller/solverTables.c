@@ -0,0 +1,147 @@
+/**
+ * @file solverTables.c
+ */
+
+#include "solverTables.h"
+
+const char redressedCenters[] = "gbrowy";
+
+const char crossColours[] = "grob";
+
+const move sideFaces[TABLE_SLOTS + 1] = {F, R, B, L, F};
+
+const move faceMoves[TABLE_FACE_MOVES] = {
+    F, B, R, L, U, D, Fi, Bi, Ri, Li, Ui, Di, F2, B2, R2, L2, U2, D2
+};
+
+void listFacelets(tile * corners, tile * edges) {
+    int cornerCount = 0, edgeCount = 0;
+    for (int face = F ; face <= D ; face++) {
+        for (int row = 0 ; row < 3 ; row++) {
+            for (int col = 0 ; col < 3 ; col++) {
+                tile facelet = {face, row, col};
+                if (corners && isCorner(facelet)) {
+                    corners[cornerCount++] = facelet;
+                }
+                if (edges && isEdge(facelet)) edges[edgeCount++] = facelet;
+            }
+        }
+    }
+}
+
+int faceletIndex(const tile * facelets, int size, tile facelet) {
+    for (int index = 0 ; index < size ; index++) {
+        if (facelets[index].face == facelet.face
+                && facelets[index].row == facelet.row
+                && facelets[index].col == facelet.col) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+void labelledMoves(const move * moves, int count, tile destinations[54]) {
+    cube * labelled = initCube();
+    for (int face = F ; face <= D ; face++) {
+        for (int row = 0 ; row < 3 ; row++) {
+            for (int col = 0 ; col < 3 ; col++) {
+                labelled->cube[face][row][col] = face * 9 + row * 3 + col;
+            }
+        }
+    }
+    for (int index = 0 ; index < count ; index++) {
+        labelled->rotate(labelled, moves[index]);
+    }
+    for (int face = F ; face <= D ; face++) {
+        for (int row = 0 ; row < 3 ; row++) {
+            for (int col = 0 ; col < 3 ; col++) {
+                tile reached = {face, row, col};
+                destinations[(int) labelled->cube[face][row][col]] = reached;
+            }
+        }
+    }
+    destroyCube(labelled);
+}
+
+void faceletMoves(const tile * facelets, int size, const move * moves,
+        int count, unsigned char * moved) {
+    tile destinations[54];
+    labelledMoves(moves, count, destinations);
+    for (int index = 0 ; index < size ; index++) {
+        tile facelet = facelets[index];
+        moved[index] = faceletIndex(facelets, size, destinations[facelet.face
+                * 9 + facelet.row * 3 + facelet.col]);
+    }
+}
+
+/**
+ * Returns the colour of the other facelet of an edge
+ */
+static char edgePartner(cube * aCube, tile facelet) {
+    return getColorTile(aCube, getAdjacentTiles(facelet).tiles[0]);
+}
+
+int readCrossEdge(cube * aCube, const tile * edges, int edge) {
+    int index = 0;
+    while (getColorTile(aCube, edges[index]) != 'w'
+            || edgePartner(aCube, edges[index]) != crossColours[edge]) {
+        index++;
+    }
+    return index;
+}
+
+void readPair(cube * aCube, const tile * corners, const tile * edges,
+        const char * colours, int * corner, int * edge) {
+    char first = colours[0];
+    char second = colours[1];
+    *corner = 0;
+    while (true) {
+        adjacentTiles others = getAdjacentTiles(corners[*corner]);
+        char left = getColorTile(aCube, others.tiles[0]);
+        char right = getColorTile(aCube, others.tiles[1]);
+        if (getColorTile(aCube, corners[*corner]) == 'w'
+                && ((left == first && right == second)
+                    || (left == second && right == first))) {
+            break;
+        }
+        (*corner)++;
+    } // The white facelet of the corner
+
+    *edge = 0;
+    while (getColorTile(aCube, edges[*edge]) != first
+            || edgePartner(aCube, edges[*edge]) != second) {
+        (*edge)++;
+    } // The facelet of the first colour of the edge
+}
+
+void slotColours(cube * solved, char colours[TABLE_SLOTS][2]) {
+    for (int slot = 0 ; slot < TABLE_SLOTS ; slot++) {
+        colours[slot][0] = solved->cube[sideFaces[slot]][1][1];
+        colours[slot][1] = solved->cube[sideFaces[slot + 1]][1][1];
+    }
+}
+
+void redressedFaces(cube * aCube, int faces[6]) {
+    for (int face = F ; face <= D ; face++) {
+        faces[face] = F;
+        while (aCube->cube[faces[face]][1][1] != redressedCenters[face]) {
+            faces[face]++;
+        }
+    }
+}
+
+move unredressMove(const int * faces, move redressed) {
+    return redressed - redressed % 15 + faces[redressed % 15];
+}
+
+void * lazyTable(void * _Atomic * shared, void * (*build)(void)) {
+    void * table = atomic_load(shared);
+    if (table) return table;
+
+    void * built = build();
+    if (atomic_compare_exchange_strong(shared, &table, built)) {
+        return built;
+    } // Another thread built it first
+    free(built);
+    return table;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file solverTables.h
+ * Facelets, moves and states shared by the tables of the solver
+ *
+ * The tables of crossTable.c, pairTable.c, xcrossSearch.c and lastLayerTable.c
+ * follow facelets rather than colours : a list of facelets, such as the 24
+ * facelets of the edges, and for each move the facelet of the list where each
+ * facelet goes. These lists and moves are found by labelling the facelets of
+ * a cube with their index and turning it.
+ *
+ * The states are read on a cube redressed with green on front and white on
+ * top, or turned with yellow up for the pairs, and the moves found on the
+ * redressed cube are played on the faces of the same centers.
+ *
+ * The tables are built at the first call and shared by the threads, see
+ * lazyTable().
+ */
+
+#ifndef SOLVER_TABLES_H
+#define SOLVER_TABLES_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "../model/cube.h"
+#include "../model/cubelet.h"
+
+#define TABLE_FACELETS 24       /**< Facelets of the corners, or of the edges */
+#define TABLE_FACE_MOVES 18     /**< The quarter and half turns of the faces */
+#define TABLE_SLOTS 4           /**< Slots of the first two layers */
+
+extern const char redressedCenters[];   /**< "gbrowy", centers of the faces of
+                                          the redressed cube */
+extern const char crossColours[];       /**< "grob", the 4 white edges in the
+                                          order of the cross states */
+extern const move sideFaces[];          /**< F, R, B, L, F : the slot k is
+                                          between the faces k and k + 1 */
+extern const move faceMoves[];          /**< The TABLE_FACE_MOVES moves */
+
+/**
+ * Lists the facelets of the corners and of the edges, face after face and row
+ * by row
+ *
+ * @param corners set with the TABLE_FACELETS facelets of the corners, or NULL
+ * @param edges set with the TABLE_FACELETS facelets of the edges, or NULL
+ */
+void listFacelets(tile * corners, tile * edges);
+
+/**
+ * Returns the index of a facelet in a list, -1 if it is not in the list
+ */
+int faceletIndex(const tile * facelets, int size, tile facelet);
+
+/**
+ * Returns the facelet where moves bring each facelet of a cube
+ *
+ * @param moves the moves played
+ * @param count the number of moves
+ * @param destinations set with the facelet reached from the facelet i of the
+ *  face f, row r, column c, at the index f * 9 + r * 3 + c
+ */
+void labelledMoves(const move * moves, int count, tile destinations[54]);
+
+/**
+ * Returns where moves bring the facelets of a list, which the moves keep
+ *
+ * @param facelets the list of facelets
+ * @param size the number of facelets of the list
+ * @param moves the moves played
+ * @param count the number of moves
+ * @param moved set with the index in the list of the facelet reached from
+ *  each facelet of the list
+ */
+void faceletMoves(const tile * facelets, int size, const move * moves,
+        int count, unsigned char * moved);
+
+/**
+ * Returns the place of a white edge of the cross
+ *
+ * @param aCube the cube
+ * @param edges the facelets of the edges, see listFacelets()
+ * @param edge the edge, its colour being crossColours[edge]
+ * @returns the index in edges of its white facelet
+ */
+int readCrossEdge(cube * aCube, const tile * edges, int edge);
+
+/**
+ * Returns the places of the corner and of the edge of a pair
+ *
+ * @param aCube the cube
+ * @param corners the facelets of the corners, see listFacelets()
+ * @param edges the facelets of the edges, see listFacelets()
+ * @param colours the colours of the sides of the slot of the pair
+ * @param corner set with the index in corners of the white facelet of the
+ *  corner
+ * @param edge set with the index in edges of the facelet of the first colour
+ *  of the edge
+ */
+void readPair(cube * aCube, const tile * corners, const tile * edges,
+        const char * colours, int * corner, int * edge);
+
+/**
+ * Returns the colours of the sides of each slot of a solved cube
+ *
+ * @param solved the solved cube, in the orientation of the states
+ * @param colours set with the colours of the faces sideFaces[k] and
+ *  sideFaces[k + 1] for each slot k
+ */
+void slotColours(cube * solved, char colours[TABLE_SLOTS][2]);
+
+/**
+ * Returns the face of a cube with the center of each face of the redressed
+ * cube
+ *
+ * @param aCube the cube, in any orientation
+ * @param faces set with the face of the center redressedCenters[f] for each
+ *  face f
+ */
+void redressedFaces(cube * aCube, int faces[6]);
+
+/**
+ * Returns the move of a cube playing a move of the redressed cube
+ *
+ * @param faces the faces of the cube, see redressedFaces()
+ * @param redressed the move of the redressed cube
+ */
+move unredressMove(const int * faces, move redressed);
+
+/**
+ * Returns a table, built by the first call
+ *
+ * Threads calling it at once may each build the table : the first one stored
+ * is kept, and the others are freed.
+ *
+ * @param shared the table, NULL until it is built
+ * @param build returns a new table, in a single block freed with free()
+ * @returns the table
+ */
+void * lazyTable(void * _Atomic * shared, void * (*build)(void));
+
+#endif
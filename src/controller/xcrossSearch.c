@@ -0,0 +1,267 @@
+/**
+ * @file xcrossSearch.c
+ */
+
+#include "xcrossSearch.h"
+
+#define XCROSS_FOUND -1     /**< The search reached a cross with a pair */
+#define XCROSS_ABORTED -2   /**< The search ran out of nodes */
+
+/**
+ * The facelets, the moves and the pruning tables, built once
+ */
+typedef struct _xcrossData {
+    tile edges[CROSS_EDGE_FACELETS];    // The facelets of the edges
+    tile corners[CROSS_EDGE_FACELETS];  // The facelets of the corners
+    // The facelet where each move of faceMoves brings each facelet
+    unsigned char edgeMoves[CROSS_MOVES][CROSS_EDGE_FACELETS];
+    unsigned char cornerMoves[CROSS_MOVES][CROSS_EDGE_FACELETS];
+    char colours[XCROSS_SLOTS][2];  // The colours of the sides of each slot
+    // Moves of each pair of a slot with each cross edge
+    unsigned char pairDistances[XCROSS_SLOTS][4][XCROSS_PAIR_SIZE];
+} xcrossData;
+
+/**
+ * A state of the search
+ */
+typedef struct _xcrossState {
+    int cross[4];                   // The white facelets of the cross edges
+    int corners[XCROSS_SLOTS];      // The white facelets of the corners
+    int edges[XCROSS_SLOTS];        // The first facelets of the edges
+} xcrossState;
+
+/**
+ * A search, with the moves played
+ */
+typedef struct _xcrossSearch {
+    xcrossData * data;
+    const unsigned char * crossTable;   // See crossDistances()
+    move path[XCROSS_MAX_DEPTH];        // The indexes of faceMoves played
+    int length;                         // Number of moves of the path found
+    int pairs;                          // Number of pairs to solve
+    long nodes;                         // Nodes left
+} xcrossSearch;
+
+static void * _Atomic sharedData = NULL;
+static atomic_long nodeBudget = XCROSS_NODES;
+static atomic_int pairCount = XCROSS_PAIRS;
+
+/**
+ * Reads the state of a redressed cube
+ */
+static void readState(xcrossData * data, cube * aCube, xcrossState * state) {
+    for (int edge = 0 ; edge < 4 ; edge++) {
+        state->cross[edge] = readCrossEdge(aCube, data->edges, edge);
+    }
+    for (int slot = 0 ; slot < XCROSS_SLOTS ; slot++) {
+        readPair(aCube, data->corners, data->edges, data->colours[slot],
+                &state->corners[slot], &state->edges[slot]);
+    }
+}
+
+/**
+ * Returns the state reached by a move of faceMoves
+ */
+static void applyMove(xcrossData * data, const xcrossState * state,
+        int moveIndex, xcrossState * next) {
+    const unsigned char * edgeMoves = data->edgeMoves[moveIndex];
+    const unsigned char * cornerMoves = data->cornerMoves[moveIndex];
+    for (int index = 0 ; index < 4 ; index++) {
+        next->cross[index] = edgeMoves[state->cross[index]];
+        next->corners[index] = cornerMoves[state->corners[index]];
+        next->edges[index] = edgeMoves[state->edges[index]];
+    }
+}
+
+/**
+ * Returns the index of a pair and a cross edge in the pruning tables
+ */
+static int pairIndex(int corner, int edge, int crossEdge) {
+    return (corner * CROSS_EDGE_FACELETS + edge) * CROSS_EDGE_FACELETS
+        + crossEdge;
+}
+
+/**
+ * Returns a lower bound of the moves left to solve the cross and the pairs of
+ * the search, 0 if they are solved
+ *
+ * Each slot needs at least the largest distance of its pair with a cross edge,
+ * so the cross and k pairs need at least the k-th smallest of these bounds.
+ */
+static int estimate(xcrossSearch * search, const xcrossState * state) {
+    int crossMoves = search->crossTable[((state->cross[0] * CROSS_EDGE_FACELETS
+                + state->cross[1]) * CROSS_EDGE_FACELETS + state->cross[2])
+        * CROSS_EDGE_FACELETS + state->cross[3]];
+    int bounds[XCROSS_SLOTS];
+    for (int slot = 0 ; slot < XCROSS_SLOTS ; slot++) {
+        int moves = crossMoves;
+        for (int edge = 0 ; edge < 4 ; edge++) {
+            int pairMoves = search->data->pairDistances[slot][edge][pairIndex(
+                    state->corners[slot], state->edges[slot],
+                    state->cross[edge])];
+            if (pairMoves > moves) moves = pairMoves;
+        }
+
+        int rank = slot;
+        while (rank > 0 && bounds[rank - 1] > moves) {
+            bounds[rank] = bounds[rank - 1];
+            rank--;
+        }
+        bounds[rank] = moves;
+    } // Sorted
+    return bounds[search->pairs - 1];
+}
+
+/**
+ * Builds the moves of the facelets and the pruning tables
+ */
+static void * buildXCrossData() {
+    xcrossData * data = (xcrossData *) ec_malloc(sizeof(xcrossData));
+    listFacelets(data->corners, data->edges);
+    for (int moveIndex = 0 ; moveIndex < CROSS_MOVES ; moveIndex++) {
+        faceletMoves(data->edges, CROSS_EDGE_FACELETS, &faceMoves[moveIndex],
+                1, data->edgeMoves[moveIndex]);
+        faceletMoves(data->corners, CROSS_EDGE_FACELETS,
+                &faceMoves[moveIndex], 1, data->cornerMoves[moveIndex]);
+    }
+
+    cube * solved = initCube();
+    slotColours(solved, data->colours);
+    xcrossState goal;
+    readState(data, solved, &goal);
+    destroyCube(solved);
+
+    // Breadth-first search of each pair with each cross edge
+    int * queue = (int *) ec_malloc(sizeof(int) * XCROSS_PAIR_SIZE);
+    for (int slot = 0 ; slot < XCROSS_SLOTS ; slot++) {
+        for (int edge = 0 ; edge < 4 ; edge++) {
+            unsigned char * distances = data->pairDistances[slot][edge];
+            memset(distances, CROSS_UNKNOWN, XCROSS_PAIR_SIZE);
+            queue[0] = pairIndex(goal.corners[slot], goal.edges[slot],
+                    goal.cross[edge]);
+            distances[queue[0]] = 0;
+            for (int head = 0, tail = 1 ; head < tail ; head++) {
+                int corner = queue[head]
+                    / (CROSS_EDGE_FACELETS * CROSS_EDGE_FACELETS);
+                int pairEdge = queue[head] / CROSS_EDGE_FACELETS
+                    % CROSS_EDGE_FACELETS;
+                int crossEdge = queue[head] % CROSS_EDGE_FACELETS;
+                for (int moveIndex = 0 ; moveIndex < CROSS_MOVES ;
+                        moveIndex++) {
+                    int next = pairIndex(
+                            data->cornerMoves[moveIndex][corner],
+                            data->edgeMoves[moveIndex][pairEdge],
+                            data->edgeMoves[moveIndex][crossEdge]);
+                    if (distances[next] == CROSS_UNKNOWN) {
+                        distances[next] = distances[queue[head]] + 1;
+                        queue[tail++] = next;
+                    }
+                }
+            }
+        }
+    }
+    free(queue);
+    return data;
+}
+
+/**
+ * Returns the tables, built by the first call
+ */
+static xcrossData * getXCrossData() {
+    return (xcrossData *) lazyTable(&sharedData, buildXCrossData);
+}
+
+/**
+ * Depth-first search bounded by a number of moves
+ *
+ * @returns XCROSS_FOUND, XCROSS_ABORTED, or the smallest number of moves
+ *  over the bound
+ */
+static int searchBound(xcrossSearch * search, const xcrossState * state,
+        int depth, int bound, int lastFace) {
+    int moves = depth + estimate(search, state);
+    if (moves > bound) return moves;
+    if (moves == depth) {
+        search->length = depth;
+        return XCROSS_FOUND;
+    }
+    if (--search->nodes < 0) return XCROSS_ABORTED;
+
+    int next = XCROSS_MAX_DEPTH + 1;
+    for (int moveIndex = 0 ; moveIndex < CROSS_MOVES ; moveIndex++) {
+        int face = faceMoves[moveIndex] % 15;
+        if (face == lastFace || (face == (lastFace ^ 1) && face < lastFace)) {
+            continue;
+        } // Same face twice, or opposite faces in both orders
+
+        xcrossState moved;
+        applyMove(search->data, state, moveIndex, &moved);
+        search->path[depth] = moveIndex;
+        int result = searchBound(search, &moved, depth + 1, bound, face);
+        if (result == XCROSS_FOUND || result == XCROSS_ABORTED) return result;
+        if (result < next) next = result;
+    }
+    return next;
+}
+
+void setXCrossBudget(long nodes) {
+    atomic_store(&nodeBudget, nodes);
+}
+
+void setXCrossPairs(int pairs) {
+    atomic_store(&pairCount, pairs);
+}
+
+move * searchXCross(cube * self, long nodes, int pairs) {
+    xcrossSearch search;
+    search.data = getXCrossData();
+    search.crossTable = crossDistances();
+    search.pairs = pairs;
+    search.nodes = nodes;
+
+    cube * redressed = self->copy(self);
+    redressCube(redressed);
+    xcrossState state;
+    readState(search.data, redressed, &state);
+    destroyCube(redressed);
+
+    int bound = estimate(&search, &state);
+    int result = bound;
+    while (result != XCROSS_FOUND && result != XCROSS_ABORTED
+            && bound <= XCROSS_MAX_DEPTH) {
+        result = searchBound(&search, &state, 0, bound, -1);
+        if (result != XCROSS_FOUND) bound = result;
+    }
+    if (result != XCROSS_FOUND) return NULL;
+
+    int faces[6];
+    redressedFaces(self, faces);
+    move * moves = (move *) ec_malloc(sizeof(move) * (search.length + 1));
+    for (int index = 0 ; index < search.length ; index++) {
+        moves[index] = unredressMove(faces, faceMoves[search.path[index]]);
+    }
+    moves[search.length] = -1;
+    return moves;
+}
+
+char * solveXCross(cube * self) {
+    long nodes = atomic_load(&nodeBudget);
+    int pairs = atomic_load(&pairCount);
+    move * moves = nodes > 0 ? searchXCross(self, nodes, pairs) : NULL;
+    if (!moves && nodes > 0 && pairs > 1) moves = searchXCross(self, nodes, 1);
+    if (!moves) return solveCross(self);
+
+    char * movements = (char *) ec_malloc(sizeof(char) * STEP_MOVES_LENGTH);
+    *movements = '\0';
+    for (int index = 0 ; (int) moves[index] != -1 ; index++) {
+        self->rotate(self, moves[index]);
+        catMoves(movements, mapMoveToCode(moves[index]));
+        catMoves(movements, " ");
+    }
+    free(moves);
+
+    // The next steps start with the cross down, as solveCross() leaves it
+    catPositionCommand(movements, self, 'g', 'y');
+    positionCube(self, 'g', 'y');
+    return movements;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file xcrossSearch.h
+ * White cross and pairs of the first two layers solved together
+ *
+ * An iterative deepening A* search over the 18 face moves looks for the
+ * shortest sequence solving the cross and the pairs of any slots, one pair by
+ * default (see setXCrossPairs()). The cross and a pair are often no longer
+ * than the cross alone. The state is the place of the white facelets of the
+ * cross edges, and for each slot the place of the white facelet of its corner
+ * and of the first facelet of its edge.
+ *
+ * The search is pruned with the distances of the cross (see crossDistances())
+ * and with a table for each slot and each cross edge : the distances of the
+ * pair of the slot together with the cross edge, 24 * 24 * 24 = 13824 states.
+ * A slot needs at least the largest of these distances, so a state needs at
+ * least the k-th smallest bound of the slots to solve k pairs. The bound is
+ * weak for 2 pairs or more : the search of 2 pairs takes about 60 times the
+ * nodes of one pair, and the pairs left are solved by solvePairs().
+ *
+ * The search stops after a budget of nodes : a search of several pairs is then
+ * replaced by a search of one pair, and a search of one pair by the optimal
+ * cross of solveCross().
+ */
+
+#ifndef XCROSS_SEARCH_H
+#define XCROSS_SEARCH_H
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../model/cube.h"
+#include "../model/cubelet.h"
+#include "crossTable.h"
+#include "patternComparator.h"
+#include "solverTables.h"
+#include "utils.h"
+
+#define XCROSS_SLOTS TABLE_SLOTS /**< Slots of the first two layers */
+#define XCROSS_PAIR_SIZE 13824  /**< States of a pair and a cross edge */
+#define XCROSS_MAX_DEPTH 12     /**< Moves bounding the search */
+#define XCROSS_NODES 200000     /**< Default budget of nodes of a search */
+#define XCROSS_PAIRS 1          /**< Default number of pairs of a search */
+
+/**
+ * Sets the budget of nodes of the searches of solveXCross()
+ *
+ * A node costs a fraction of a microsecond, so the default budget bounds a
+ * search to a few tens of milliseconds, while most searches need less than a
+ * thousand nodes. The budget is the same for every thread.
+ *
+ * @param nodes the number of nodes, 0 to only do the cross
+ */
+void setXCrossBudget(long nodes);
+
+/**
+ * Sets the number of pairs searched with the cross by solveXCross()
+ *
+ * Two pairs save about 4 moves on a solution of trueSolve(), for a search
+ * about 60 times longer, a few milliseconds. The number is the same for every
+ * thread.
+ *
+ * @param pairs the number of pairs, from 1 to XCROSS_SLOTS
+ */
+void setXCrossPairs(int pairs);
+
+/**
+ * Searches the shortest cross with some pairs within a budget of nodes
+ *
+ * @param self the cube, which is not modified
+ * @param nodes the budget of nodes of the search
+ * @param pairs the number of pairs, from 1 to XCROSS_SLOTS
+ * @returns the moves, terminated by -1, to be freed, or NULL when the budget
+ *  runs out or when more than XCROSS_MAX_DEPTH moves are needed
+ */
+move * searchXCross(cube * self, long nodes, int pairs);
+
+/**
+ * Does the white cross with the pairs of setXCrossPairs() if the search is
+ * within its budget, with one pair if this search is within a new budget, the
+ * cross alone else, first step of trueSolve()
+ *
+ * The cube is then turned with green on front and yellow up, as solveCross()
+ * leaves it.
+ *
+ * @param self the cube, on which the moves are played
+ * @returns the space separated moves, to be freed
+ */
+char * solveXCross(cube * self);
+
+#endif
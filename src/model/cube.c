@@ -748,6 +748,8 @@ _Bool cubeIsEqual(cube * self, cube * otherCube){
             for(int jindex = 0; jindex < 3 ; jindex++){
                 if (aCube->cube[face][index][jindex] !=
                         bCube->cube[face][index][jindex]){
+                    destroyCube(aCube);
+                    destroyCube(bCube);
                     return false; // If any face of a cubelet does not match
                                   // cubes are not equal
                 }
@@ -0,0 +1,232 @@
+#include "facelets.h"
+#include "../controller/utils.h"
+
+/**
+ * Faces of the facelets string, in order
+ */
+static const move faceletFaces[6] = {U, R, F, D, L, B};
+
+/**
+ * Names of the faces, in the order of faceletFaces
+ */
+static const char faceNames[] = "URFDLB";
+
+/**
+ * Colours of the faces on a solved cube, in the order of faceletFaces
+ */
+static const char faceColours[] = "wrgyob";
+
+/**
+ * Facelets of the 8 corners, the U or D facelet first then clockwise : URF,
+ * UFL, ULB, UBR, DFR, DLF, DBL, DRB
+ */
+static const int cornerFacelets[8][3] = {
+    {8, 9, 20}, {6, 18, 38}, {0, 36, 47}, {2, 45, 11},
+    {29, 26, 15}, {27, 44, 24}, {33, 53, 42}, {35, 17, 51}
+};
+
+/**
+ * Faces of the colours of the 8 corners, in the order of cornerFacelets
+ */
+static const int cornerFaces[8][3] = {
+    {0, 1, 2}, {0, 2, 4}, {0, 4, 5}, {0, 5, 1},
+    {3, 2, 1}, {3, 4, 2}, {3, 5, 4}, {3, 1, 5}
+};
+
+/**
+ * Facelets of the 12 edges : UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR
+ */
+static const int edgeFacelets[12][2] = {
+    {5, 10}, {7, 19}, {3, 37}, {1, 46}, {32, 16}, {28, 25},
+    {30, 43}, {34, 52}, {23, 12}, {21, 41}, {50, 39}, {48, 14}
+};
+
+/**
+ * Faces of the colours of the 12 edges, in the order of edgeFacelets
+ */
+static const int edgeFaces[12][2] = {
+    {0, 1}, {0, 2}, {0, 4}, {0, 5}, {3, 1}, {3, 2},
+    {3, 4}, {3, 5}, {2, 1}, {2, 4}, {5, 4}, {5, 1}
+};
+
+/**
+ * Returns the parity of a permutation, as the parity of its inversions
+ */
+static int permutationParity(const int * permutation, int size) {
+    int inversions = 0;
+    for (int index = 0 ; index < size ; index++) {
+        for (int jindex = index + 1 ; jindex < size ; jindex++) {
+            if (permutation[index] > permutation[jindex]) {
+                inversions++;
+            }
+        }
+    }
+    return inversions % 2;
+}
+
+/**
+ * Checks that the cubelets of the facelets are reachable from a solved cube
+ *
+ * @param faces the face of the colour of each facelet, 0 to 5 in the order of
+ *  faceletFaces
+ * @returns true if the cube can be solved
+ */
+static bool isSolvable(const int * faces) {
+    int corners[8], edges[12];
+    bool seenCorners[8] = {false}, seenEdges[12] = {false};
+    int twist = 0, flip = 0;
+
+    for (int index = 0 ; index < 8 ; index++) {
+        int orientation = 0;
+        while (orientation < 3
+                && faces[cornerFacelets[index][orientation]] != 0
+                && faces[cornerFacelets[index][orientation]] != 3) {
+            orientation++;
+        } // Finding the U or D facelet of the corner
+        if (orientation == 3) return false;
+
+        int corner = 0;
+        while (corner < 8 && (
+                    faces[cornerFacelets[index][orientation]] != cornerFaces[corner][0]
+                    || faces[cornerFacelets[index][(orientation + 1) % 3]] != cornerFaces[corner][1]
+                    || faces[cornerFacelets[index][(orientation + 2) % 3]] != cornerFaces[corner][2])) {
+            corner++;
+        } // Identifying the corner by its colours
+        if (corner == 8 || seenCorners[corner]) return false;
+
+        seenCorners[corner] = true;
+        corners[index] = corner;
+        twist += orientation;
+    }
+
+    for (int index = 0 ; index < 12 ; index++) {
+        int first = faces[edgeFacelets[index][0]];
+        int second = faces[edgeFacelets[index][1]];
+        int edge = 0;
+        while (edge < 12
+                && !(first == edgeFaces[edge][0] && second == edgeFaces[edge][1])
+                && !(first == edgeFaces[edge][1] && second == edgeFaces[edge][0])) {
+            edge++;
+        } // Identifying the edge by its colours
+        if (edge == 12 || seenEdges[edge]) return false;
+
+        seenEdges[edge] = true;
+        edges[index] = edge;
+        flip += first != edgeFaces[edge][0];
+    }
+
+    // A move twists the corners by a multiple of 3, flips an even number of
+    // edges, and swaps as many corners as edges
+    return twist % 3 == 0 && flip % 2 == 0
+        && permutationParity(corners, 8) == permutationParity(edges, 12);
+}
+
+bool setFacelets(cube * self, const char * facelets) {
+    if (!self || !facelets) return false;
+
+    char colours[FACELETS_LENGTH];
+    int counts[6] = {0};
+    for (int index = 0 ; index < FACELETS_LENGTH ; index++) {
+        const char * face = strchr(faceNames, facelets[index]);
+        const char * colour = strchr(faceColours, facelets[index]);
+        if (facelets[index] == '\0' || (!face && !colour)) {
+            return false;
+        } // Unknown facelet, or facelets string too short
+
+        colours[index] = face ? faceColours[face - faceNames] : *colour;
+        counts[strchr(faceColours, colours[index]) - faceColours]++;
+    }
+
+    int centers[6];
+    for (int face = 0 ; face < 6 ; face++) {
+        if (counts[face] != 9) return false;
+        centers[face] = colours[face * 9 + 4];
+        for (int other = 0 ; other < face ; other++) {
+            if (centers[other] == centers[face]) return false;
+        }
+    } // 9 facelets of each colour, and 6 centers of different colours
+
+    int faces[FACELETS_LENGTH];
+    for (int index = 0 ; index < FACELETS_LENGTH ; index++) {
+        int face = -1;
+        while (centers[++face] != colours[index]);
+        faces[index] = face;
+    } // The faces are given by the colours of the centers
+
+    if (!isSolvable(faces)) return false;
+
+    for (int index = 0 ; index < FACELETS_LENGTH ; index++) {
+        self->cube[faceletFaces[index / 9]][index % 9 / 3][index % 3] =
+            colours[index];
+    }
+    return true;
+}
+
+char * cubeToFacelets(cube * self) {
+    char * facelets = (char *) ec_malloc(sizeof(char) * (FACELETS_LENGTH + 1));
+    for (int index = 0 ; index < FACELETS_LENGTH ; index++) {
+        facelets[index] =
+            self->cube[faceletFaces[index / 9]][index % 9 / 3][index % 3];
+    }
+    facelets[FACELETS_LENGTH] = '\0';
+    return facelets;
+}
+
+/**
+ * Identifies each sticker of a cube by its colour followed by the colours of
+ * the other stickers of its cubelet, clockwise for the corners
+ *
+ * @param facelets the 54 facelets of the cube, as colours
+ * @param stickers the 54 keys, set in the order of the facelets
+ */
+static void faceletStickers(const char * facelets, int * stickers) {
+    for (int face = 0 ; face < 6 ; face++) {
+        stickers[face * 9 + 4] = facelets[face * 9 + 4];
+    }
+    for (int index = 0 ; index < 12 ; index++) {
+        const int * edge = edgeFacelets[index];
+        for (int side = 0 ; side < 2 ; side++) {
+            stickers[edge[side]] =
+                (facelets[edge[side]] << 8) | facelets[edge[1 - side]];
+        }
+    }
+    for (int index = 0 ; index < 8 ; index++) {
+        const int * corner = cornerFacelets[index];
+        for (int side = 0 ; side < 3 ; side++) {
+            stickers[corner[side]] = (facelets[corner[side]] << 16)
+                | (facelets[corner[(side + 1) % 3]] << 8)
+                | facelets[corner[(side + 2) % 3]];
+        }
+    }
+}
+
+cube * relativeCube(cube * from, cube * to) {
+    if (!from || !to) return NULL;
+
+    char * fromFacelets = cubeToFacelets(from);
+    char * toFacelets = cubeToFacelets(to);
+    int fromStickers[FACELETS_LENGTH], toStickers[FACELETS_LENGTH];
+    faceletStickers(fromFacelets, fromStickers);
+    faceletStickers(toFacelets, toStickers);
+    free(fromFacelets);
+    free(toFacelets);
+
+    char relative[FACELETS_LENGTH];
+    for (int index = 0 ; index < FACELETS_LENGTH ; index++) {
+        int target = 0;
+        while (target < FACELETS_LENGTH
+                && toStickers[target] != fromStickers[index]) {
+            target++;
+        } // Finding the sticker on the second cube
+        if (target == FACELETS_LENGTH) return NULL;
+
+        relative[index] = faceColours[target / 9];
+    } // Each sticker takes the colour of the face it has to reach
+
+    cube * relativeCube = initCube();
+    if (!setFacelets(relativeCube, relative)) {
+        destroyCube(relativeCube);
+        return NULL;
+    } // Cubes with different stickers
+    return relativeCube;
+}
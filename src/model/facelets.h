@@ -0,0 +1,75 @@
+/**
+ * @file facelets.h
+ *
+ * Conversions between a cube and its 54 facelets, as exchanged with other
+ * solvers.
+ *
+ * The facelets are given face after face in the order U, R, F, D, L, B, each
+ * face row by row as on the net printed by printCube() :
+ *
+ *              |U1|U2|U3|
+ *              |U4|U5|U6|
+ *              |U7|U8|U9|
+ *     |L1|L2|L3||F1|F2|F3||R1|R2|R3||B1|B2|B3|
+ *     |L4|L5|L6||F4|F5|F6||R4|R5|R6||B4|B5|B6|
+ *     |L7|L8|L9||F7|F8|F9||R7|R8|R9||B7|B8|B9|
+ *              |D1|D2|D3|
+ *              |D4|D5|D6|
+ *              |D7|D8|D9|
+ *
+ * A facelet is either the colour of the sticker ('w', 'r', 'g', 'y', 'o' or
+ * 'b') or the face of its colour ('U', 'R', 'F', 'D', 'L' or 'B'), so the
+ * solved cube is "UUUUUUUUURRRRRRRRRFFFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB".
+ */
+
+#ifndef FACELETS_H
+#define FACELETS_H
+
+#include <stdbool.h>
+#include <string.h>
+#include "cube.h"
+
+#define FACELETS_LENGTH 54  /**< Number of facelets of a cube */
+
+/**
+ * Sets the colours of a cube from its facelets
+ *
+ * The facelets are checked before changing the cube : there must be 9 facelets
+ * of each colour, the centers of different colours, and the cubelets must be
+ * reachable from a solved cube (a cube with a twisted corner or a flipped edge
+ * cannot be solved).
+ *
+ * @param self pointer to the cube to set
+ * @param facelets the 54 facelets, any following char is ignored
+ *
+ * @returns true if the facelets were valid, false else and the cube is not
+ *  modified
+ */
+bool setFacelets(cube * self, const char * facelets);
+
+/**
+ * Returns the facelets of a cube, as colours
+ *
+ * @param self pointer to the cube
+ *
+ * @returns a string of FACELETS_LENGTH chars, to be freed by the caller
+ */
+char * cubeToFacelets(cube * self);
+
+/**
+ * Returns the cube whose solution leads from a cube to another one
+ *
+ * Each sticker of the first cube is coloured with the colour, on a solved
+ * cube, of the face where the same sticker is on the second cube. Solving the
+ * relative cube thus brings each sticker of the first cube where it is on the
+ * second one, up to a rotation of the whole cube. The relative cube is
+ * B^-1 * A, with A and B the permutations of the stickers of the two cubes.
+ *
+ * @param from pointer to the cube to start from
+ * @param to pointer to the cube to reach
+ *
+ * @returns a new cube, or NULL if the two cubes do not have the same stickers
+ */
+cube * relativeCube(cube * from, cube * to);
+
+#endif
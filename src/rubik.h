@@ -0,0 +1,125 @@
+/**
+ * @file rubik.h
+ * The API of librubik : the cube model and its facelets, the command parser,
+ * the move queues, the sessions, the solver and its cache
+ *
+ * librubik does not depend on SDL nor on OpenGL, so it can be used without any
+ * display, as on a solve server. The game links the view on top of it.
+ *
+ * Typical use :
+ *
+ *     cube * aCube = initCube();
+ *     move * scramble = commandParser("R U Ri Ui");
+ *     executeBulkCommand(aCube, scramble);
+ *     move * solution = trueSolve(aCube);
+ *
+ * The arrays of moves returned are terminated by a move == -1 and must be
+ * freed by the caller. Errors on bad inputs (as an uninitialized queue) exit
+ * the program through exitFatal().
+ *
+ * Only the entry points of the solver are declared here, the steps and the
+ * tables behind them being internal to the library. The tools which tune them
+ * include their headers from src/controller.
+ */
+
+#ifndef RUBIK_H
+#define RUBIK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "model/cube.h"
+#include "model/facelets.h"
+#include "controller/commandQueue.h"
+#include "controller/commandParser.h"
+#include "controller/session.h"
+
+/**
+ * Function called by anytimeSolve() with each solution found
+ *
+ * @param solution the moves, terminated by -1, only valid during the call
+ * @param elapsed the microseconds since anytimeSolve() was called
+ * @param data the data given to anytimeSolve()
+ * @returns false to stop the search
+ */
+typedef bool (*solveCallback)(move * solution, long elapsed, void * data);
+
+/**
+ * A cache of solutions, see solveCache.h
+ */
+typedef struct _solveCache solveCache;
+
+/**
+ * Solves the cube from the white cross
+ *
+ * @param self the cube, which is not modified
+ * @returns the moves, to be freed
+ */
+move * trueSolve(cube * self);
+
+/**
+ * Solves the cube from the cross of each colour and keeps the shortest
+ * solution
+ *
+ * @param self the cube, which is not modified
+ * @returns the moves, to be freed
+ */
+move * neutralSolve(cube * self);
+
+/**
+ * Solves the cube at once, then looks for shorter solutions until a deadline
+ *
+ * @param self the cube, which is not modified
+ * @param deadline the time allowed to the search, in microseconds
+ * @param callback the function called with each solution, may be NULL
+ * @param data given to the callback
+ * @param cancel if not NULL, the search stops as soon as it is not 0
+ * @returns the shortest solution found, to be freed
+ */
+move * anytimeSolve(cube * self, long deadline, solveCallback callback, void * data, volatile int * cancel);
+
+/**
+ * Finds the moves leading from a cube to another one, orientation included
+ *
+ * @param from the cube to start from, which is not modified
+ * @param to the cube to reach
+ * @param deadline the time allowed to shorten the moves, in microseconds
+ * @returns the moves, to be freed, or NULL if the two cubes do not have the
+ *  same stickers
+ */
+move * solveBetween(cube * from, cube * to, long deadline);
+
+/**
+ * Creates a cache of solutions, loading its file if it exists
+ *
+ * @param maxBytes - Memory allowed for the entries
+ * @param path - The file of the cache, NULL for a cache only in memory
+ */
+solveCache * initSolveCache(size_t maxBytes, const char * path);
+
+/**
+ * Returns the solution of a cube from the cache, or NULL if it is not there
+ */
+move * lookupSolveCache(solveCache * self, cube * aCube);
+
+/**
+ * Stores the solution of a cube, ignored if it does not solve the cube
+ */
+void storeSolveCache(solveCache * self, cube * aCube, move * solution);
+
+/**
+ * Returns the solution of a cube from the cache, or from neutralSolve()
+ * stored in the cache
+ */
+move * cachedSolve(solveCache * self, cube * aCube);
+
+/**
+ * Writes the cache to its file, returns false if it cannot
+ */
+bool saveSolveCache(solveCache * self);
+
+/**
+ * Frees the cache, without saving it
+ */
+void freeSolveCache(solveCache * self);
+
+#endif
@@ -6,10 +6,46 @@
 #include "animations.h"
 
 
-animationStack * generateAnimationStack(Mix_Chunk * sound) {
-  animationStack * returnedStack;
-  returnedStack = (animationStack *)malloc(sizeof(animationStack));
-  returnedStack->animations = NULL;
+animationQueue * generateAnimationQueue() {
+  animationQueue * animQueue;
+  animQueue = (animationQueue *)malloc(sizeof(animationQueue));
+  animQueue->head = NULL;
+  animQueue->tail = NULL;
+  animQueue->count = 0;
+  animQueue->deadline = 0;
+  animQueue->foldDebt = 0;
+
+  /* Chain all the stacks of the pool in the free list */
+  animQueue->freeStacks = NULL;
+  for (int stackIndex = ANIMATION_POOL_SIZE - 1; stackIndex >= 0; stackIndex--) {
+    animQueue->pool[stackIndex].next = animQueue->freeStacks;
+    animQueue->freeStacks = &animQueue->pool[stackIndex];
+  }
+
+  return animQueue;
+}
+
+
+void clearAnimationQueue(animationQueue * animQueue) {
+  while (animQueue->head != NULL) {
+    removeAnimationStack(animQueue);
+  }
+  animQueue->deadline = 0;
+  animQueue->foldDebt = 0;
+}
+
+
+animationStack * generateAnimationStack(animationQueue * animQueue, rubikcube * rubikCube, Mix_Chunk * sound) {
+  /* No stack left : the oldest move is played instantly to free its stack */
+  if (animQueue->freeStacks == NULL) {
+    finishAnimationStack(animQueue->head, rubikCube);
+    removeAnimationStack(animQueue);
+  }
+
+  animationStack * returnedStack = animQueue->freeStacks;
+  animQueue->freeStacks = returnedStack->next;
+
+  returnedStack->animationCount = 0;
   returnedStack->next = NULL;
   returnedStack->sound = sound;
 
@@ -23,96 +59,137 @@ animationStack * generateAnimationStack(Mix_Chunk * sound) {
 }
 
 
-void addAnimationStack(animationStack ** animStack, animationStack * toAdd) {
-  animationStack * currentAnimationStack = *animStack;
-  if (currentAnimationStack == NULL) {
-    *animStack = toAdd;
+void addAnimationStack(animationQueue * animQueue, animationStack * toAdd) {
+  toAdd->next = NULL;
+  if (animQueue->tail == NULL) {
+    animQueue->head = toAdd;
   } else {
-    while (currentAnimationStack->next != NULL) {
-      currentAnimationStack = currentAnimationStack->next;
-    }
-    currentAnimationStack->next = toAdd;
+    animQueue->tail->next = toAdd;
   }
+  animQueue->tail = toAdd;
+  animQueue->count++;
 }
 
 
-void removeAnimationStack(animationStack ** animStack, animationStack * toRemove) {
-  animationStack * currentAnimation = *animStack;
-  if (currentAnimation == toRemove) {
-    if (currentAnimation->next != NULL) {
-      *animStack = currentAnimation->next;
-    }
-    else {
-      *animStack = NULL;
-    }
-    Mix_HaltChannel(0);
-    free(toRemove);
-  }
-  while (currentAnimation != NULL) {
-    if (currentAnimation->next == toRemove) {
-      currentAnimation->next = toRemove->next;
-      updateAnimationList(&toRemove->animations);
-      Mix_HaltChannel(0);
-      free(toRemove);
-      break;
-    }
-    currentAnimation = currentAnimation->next;
+void removeAnimationStack(animationQueue * animQueue) {
+  animationStack * toRemove = animQueue->head;
+  if (toRemove == NULL) {
+    return;
+  }
+
+  animQueue->head = toRemove->next;
+  if (animQueue->head == NULL) {
+    animQueue->tail = NULL;
   }
+  animQueue->count--;
+  Mix_HaltChannel(0);
+
+  /* Give the stack back to the pool */
+  toRemove->next = animQueue->freeStacks;
+  animQueue->freeStacks = toRemove;
 }
 
 
-int animationStackCount(animationStack * animStack) {
-  int count = 0;
-  if (animStack != NULL) {
-    animationStack * currentAnimationStack = animStack;
-    while (currentAnimationStack != NULL) {
-      count++;
-      currentAnimationStack = currentAnimationStack->next;
+int animationStackCount(animationQueue * animQueue) {
+  return animQueue->count;
+}
+
+
+void updateAnimationStack(animationStack * self, rubikcube * rubikCube, Uint32 now) {
+  self->isFinished = true;
+  for (int animationIndex = 0; animationIndex < self->animationCount; animationIndex++) {
+    animation * animationsPtr = &self->animations[animationIndex];
+    if (animationsPtr->isActive) {
+      animationsPtr->update(animationsPtr, rubikCube, now);
     }
+    self->isFinished = animationsPtr->isActive ? false : self->isFinished;
   }
-  return count;
 }
 
 
-void updateAnimationStack(animationStack * self, rubikcube * rubikCube) {
-  animation * animationsPtr = self->animations;
+void finishAnimationStack(animationStack * self, rubikcube * rubikCube) {
+  for (int animationIndex = 0; animationIndex < self->animationCount; animationIndex++) {
+    animation * animationsPtr = &self->animations[animationIndex];
+    if (animationsPtr->isActive) {
+      animationsPtr->duration = 0;
+      animationsPtr->update(animationsPtr, rubikCube, animationsPtr->startTime);
+    }
+  }
   self->isFinished = true;
-  while (animationsPtr != NULL) {
-    animationsPtr->update(animationsPtr, rubikCube);
-    self->isFinished = animationsPtr->isActive ? false : self->isFinished;
-    animationsPtr = animationsPtr->next;
+}
+
+
+void scheduleAnimationQueue(animationQueue * animQueue, rubikcube * rubikCube, int pendingMoves, Uint32 now) {
+  int backlog = animQueue->count + pendingMoves;
+  animQueue->foldDebt = 0;
+  if (animQueue->deadline == 0 || (Sint32)(animQueue->deadline - now) <= 0) {
+    if (backlog == 0 || backlog * ANIMATION_DURATION <= PLAYBACK_BUDGET) {
+      animQueue->deadline = 0;
+      return;
+    } // Short backlog : normal speed
+    animQueue->deadline = now + PLAYBACK_BUDGET;
+  } // Start an accelerated playback that must end before the deadline
+
+  /* Share the time left between all the moves of the backlog */
+  Uint32 remaining = animQueue->deadline - now;
+  Uint32 duration = backlog ? remaining / backlog : ANIMATION_DURATION;
+  if (duration >= ANIMATION_DURATION) {
+    animQueue->deadline = 0;
+    return;
+  } // Caught up
+
+  /* Fold the moves that can't fit in the time left, the oldest ones first :
+   * the queued ones now, the pending ones once they are queued */
+  if (duration < MIN_ANIMATION_DURATION) {
+    animQueue->foldDebt = backlog - remaining / MIN_ANIMATION_DURATION;
+    while (animQueue->foldDebt > 0 && animQueue->head != NULL) {
+      finishAnimationStack(animQueue->head, rubikCube);
+      removeAnimationStack(animQueue);
+      animQueue->foldDebt--;
+    }
+    duration = MIN_ANIMATION_DURATION;
+  }
+  if (animQueue->head == NULL) {
+    return;
+  } // Everything queued was folded
+
+  /* Speed up the move being played */
+  animationStack * head = animQueue->head;
+  for (int animationIndex = 0; animationIndex < head->animationCount; animationIndex++) {
+    if (head->animations[animationIndex].duration > duration) {
+      head->animations[animationIndex].duration = duration;
+    }
   }
 }
 
 
-animation * generateAnimation(enum FaceType animatedFace, int sliceIndex, float increment, bool ccw, void (* onFinished)(rubikcube * cube, int sliceIndex, bool ccw)) {
-  animation * returnedAnimation;
-  returnedAnimation = (animation *)malloc(sizeof(animation));
+animation generateAnimation(enum FaceType animatedFace, int sliceIndex, Uint32 duration, bool ccw, void (* onFinished)(rubikcube * cube, int sliceIndex, bool ccw)) {
+  animation returnedAnimation;
 
-  returnedAnimation->currentStep = 0;
-  returnedAnimation->targetStep = roundf((PI / 2.0) / increment);
-  returnedAnimation->animatedFace = animatedFace;
-  returnedAnimation->isActive = false;
-  returnedAnimation->sliceIndex = sliceIndex;
-  returnedAnimation->rotationAngle = increment;
-  returnedAnimation->next = NULL;
-  returnedAnimation->ccw = ccw;
+  returnedAnimation.startTime = 0;
+  returnedAnimation.duration = duration;
+  returnedAnimation.appliedAngle = 0;
+  returnedAnimation.animatedFace = animatedFace;
+  returnedAnimation.isActive = false;
+  returnedAnimation.sliceIndex = sliceIndex;
+  returnedAnimation.ccw = ccw;
 
-  returnedAnimation->onFinished = onFinished;
+  returnedAnimation.update = &updateAnimation;
+  returnedAnimation.onFinished = onFinished;
 
   switch(animatedFace) {
     case TOP:
     case DOWN:
-      returnedAnimation->update = &animateZ;
+      returnedAnimation.axis = Z_AXIS;
       break;
     case RIGHT:
     case LEFT:
     case MIDDLE:
-      returnedAnimation->update = &animateX;
+      returnedAnimation.axis = X_AXIS;
       break;
     case FRONT:
     case BACK:
-      returnedAnimation->update = &animateY;
+      returnedAnimation.axis = Y_AXIS;
       break;
   }
 
@@ -120,99 +197,70 @@ animation * generateAnimation(enum FaceType animatedFace, int sliceIndex, float
 }
 
 
-void addAnimation(animation ** animations, animation * toAdd) {
-  animation * currentAnimation = *animations;
-  if (currentAnimation == NULL) {
-    *animations = toAdd;
-  } else {
-    while (currentAnimation->next != NULL) {
-      currentAnimation = currentAnimation->next;
-    }
-    currentAnimation->next = toAdd;
-  }
-  toAdd->isActive = true;
+void addAnimation(animationStack * animStack, animation toAdd) {
+  if (animStack->animationCount == STACK_ANIMATIONS) {
+    return;
+  } // A move never turns more than 3 slices
+  toAdd.isActive = true;
+  animStack->animations[animStack->animationCount++] = toAdd;
 }
 
 
-void removeAnimation(animation ** animations, animation * toRemove) {
-  animation * currentAnimation = *animations;
-  if (currentAnimation == toRemove) {
-    *animations = NULL;
-  }
-  while (currentAnimation != NULL) {
-    if (currentAnimation->next == toRemove) {
-      currentAnimation->next = toRemove->next;
-      free(toRemove);
-      break;
-    }
-    currentAnimation = currentAnimation->next;
+/**
+ * Return a cube of the slice of an animation
+ * @param self      The animation
+ * @param rubikCube The rubikcube being animated
+ * @param first     First index of the cube in the slice
+ * @param second    Second index of the cube in the slice
+ */
+static cube3d * sliceCube(animation * self, rubikcube * rubikCube, int first, int second) {
+  switch (self->axis) {
+    case X_AXIS:
+      return rubikCube->cubes[self->sliceIndex][first][second];
+    case Y_AXIS:
+      return rubikCube->cubes[first][self->sliceIndex][second];
+    default:
+      return rubikCube->cubes[first][second][self->sliceIndex];
   }
 }
 
 
-void updateAnimationList(animation ** animations) {
-  animation * currentAnimation = *animations;
-  while (currentAnimation != NULL) {
-    if (!currentAnimation->isActive) {
-      removeAnimation(animations, currentAnimation);
-    }
-    currentAnimation = currentAnimation->next;
+void updateAnimation(animation * self, rubikcube * rubikCube, Uint32 now) {
+  /* Progress of the animation, between 0 and 1 */
+  float progress = 1;
+  if (self->duration > 0 && now - self->startTime < self->duration) {
+    progress = (float)(now - self->startTime) / self->duration;
   }
-}
-
 
-void animateX(animation * self, rubikcube * rubikCube) {
-  if (self->currentStep == self->targetStep) {
-    self->isActive = false;
-    self->onFinished(rubikCube, self->sliceIndex, self->ccw);
-  } else {
-    for (int xIndex = 0; xIndex < 3; xIndex++) {
-      for (int yIndex = 0; yIndex < 3; yIndex++) {
-        for (int faceIndex = 0; faceIndex < 6; faceIndex++) {
-          rotateFaceX(&rubikCube->cubes[self->sliceIndex][xIndex][yIndex]->faces[faceIndex], self->rotationAngle, self->ccw);
-        }
+  /* One rotation matrix for the angle travelled since the last update */
+  float angle = progress * (PI / 2) - self->appliedAngle;
+  if (angle > 0) {
+    GLfloat rotation[16];
+    generateRotationMatrix(rotation, self->axis, angle, self->ccw);
+    for (int first = 0; first < 3; first++) {
+      for (int second = 0; second < 3; second++) {
+        rotateCube(sliceCube(self, rubikCube, first, second), rotation);
       }
     }
-    self->currentStep++;
+    self->appliedAngle += angle;
   }
-}
-
 
-void animateY(animation * self, rubikcube * rubikCube) {
-  if (self->currentStep == self->targetStep) {
+  if (progress >= 1) {
     self->isActive = false;
-    self->onFinished(rubikCube, self->sliceIndex, self->ccw);
-  } else {
-    for (int xIndex = 0; xIndex < 3; xIndex++) {
-      for (int yIndex = 0; yIndex < 3; yIndex++) {
-        for (int faceIndex = 0; faceIndex < 6; faceIndex++) {
-          rotateFaceY(&rubikCube->cubes[xIndex][self->sliceIndex][yIndex]->faces[faceIndex], self->rotationAngle, self->ccw);
-        }
+    for (int first = 0; first < 3; first++) {
+      for (int second = 0; second < 3; second++) {
+        snapCubeRotation(sliceCube(self, rubikCube, first, second));
       }
     }
-    self->currentStep++;
-  }
-}
-
-
-void animateZ(animation * self, rubikcube * rubikCube) {
-  if (self->currentStep == self->targetStep) {
-    self->isActive = false;
     self->onFinished(rubikCube, self->sliceIndex, self->ccw);
-  } else {
-    for (int xIndex = 0; xIndex < 3; xIndex++) {
-      for (int yIndex = 0; yIndex < 3; yIndex++) {
-        for (int faceIndex = 0; faceIndex < 6; faceIndex++) {
-          rotateFaceZ(&rubikCube->cubes[xIndex][yIndex][self->sliceIndex]->faces[faceIndex], self->rotationAngle, self->ccw);
-        }
-      }
-    }
-    self->currentStep++;
   }
 }
 
 
-void start(animationStack * self, Mix_Chunk * sound) {
+void start(animationStack * self, Mix_Chunk * sound, Uint32 now) {
   Mix_PlayChannel(0, sound, 0);
+  for (int animationIndex = 0; animationIndex < self->animationCount; animationIndex++) {
+    self->animations[animationIndex].startTime = now;
+  }
   self->hasStarted = true;
 }
@@ -12,24 +12,34 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
 #include "graphics.h"
 
 
+#define ANIMATION_DURATION 750    /**< Duration of a move, in milliseconds */
+#define ANIMATION_POOL_SIZE 256   /**< Number of moves that can be queued */
+#define STACK_ANIMATIONS 3        /**< Maximum number of slices in a move */
+#define PLAYBACK_BUDGET 8000      /**< Longest time to play a backlog of
+                                  moves, in milliseconds */
+#define MIN_ANIMATION_DURATION 40 /**< Shortest animation of a move before
+                                  moves are folded, in milliseconds */
+
+
 /**
- * A structure to hold all the informations relative to an animation. Can also
- * be used as a list.
+ * A structure to hold all the informations relative to an animation
  */
 typedef struct _animation {
   bool isActive;              /**< True if the animation isn't finished */
   bool ccw;                   /**< True for a counterclockwise animation */
-  int targetStep;             /**< The number of step (frames) to animate */
-  int currentStep;            /**< The current step number */
+  Uint32 startTime;           /**< Time of the start, in milliseconds */
+  Uint32 duration;            /**< Duration of the animation, in milliseconds.
+                              0 for an instantaneous move */
+  float appliedAngle;         /**< The angle already applied to the slice */
   int sliceIndex;             /**< The index of the slice to be animated */
-  float rotationAngle;        /**< The angle of rotation for each frame */
   enum FaceType animatedFace; /**< The type of the face to be animated */
-  struct _animation * next;   /**< A pointer to the next animation */
-  void (* update)(struct _animation * self, rubikcube * rubikCube);
+  enum Axis axis;             /**< The axis of the rotation */
+  void (* update)(struct _animation * self, rubikcube * rubikCube, Uint32 now);
   void (* onFinished)(rubikcube * cube, int sliceIndex, bool ccw);
 } animation;
 
@@ -39,122 +49,160 @@ typedef struct _animation {
  * of animations serially. Is also a list.
  */
 typedef struct _animationStack {
-  animation * animations;         /**< A list of animations */
+  animation animations[STACK_ANIMATIONS]; /**< The animations of the move */
+  int animationCount;             /**< Number of animations in the stack */
   Mix_Chunk * sound;              /**< The sound that will be played on start */
   bool hasStarted;                /**< True if the stack has been started */
   bool isFinished;                /**< True if the stack is finished */
   struct _animationStack * next;  /**< The next animation stack (for lists) */
-  void (* start)(struct _animationStack * self, Mix_Chunk * sound);
-  void (* update)(struct _animationStack * self, rubikcube * rubikCube);
+  void (* start)(struct _animationStack * self, Mix_Chunk * sound, Uint32 now);
+  void (* update)(struct _animationStack * self, rubikcube * rubikCube, Uint32 now);
 } animationStack;
 
 
 /**
- * Generate an animation stack
- * @param  sound The sound it will play when it will activate
- * @return       A pointer to the new animation stack
+ * A queue of animation stacks, played serially. The stacks are taken from a
+ * pool allocated once, so that no memory is allocated when a move is played.
  */
-animationStack * generateAnimationStack(Mix_Chunk * sound);
+typedef struct _animationQueue {
+  animationStack pool[ANIMATION_POOL_SIZE]; /**< Storage of the stacks */
+  animationStack * freeStacks;    /**< List of the unused stacks of the pool */
+  animationStack * head;          /**< The stack being played, NULL if none */
+  animationStack * tail;          /**< The last stack queued */
+  int count;                      /**< Number of stacks in the queue */
+  Uint32 deadline;                /**< End of the accelerated playback of a
+                                  long backlog, 0 if none */
+  int foldDebt;                   /**< Moves of the backlog still to be
+                                  folded, some of them not queued yet */
+} animationQueue;
 
 
 /**
- * Add an animation stack to a list of stack
- * @param animStack A pointer to the list of stacks
- * @param toAdd     The animation stack to add to the list
+ * Generate an empty animation queue with all its stacks
+ * @return A pointer to the new animation queue
  */
-void addAnimationStack(animationStack ** animStack, animationStack * toAdd);
+animationQueue * generateAnimationQueue();
 
 
 /**
- * Remove an animation stack from a list of stack
- * @param animStack A pointer to the list of stacks
- * @param toRemove  The stack to be removed
+ * Remove all the stacks of a queue, without finishing them
+ * @param animQueue The queue to clear
  */
-void removeAnimationStack(animationStack ** animStack, animationStack * toRemove);
+void clearAnimationQueue(animationQueue * animQueue);
 
 
 /**
- * Count the number of stacks in a list
- * @param  animStack A pointer to the list of stacks
- * @return           The number of stacks in the list
+ * Take an animation stack from the pool of a queue. If every stack of the pool
+ * is in use, the stack at the head of the queue is finished instantly to make
+ * room for the new one.
+ * @param  animQueue The queue owning the pool
+ * @param  rubikCube The rubikcube animated by the queue
+ * @param  sound     The sound it will play when it will activate
+ * @return           A pointer to the new animation stack
  */
-int animationStackCount(animationStack * animStack);
+animationStack * generateAnimationStack(animationQueue * animQueue, rubikcube * rubikCube, Mix_Chunk * sound);
 
 
 /**
- * Update an animation stack. Basically, it loops between all the animations
- * launch their update function
- * @param self      The
- * @param rubikCube [description]
+ * Add an animation stack at the end of a queue
+ * @param animQueue The queue of stacks
+ * @param toAdd     The animation stack to add to the queue
  */
-void updateAnimationStack(animationStack * self, rubikcube * rubikCube);
+void addAnimationStack(animationQueue * animQueue, animationStack * toAdd);
 
 
 /**
- * Generate a new animation
- * @param  animatedFace The type of face to be animated
- * @param  sliceIndex   Index of the slice to be animated
- * @param  increment    Angle increment for the animation
- * @param  ccw          True to animate counterclockwise
- * @param  onFinished   Callback for when the animation is over
- * @return              A new animation
+ * Remove the animation stack at the head of a queue and give it back to the
+ * pool
+ * @param animQueue The queue of stacks
+ */
+void removeAnimationStack(animationQueue * animQueue);
+
+
+/**
+ * Count the number of stacks in a queue
+ * @param  animQueue The queue of stacks
+ * @return           The number of stacks in the queue
  */
-animation * generateAnimation(enum FaceType animatedFace, int sliceIndex, float increment, bool ccw, void (* onFinished)(rubikcube * cube, int sliceIndex, bool ccw));
+int animationStackCount(animationQueue * animQueue);
 
 
 /**
- * Add an animation to a list of animations
- * @param animations The pointer to the list of animations
- * @param toAdd      The animation to add to the list
+ * Update an animation stack. Basically, it loops between all the animations
+ * launch their update function
+ * @param self      The animation stack to update
+ * @param rubikCube The rubikcube to animate
+ * @param now       The current time, in milliseconds
  */
-void addAnimation(animation ** animations, animation * toAdd);
+void updateAnimationStack(animationStack * self, rubikcube * rubikCube, Uint32 now);
 
 
 /**
- * Remove an animation from a list of animations
- * @param animations The pointer to the list of animations
- * @param toRemove   The animation to remove from the list
+ * Apply all the remaining rotations of an animation stack at once
+ * @param self      The animation stack to finish
+ * @param rubikCube The rubikcube to animate
  */
-void removeAnimation(animation ** animations, animation * toRemove);
+void finishAnimationStack(animationStack * self, rubikcube * rubikCube);
 
 
 /**
- * Update the animation list. It goes through all the animations and remove
- * the ones that are finished.
- * @param animations A pointer to the list of animations
+ * Adapt the playback speed to the number of moves waiting to be played
+ *
+ * Must be called before updating the head of the queue. When the backlog is
+ * too long, a deadline is set PLAYBACK_BUDGET milliseconds ahead and the time
+ * left is shared between the moves of the backlog. When this would make a move
+ * shorter than MIN_ANIMATION_DURATION, the oldest moves are applied instantly
+ * (folded) instead, in order, so the view stays in sync with the model.
+ *
+ * The backlog counts the pending moves too : the ones which cannot be folded
+ * yet are counted in foldDebt, and folded as soon as they are queued, so the
+ * whole backlog is played within PLAYBACK_BUDGET.
+ *
+ * @param animQueue    The queue of stacks
+ * @param rubikCube    The rubikcube animated by the queue
+ * @param pendingMoves Number of moves not yet turned into animations
+ * @param now          The current time, in milliseconds
  */
-void updateAnimationList(animation ** animations);
+void scheduleAnimationQueue(animationQueue * animQueue, rubikcube * rubikCube, int pendingMoves, Uint32 now);
 
 
 /**
- * Animate a rotation around the X axis
- * @param self      The animation itself
- * @param rubikCube The rubikcube to animate
+ * Generate a new animation
+ * @param  animatedFace The type of face to be animated
+ * @param  sliceIndex   Index of the slice to be animated
+ * @param  duration     Duration of the animation in milliseconds
+ * @param  ccw          True to animate counterclockwise
+ * @param  onFinished   Callback for when the animation is over
+ * @return              A new animation
  */
-void animateX(animation * self, rubikcube * rubikCube);
+animation generateAnimation(enum FaceType animatedFace, int sliceIndex, Uint32 duration, bool ccw, void (* onFinished)(rubikcube * cube, int sliceIndex, bool ccw));
 
 
 /**
- * Animate a rotation around the Y axis
- * @param self      The animation itself
- * @param rubikCube The rubikcube to animate
+ * Add an animation to an animation stack
+ * @param animStack The stack the animation belongs to
+ * @param toAdd     The animation to add to the stack
  */
-void animateY(animation * self, rubikcube * rubikCube);
+void addAnimation(animationStack * animStack, animation toAdd);
 
 
 /**
- * Animate a rotation around the Z axis
+ * Rotate the slice of an animation to the angle it must have at a given time.
+ * The rotation is interpolated from the time elapsed since the start, so the
+ * speed of the animation doesn't depend on the frame rate.
  * @param self      The animation itself
  * @param rubikCube The rubikcube to animate
+ * @param now       The current time, in milliseconds
  */
-void animateZ(animation * self, rubikcube * rubikCube);
+void updateAnimation(animation * self, rubikcube * rubikCube, Uint32 now);
 
 
 /**
  * Start an animation stack
  * @param self  The animationstack itself
- * @param sound [description]
+ * @param sound The sound to play
+ * @param now   The current time, in milliseconds
  */
-void start(animationStack * self, Mix_Chunk * sound);
+void start(animationStack * self, Mix_Chunk * sound, Uint32 now);
 
 #endif
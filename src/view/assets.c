@@ -0,0 +1,81 @@
+/**
+ * @file assets.c
+ */
+
+
+#include "assets.h"
+
+
+const assetEntry * findAsset(const char * path) {
+  int low = 0;
+  int high = assetCount - 1;
+  while (low <= high) {
+    int middle = (low + high) / 2;
+    int order = strcmp(path, assetIndex[middle].path);
+    if (order == 0) {
+      return &assetIndex[middle];
+    }
+    if (order < 0) {
+      high = middle - 1;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return NULL;
+}
+
+
+/**
+ * Open a packed file as a stream, inflating it if needed
+ * @param  path     The path of the file
+ * @param  inflated Set to the inflated copy to free with the stream, or NULL
+ * @return          The stream, NULL on failure
+ */
+static SDL_RWops * openAsset(const char * path, unsigned char ** inflated) {
+  *inflated = NULL;
+  const assetEntry * entry = findAsset(path);
+  if (entry == NULL) {
+    SDL_SetError("%s is not packed", path);
+    return NULL;
+  }
+
+  const unsigned char * data = assetPack + entry->offset;
+  if (entry->packedSize < entry->size) {
+    uLongf size = entry->size;
+    *inflated = (unsigned char *)malloc(entry->size);
+    if (*inflated == NULL
+        || uncompress(*inflated, &size, data, entry->packedSize) != Z_OK) {
+      free(*inflated);
+      *inflated = NULL;
+      SDL_SetError("%s is corrupted", path);
+      return NULL;
+    }
+    data = *inflated;
+  } // Stored files are read in place
+
+  return SDL_RWFromConstMem(data, entry->size);
+}
+
+
+SDL_Surface * loadImageAsset(const char * path) {
+  unsigned char * inflated;
+  SDL_RWops * stream = openAsset(path, &inflated);
+  if (stream == NULL) {
+    return NULL;
+  }
+  SDL_Surface * image = IMG_Load_RW(stream, 1);
+  free(inflated);
+  return image;
+}
+
+
+Mix_Chunk * loadSoundAsset(const char * path) {
+  unsigned char * inflated;
+  SDL_RWops * stream = openAsset(path, &inflated);
+  if (stream == NULL) {
+    return NULL;
+  }
+  Mix_Chunk * sound = Mix_LoadWAV_RW(stream, 1);
+  free(inflated);
+  return sound;
+}
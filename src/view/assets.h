@@ -0,0 +1,64 @@
+/**
+ * @file assets.h
+ * Defines the access to the resources packed in the executable
+ *
+ * The files of res/ are packed at build time by tools/packres.c in a generated
+ * source file (assetPack.c), so the game does not depend on the directory it
+ * is launched from. The images and sounds are decoded straight from memory.
+ */
+
+
+#ifndef ASSETS_H
+#define ASSETS_H
+
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+
+
+/**
+ * An entry of the index of the pack
+ */
+typedef struct _assetEntry {
+  const char * path;          /**< Path of the file in the source tree */
+  unsigned long offset;       /**< Offset of the file in the pack */
+  unsigned long size;         /**< Size of the file */
+  unsigned long packedSize;   /**< Size in the pack, less than size if the
+                              file is deflated */
+} assetEntry;
+
+
+extern const unsigned char assetPack[];   /**< The packed files */
+extern const assetEntry assetIndex[];     /**< The index, sorted by path */
+extern const int assetCount;              /**< Number of packed files */
+
+
+/**
+ * Find a file in the pack
+ * @param  path The path of the file, as "res/winner.png"
+ * @return      The entry of the file, NULL if it is not packed
+ */
+const assetEntry * findAsset(const char * path);
+
+
+/**
+ * Load an image from the pack. Safe to call from several threads.
+ * @param  path The path of the image
+ * @return      The image, NULL on failure
+ */
+SDL_Surface * loadImageAsset(const char * path);
+
+
+/**
+ * Load a sound from the pack
+ * @param  path The path of the sound
+ * @return      The sound, NULL on failure
+ */
+Mix_Chunk * loadSoundAsset(const char * path);
+
+#endif
@@ -17,13 +17,26 @@
  * is to use quaternions, which are complex objects to manipulate. We'll settle
  * on a simple solution.
  *
- * The adopted solution is to save the vertices positions on generation and,
- * each time a rotation is called, rotate them around the desire axis and
- * save the new position. Since our moves are all simple rotations around an
- * axis, we'll keep committing to the KISS principle.
+ * The first adopted solution was to save the vertices positions on generation
+ * and, each time a rotation is called, rotate them around the desire axis and
+ * save the new position. It meant hundreds of sin/cos per frame and floating
+ * point errors building up over long games.
+ *
+ * Each cube now holds a model matrix. An animation step computes one rotation
+ * matrix and multiplies it into the matrices of the cubes of the slice, in the
+ * order the moves are played, which is what the first attempt was missing.
+ * At the end of a move, the matrices are rounded to exact quarter turns.
+ *
+ * ### Drawing the cubes
+ *
+ * Drawing each face in immediate mode meant 324 glBegin/glEnd pairs per frame.
+ * The whole mesh now lives in a vertex buffer that never changes (except for
+ * colours) and the stickers program applies the model matrix of each cube to
+ * its vertices.
  */
 
 
+#include <string.h>
 #include "graphics.h"
 
 
@@ -32,6 +45,7 @@ rubikcube * generateRubikCube() {
   rubikCube = (rubikcube *) malloc(sizeof(rubikcube));
 
   /* AATMYNTA (Always Allocate The Memory You Need To Allocate) */
+  int meshOffset = 0;
   cube3d **** cubes = (cube3d ****) malloc(3 * sizeof(cube3d ***));
   for (int zIndex = -1; zIndex < 2; zIndex++) {
     cube3d *** yCubes = (cube3d ***) malloc(3 * sizeof(cube3d **));
@@ -46,6 +60,8 @@ rubikcube * generateRubikCube() {
 
         xCubes[xIndex + 1] = (cube3d *) malloc(sizeof(cube3d));
         *xCubes[xIndex + 1] = generateCube(cubeTransform);
+        xCubes[xIndex + 1]->meshOffset = meshOffset;
+        meshOffset += CUBE_VERTICES;
       }
       yCubes[yIndex + 1] = xCubes;
     }
@@ -53,6 +69,17 @@ rubikcube * generateRubikCube() {
   }
 
   rubikCube->cubes = cubes;
+
+  /* Allocate the vertex buffer, the cubes will fill it on the first draw */
+  rubikCube->vertices = (GLfloat *) malloc(27 * CUBE_VERTICES * VERTEX_FLOATS
+                                           * sizeof(GLfloat));
+  glGenBuffers(1, &rubikCube->vertexBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, rubikCube->vertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER,
+               27 * CUBE_VERTICES * VERTEX_FLOATS * sizeof(GLfloat),
+               NULL, GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
   return rubikCube;
 }
 
@@ -69,7 +96,13 @@ cube3d generateCube(transform cubeTransform) {
       generateFace(cubeTransform, LEFT),
       generateFace(cubeTransform, RIGHT),
     },
-    cubeTransform
+    cubeTransform,
+    0,
+    true,
+    {1, 0, 0, 0,
+     0, 1, 0, 0,
+     0, 0, 1, 0,
+     0, 0, 0, 1}
   };
 
   return mainCube;
@@ -182,7 +215,11 @@ face generateFace(transform cubeTransform, enum FaceType faceType) {
 
 
 void generateTexture(texture * newTexture, const char * url) {
-  newTexture->surface = IMG_Load(url);
+  newTexture->surface = loadImageAsset(url);
+  newTexture->region[0] = 0;
+  newTexture->region[1] = 0;
+  newTexture->region[2] = 1;
+  newTexture->region[3] = 1;
   glGenTextures(1, &newTexture->id);
   glBindTexture(GL_TEXTURE_2D, newTexture->id);
   int Mode = GL_RGB;
@@ -197,11 +234,195 @@ void generateTexture(texture * newTexture, const char * url) {
 }
 
 
-void generateCubemapTexture(GLuint * textureId) {
-  glGenTextures(1, textureId);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, *textureId);
+/**
+ * Paths of the glyphs, in the order of listGlyphs()
+ */
+static const char * glyphFiles[ATLAS_GLYPHS] = {
+  "res/up.png", "res/UP.png", "res/UP2.png", "res/up2.png",
+  "res/down.png", "res/DOWN.png", "res/DOWN2.png", "res/down2.png",
+  "res/front.png", "res/FRONT.png", "res/FRONT2.png", "res/front2.png",
+  "res/back.png", "res/BACK.png", "res/BACK2.png", "res/back2.png",
+  "res/right.png", "res/RIGHT.png", "res/RIGHT2.png", "res/right2.png",
+  "res/left.png", "res/LEFT.png", "res/LEFT2.png", "res/left2.png",
+  "res/xyz.png", "res/xyzi.png",
+  "res/x.png", "res/xi.png",
+  "res/y.png", "res/yi.png",
+  "res/z.png", "res/zi.png"
+};
+
+
+/**
+ * List the glyphs of a texture store, in the order of glyphFiles
+ * @param texStore The texture store
+ * @param glyphs   The list to fill, ATLAS_GLYPHS long
+ */
+static void listGlyphs(textureStore * texStore, texture ** glyphs) {
+  texture * storeGlyphs[ATLAS_GLYPHS] = {
+    &texStore->up, &texStore->upi, &texStore->upid, &texStore->upd,
+    &texStore->down, &texStore->downi, &texStore->downid, &texStore->downd,
+    &texStore->front, &texStore->fronti, &texStore->frontid, &texStore->frontd,
+    &texStore->back, &texStore->backi, &texStore->backid, &texStore->backd,
+    &texStore->right, &texStore->righti, &texStore->rightid, &texStore->rightd,
+    &texStore->left, &texStore->lefti, &texStore->leftid, &texStore->leftd,
+    &texStore->xyz, &texStore->xyzi,
+    &texStore->x, &texStore->xi,
+    &texStore->y, &texStore->yi,
+    &texStore->z, &texStore->zi
+  };
+  memcpy(glyphs, storeGlyphs, sizeof(storeGlyphs));
+}
+
+
+/**
+ * Load an image as RGBA. Safe to call from a worker thread.
+ * @param  url The path to the image
+ * @return     The image
+ */
+static SDL_Surface * loadImage(const char * url) {
+  SDL_Surface * surface = loadImageAsset(url);
+  if (surface == NULL) {
+    SDL_Log("Unable to load %s: %s", url, SDL_GetError());
+    exit(1);
+  }
+  SDL_Surface * converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ABGR8888, 0);
+  SDL_FreeSurface(surface);
+  return converted;
+}
+
+
+/**
+ * Scale a glyph down to a square cell of an image, averaging the pixels of the
+ * glyph covered by each pixel of the cell
+ * @param pixels     The RGBA pixels of the image
+ * @param atlasWidth The width of the image, in pixels
+ * @param cellX      Left side of the cell, in pixels
+ * @param cellY      Top side of the cell, in pixels
+ * @param cellSize   Size of the cell, in pixels
+ * @param surface    The RGBA image of the glyph
+ */
+static void copyGlyph(unsigned char * pixels, int atlasWidth, int cellX, int cellY, int cellSize, SDL_Surface * surface) {
+  for (int row = 0; row < cellSize; row++) {
+    int firstRow = row * surface->h / cellSize;
+    int lastRow = (row + 1) * surface->h / cellSize;
+    lastRow = lastRow > firstRow ? lastRow : firstRow + 1;
+
+    for (int column = 0; column < cellSize; column++) {
+      int firstColumn = column * surface->w / cellSize;
+      int lastColumn = (column + 1) * surface->w / cellSize;
+      lastColumn = lastColumn > firstColumn ? lastColumn : firstColumn + 1;
+
+      unsigned int sum[4] = {0, 0, 0, 0};
+      for (int imageRow = firstRow; imageRow < lastRow; imageRow++) {
+        const unsigned char * pixel = (const unsigned char *)surface->pixels
+                                      + imageRow * surface->pitch + firstColumn * 4;
+        for (int imageColumn = firstColumn; imageColumn < lastColumn; imageColumn++) {
+          for (int channel = 0; channel < 4; channel++) {
+            sum[channel] += *pixel++;
+          }
+        }
+      }
+
+      int count = (lastRow - firstRow) * (lastColumn - firstColumn);
+      unsigned char * cellPixel = pixels
+                                  + ((cellY + row) * atlasWidth + cellX + column) * 4;
+      for (int channel = 0; channel < 4; channel++) {
+        cellPixel[channel] = sum[channel] / count;
+      }
+    }
+  }
+}
+
+
+/**
+ * The data shared by the jobs building an atlas
+ */
+typedef struct _atlasJob {
+  unsigned char * pixels;   /**< The RGBA pixels of the atlas */
+  int width;                /**< Width of the atlas */
+  int height;               /**< Height of the atlas */
+  texture ** glyphs;        /**< The glyphs to pack */
+  const char ** urls;       /**< The paths of the glyphs */
+} atlasJob;
+
+
+/**
+ * Decode a glyph and scale it down to its cell, on a worker thread
+ * @param data  The atlas job
+ * @param index The index of the glyph
+ */
+static void packGlyph(void * data, int index) {
+  atlasJob * job = (atlasJob *)data;
+  int cellX = index % ATLAS_COLUMNS * ATLAS_CELL_SIZE;
+  int cellY = index / ATLAS_COLUMNS * ATLAS_CELL_SIZE;
+
+  SDL_Surface * surface = loadImage(job->urls[index]);
+  copyGlyph(job->pixels, job->width, cellX, cellY, ATLAS_CELL_SIZE, surface);
+  SDL_FreeSurface(surface);
+
+  texture * glyph = job->glyphs[index];
+  glyph->surface = NULL; // Loaded with the help window, see loadHelpGlyphs()
+  glyph->region[0] = (GLfloat)cellX / job->width;
+  glyph->region[1] = (GLfloat)cellY / job->height;
+  glyph->region[2] = (GLfloat)(cellX + ATLAS_CELL_SIZE) / job->width;
+  glyph->region[3] = (GLfloat)(cellY + ATLAS_CELL_SIZE) / job->height;
+}
+
+
+void generateAtlas(GLuint * atlasId, texture ** glyphs, const char ** urls, int count) {
+  atlasJob job;
+  int rows = (count + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+  job.width = ATLAS_COLUMNS * ATLAS_CELL_SIZE;
+  job.height = rows * ATLAS_CELL_SIZE;
+  job.pixels = (unsigned char *)calloc(job.width * job.height, 4);
+  job.glyphs = glyphs;
+  job.urls = urls;
+
+  /* Decode and place the glyphs in their cells on the workers */
+  runParallel(count, &packGlyph, &job);
+
+  /* Upload on the thread owning the context */
+  glGenTextures(1, atlasId);
+  glBindTexture(GL_TEXTURE_2D, *atlasId);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, job.width, job.height, 0, GL_RGBA,
+               GL_UNSIGNED_BYTE, job.pixels);
+  free(job.pixels);
+
+  /* Mipmaps keep the small history glyphs smooth */
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, ATLAS_MAX_LEVEL);
+  glGenerateMipmap(GL_TEXTURE_2D);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-  const char * files[22] = {
+  for (int glyphIndex = 0; glyphIndex < count; glyphIndex++) {
+    glyphs[glyphIndex]->id = *atlasId;
+  }
+}
+
+
+/**
+ * The data shared by the jobs decoding the skybox
+ */
+typedef struct _skyboxJob {
+  const char ** urls;         /**< The paths of the faces */
+  SDL_Surface * surfaces[6];  /**< The decoded faces */
+} skyboxJob;
+
+
+/**
+ * Decode a face of the skybox, on a worker thread
+ * @param data  The skybox job
+ * @param index The index of the face
+ */
+static void decodeSkyboxFace(void * data, int index) {
+  skyboxJob * job = (skyboxJob *)data;
+  job->surfaces[index] = loadImage(job->urls[index]);
+}
+
+
+void generateCubemapTexture(GLuint * textureId) {
+  const char * files[6] = {
     "res/skybox/right.png",
     "res/skybox/left.png",
     "res/skybox/top.png",
@@ -210,8 +431,14 @@ void generateCubemapTexture(GLuint * textureId) {
     "res/skybox/back.png"
   };
 
+  skyboxJob job;
+  job.urls = files;
+  runParallel(6, &decodeSkyboxFace, &job);
+
+  glGenTextures(1, textureId);
+  glBindTexture(GL_TEXTURE_CUBE_MAP, *textureId);
   for (int imageIndex = 0; imageIndex < 6; imageIndex++) {
-    SDL_Surface * surf = IMG_Load(files[imageIndex]);
+    SDL_Surface * surf = job.surfaces[imageIndex];
 
     glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X_ARB + imageIndex, 0, GL_RGBA, surf->w, surf->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, surf->pixels);
 
@@ -227,52 +454,56 @@ void generateCubemapTexture(GLuint * textureId) {
 
 textureStore generateTextureStore() {
   textureStore texStore;
-  generateTexture(&texStore.up, "res/up.png");
-  generateTexture(&texStore.upi, "res/UP.png");
-  generateTexture(&texStore.upid, "res/UP2.png");
-  generateTexture(&texStore.upd, "res/up2.png");
-
-  generateTexture(&texStore.down, "res/down.png");
-  generateTexture(&texStore.downi, "res/DOWN.png");
-  generateTexture(&texStore.downid, "res/DOWN2.png");
-  generateTexture(&texStore.downd, "res/down2.png");
-
-  generateTexture(&texStore.front, "res/front.png");
-  generateTexture(&texStore.fronti, "res/FRONT.png");
-  generateTexture(&texStore.frontid, "res/FRONT2.png");
-  generateTexture(&texStore.frontd, "res/front2.png");
-
-  generateTexture(&texStore.back, "res/back.png");
-  generateTexture(&texStore.backi, "res/BACK.png");
-  generateTexture(&texStore.backid, "res/BACK2.png");
-  generateTexture(&texStore.backd, "res/back2.png");
-
-  generateTexture(&texStore.right, "res/right.png");
-  generateTexture(&texStore.righti, "res/RIGHT.png");
-  generateTexture(&texStore.rightid, "res/RIGHT2.png");
-  generateTexture(&texStore.rightd, "res/right2.png");
-
-  generateTexture(&texStore.left, "res/left.png");
-  generateTexture(&texStore.lefti, "res/LEFT.png");
-  generateTexture(&texStore.leftid, "res/LEFT2.png");
-  generateTexture(&texStore.leftd, "res/left2.png");
+
+  /* The glyphs of the instructions and of the history share the atlas */
+  texture * glyphs[ATLAS_GLYPHS];
+  listGlyphs(&texStore, glyphs);
+  generateAtlas(&texStore.atlas, glyphs, glyphFiles, ATLAS_GLYPHS);
+  texStore.helpGlyphsLoaded = false;
 
   generateCubemapTexture(&texStore.skybox);
 
-  generateTexture(&texStore.xyz, "res/xyz.png");
-  generateTexture(&texStore.xyzi, "res/xyzi.png");
+  /* Only shown at the end of a game, see requireTexture() */
+  texStore.winner.id = 0;
+  texStore.winner.surface = NULL;
+  return texStore;
+}
 
-  generateTexture(&texStore.x, "res/x.png");
-  generateTexture(&texStore.xi, "res/xi.png");
 
-  generateTexture(&texStore.y, "res/y.png");
-  generateTexture(&texStore.yi, "res/yi.png");
+/**
+ * Decode a glyph and scale it down to the size of the help window, on a worker
+ * thread
+ * @param data  The glyphs
+ * @param index The index of the glyph
+ */
+static void loadHelpGlyph(void * data, int index) {
+  texture ** glyphs = (texture **)data;
+  SDL_Surface * image = loadImage(glyphFiles[index]);
+  SDL_Surface * glyph = SDL_CreateRGBSurfaceWithFormat(0, HELP_GLYPH_SIZE,
+                                                       HELP_GLYPH_SIZE, 32,
+                                                       SDL_PIXELFORMAT_ABGR8888);
+  copyGlyph((unsigned char *)glyph->pixels, glyph->pitch / 4, 0, 0,
+            HELP_GLYPH_SIZE, image);
+  SDL_FreeSurface(image);
+  glyphs[index]->surface = glyph;
+}
 
-  generateTexture(&texStore.z, "res/z.png");
-  generateTexture(&texStore.zi, "res/zi.png");
 
-  generateTexture(&texStore.winner, "res/winner.png");
-  return texStore;
+void loadHelpGlyphs(textureStore * texStore) {
+  if (texStore->helpGlyphsLoaded) {
+    return;
+  }
+  texture * glyphs[ATLAS_GLYPHS];
+  listGlyphs(texStore, glyphs);
+  runParallel(ATLAS_GLYPHS, &loadHelpGlyph, glyphs);
+  texStore->helpGlyphsLoaded = true;
+}
+
+
+void requireTexture(texture * lazyTexture, const char * url) {
+  if (lazyTexture->surface == NULL) {
+    generateTexture(lazyTexture, url);
+  }
 }
 
 
@@ -285,10 +516,10 @@ instructionDisplay generateInstruction(enum FaceType faceType, textureStore texS
       newInstruction.corners[2] = (vector3) {1, -1, 2.3};
       newInstruction.corners[3] = (vector3) {-1, -1, 2.3};
       newInstruction.normal = (vector3) {0, 0, 1};
-      newInstruction.textures.id = texStore.up.id;
-      newInstruction.textures.ccwId = texStore.upi.id;
-      newInstruction.textures.ccwId2 = texStore.upid.id;
-      newInstruction.textures.id2 = texStore.upd.id;
+      newInstruction.textures.glyph = texStore.up;
+      newInstruction.textures.ccwGlyph = texStore.upi;
+      newInstruction.textures.ccwGlyph2 = texStore.upid;
+      newInstruction.textures.glyph2 = texStore.upd;
       break;
     case DOWN:
       newInstruction.corners[0] = (vector3) {-1, -1, -2.3};
@@ -296,10 +527,10 @@ instructionDisplay generateInstruction(enum FaceType faceType, textureStore texS
       newInstruction.corners[2] = (vector3) {1, 1, -2.3};
       newInstruction.corners[3] = (vector3) {-1, 1, -2.3};
       newInstruction.normal = (vector3) {0, 0, -1};
-      newInstruction.textures.id = texStore.down.id;
-      newInstruction.textures.ccwId = texStore.downi.id;
-      newInstruction.textures.ccwId2 = texStore.downid.id;
-      newInstruction.textures.id2 = texStore.downd.id;
+      newInstruction.textures.glyph = texStore.down;
+      newInstruction.textures.ccwGlyph = texStore.downi;
+      newInstruction.textures.ccwGlyph2 = texStore.downid;
+      newInstruction.textures.glyph2 = texStore.downd;
       break;
     case FRONT:
       newInstruction.corners[0] = (vector3) {-1, -2.3, 1};
@@ -307,10 +538,10 @@ instructionDisplay generateInstruction(enum FaceType faceType, textureStore texS
       newInstruction.corners[2] = (vector3) {1, -2.3, -1};
       newInstruction.corners[3] = (vector3) {-1, -2.3, -1};
       newInstruction.normal = (vector3) {0, -1, 0};
-      newInstruction.textures.id = texStore.front.id;
-      newInstruction.textures.ccwId = texStore.fronti.id;
-      newInstruction.textures.ccwId2 = texStore.frontid.id;
-      newInstruction.textures.id2 = texStore.frontd.id;
+      newInstruction.textures.glyph = texStore.front;
+      newInstruction.textures.ccwGlyph = texStore.fronti;
+      newInstruction.textures.ccwGlyph2 = texStore.frontid;
+      newInstruction.textures.glyph2 = texStore.frontd;
       break;
     case BACK:
       newInstruction.corners[0] = (vector3) {1, 2.3, 1};
@@ -318,10 +549,10 @@ instructionDisplay generateInstruction(enum FaceType faceType, textureStore texS
       newInstruction.corners[2] = (vector3) {-1, 2.3, -1};
       newInstruction.corners[3] = (vector3) {1, 2.3, -1};
       newInstruction.normal = (vector3) {0, 1, 0};
-      newInstruction.textures.id = texStore.back.id;
-      newInstruction.textures.ccwId = texStore.backi.id;
-      newInstruction.textures.ccwId2 = texStore.backid.id;
-      newInstruction.textures.id2 = texStore.backd.id;
+      newInstruction.textures.glyph = texStore.back;
+      newInstruction.textures.ccwGlyph = texStore.backi;
+      newInstruction.textures.ccwGlyph2 = texStore.backid;
+      newInstruction.textures.glyph2 = texStore.backd;
       break;
     case RIGHT:
       newInstruction.corners[0] = (vector3) {2.3, -1, 1};
@@ -329,10 +560,10 @@ instructionDisplay generateInstruction(enum FaceType faceType, textureStore texS
       newInstruction.corners[2] = (vector3) {2.3, 1, -1};
       newInstruction.corners[3] = (vector3) {2.3, -1, -1};
       newInstruction.normal = (vector3) {1, 0, 0};
-      newInstruction.textures.id = texStore.right.id;
-      newInstruction.textures.ccwId = texStore.righti.id;
-      newInstruction.textures.ccwId2 = texStore.rightid.id;
-      newInstruction.textures.id2 = texStore.rightd.id;
+      newInstruction.textures.glyph = texStore.right;
+      newInstruction.textures.ccwGlyph = texStore.righti;
+      newInstruction.textures.ccwGlyph2 = texStore.rightid;
+      newInstruction.textures.glyph2 = texStore.rightd;
       break;
     case LEFT:
       newInstruction.corners[0] = (vector3) {-2.3, 1, 1};
@@ -340,10 +571,10 @@ instructionDisplay generateInstruction(enum FaceType faceType, textureStore texS
       newInstruction.corners[2] = (vector3) {-2.3, -1, -1};
       newInstruction.corners[3] = (vector3) {-2.3, 1, -1};
       newInstruction.normal = (vector3) {-1, 0, 0};
-      newInstruction.textures.id = texStore.left.id;
-      newInstruction.textures.ccwId = texStore.lefti.id;
-      newInstruction.textures.ccwId2 = texStore.leftid.id;
-      newInstruction.textures.id2 = texStore.leftd.id;
+      newInstruction.textures.glyph = texStore.left;
+      newInstruction.textures.ccwGlyph = texStore.lefti;
+      newInstruction.textures.ccwGlyph2 = texStore.leftid;
+      newInstruction.textures.glyph2 = texStore.leftd;
       break;
     default:
       break;
@@ -357,311 +588,267 @@ void setCubeColour(colour newColour, cube3d * selectedCube) {
   for (int faceIndex = 0; faceIndex < 6; faceIndex++) {
     selectedCube->faces[faceIndex].faceColour = newColour;
   }
+  selectedCube->meshChanged = true;
 }
 
 
-void drawCubes(rubikcube * rubikCube) {
-  for (int zIndex = 0; zIndex < 3; zIndex++) {
-    for (int yIndex = 0; yIndex < 3; yIndex++) {
-      for (int xIndex = 0; xIndex < 3; xIndex++) {
-        drawCube(*rubikCube->cubes[xIndex][yIndex][zIndex], false);
-      }
-    }
-  }
-}
-
+/**
+ * Write the vertices of a cube to the mesh and upload them to the vertex
+ * buffer, which must be bound
+ * @param rubikCube The Rubik's cube holding the mesh
+ * @param meshCube  The cube to upload
+ */
+static void uploadCubeMesh(rubikcube * rubikCube, cube3d * meshCube) {
+  int triangleCorners[FACE_VERTICES] = {0, 1, 2, 0, 2, 3};
+  GLfloat * vertex = rubikCube->vertices + meshCube->meshOffset * VERTEX_FLOATS;
 
-void drawCube(cube3d drawnCube, bool debug) {
-  /* We draw the faces */
   for (int faceIndex = 0; faceIndex < 6; faceIndex++) {
-    drawFace(drawnCube.faces[faceIndex], debug);
+    face * meshFace = &meshCube->faces[faceIndex];
+    for (int vertexIndex = 0; vertexIndex < FACE_VERTICES; vertexIndex++) {
+      vector3 corner = meshFace->corners[triangleCorners[vertexIndex]];
+      *vertex++ = corner.x;
+      *vertex++ = corner.y;
+      *vertex++ = corner.z;
+      *vertex++ = meshFace->normal.x;
+      *vertex++ = meshFace->normal.y;
+      *vertex++ = meshFace->normal.z;
+      *vertex++ = meshFace->faceColour.r / 255.0f;
+      *vertex++ = meshFace->faceColour.g / 255.0f;
+      *vertex++ = meshFace->faceColour.b / 255.0f;
+    }
   }
-}
 
+  glBufferSubData(GL_ARRAY_BUFFER,
+                  meshCube->meshOffset * VERTEX_FLOATS * sizeof(GLfloat),
+                  CUBE_VERTICES * VERTEX_FLOATS * sizeof(GLfloat),
+                  rubikCube->vertices + meshCube->meshOffset * VERTEX_FLOATS);
+  meshCube->meshChanged = false;
+}
 
-void drawFace(face drawnFace, bool debug) {
-  colour faceColour;
 
-  /**
-   * If the cube is to be debugged, it will be displayed in magenta
-   */
-  if (debug) {
-    faceColour = (colour) {255, 0, 255};
-  } else {
-    faceColour = drawnFace.faceColour;
-  }
+void drawCubes(shaderStore * shaders, rubikcube * rubikCube) {
+  glBindBuffer(GL_ARRAY_BUFFER, rubikCube->vertexBuffer);
 
-  /* We set the colour of the vertices */
-  glColor3ub(faceColour.r, faceColour.g, faceColour.b);
-
-  // glBegin(GL_QUADS);
-  // glNormal3f(drawnFace.normal.x, drawnFace.normal.y, drawnFace.normal.z);
-  // for (int vertexIndex = 0; vertexIndex < 4; vertexIndex++) {
-  //   float x = drawnFace.corners[vertexIndex].x;
-  //   float y = drawnFace.corners[vertexIndex].y;
-  //   float z = drawnFace.corners[vertexIndex].z;
-  //
-  //   glVertex3d(x, y, z);
-  // }
-  // glEnd();
-
-  glBegin(GL_TRIANGLES);
-  glNormal3f(drawnFace.normal.x, drawnFace.normal.y, drawnFace.normal.z);
-  for (int vertexIndex = 0; vertexIndex < 3; vertexIndex++) {
-    float x = drawnFace.corners[vertexIndex].x;
-    float y = drawnFace.corners[vertexIndex].y;
-    float z = drawnFace.corners[vertexIndex].z;
-
-    glVertex3d(x, y, z);
+  /* Upload the cubes that have been recoloured since the last frame */
+  for (int zIndex = 0; zIndex < 3; zIndex++) {
+    for (int yIndex = 0; yIndex < 3; yIndex++) {
+      for (int xIndex = 0; xIndex < 3; xIndex++) {
+        cube3d * drawnCube = rubikCube->cubes[xIndex][yIndex][zIndex];
+        if (drawnCube->meshChanged) {
+          uploadCubeMesh(rubikCube, drawnCube);
+        }
+      }
+    }
   }
-  glEnd();
 
-  int otherCoord[] = {0, 2, 3};
-  glBegin(GL_TRIANGLES);
-  glNormal3f(drawnFace.normal.x, drawnFace.normal.y, drawnFace.normal.z);
-  for (int vertexIndex = 0; vertexIndex < 3; vertexIndex++) {
-    float x = drawnFace.corners[otherCoord[vertexIndex]].x;
-    float y = drawnFace.corners[otherCoord[vertexIndex]].y;
-    float z = drawnFace.corners[otherCoord[vertexIndex]].z;
+  /* Draw each cube with its model matrix */
+  glUseProgram(shaders->stickers);
+  glUniform1i(shaders->stickersTextured, false);
+  GLsizei stride = VERTEX_FLOATS * sizeof(GLfloat);
+  glEnableVertexAttribArray(ATTRIBUTE_POSITION);
+  glEnableVertexAttribArray(ATTRIBUTE_NORMAL);
+  glEnableVertexAttribArray(ATTRIBUTE_COLOUR);
+  glVertexAttribPointer(ATTRIBUTE_POSITION, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid *) 0);
+  glVertexAttribPointer(ATTRIBUTE_NORMAL, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid *) (3 * sizeof(GLfloat)));
+  glVertexAttribPointer(ATTRIBUTE_COLOUR, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid *) (6 * sizeof(GLfloat)));
 
-    glVertex3d(x, y, z);
+  for (int zIndex = 0; zIndex < 3; zIndex++) {
+    for (int yIndex = 0; yIndex < 3; yIndex++) {
+      for (int xIndex = 0; xIndex < 3; xIndex++) {
+        cube3d * drawnCube = rubikCube->cubes[xIndex][yIndex][zIndex];
+        glUniformMatrix4fv(shaders->stickersModel, 1, GL_FALSE, drawnCube->modelMatrix);
+        glDrawArrays(GL_TRIANGLES, drawnCube->meshOffset, CUBE_VERTICES);
+      }
+    }
   }
-  glEnd();
-}
 
-
-void drawInstructions(instructionDisplay * instructions, int keyShortcut) {
-  for (int instructionIndex = 0; instructionIndex < 6; instructionIndex++) {
-    drawInstruction(instructions[instructionIndex], keyShortcut);
-  }
+  glDisableVertexAttribArray(ATTRIBUTE_COLOUR);
+  glDisableVertexAttribArray(ATTRIBUTE_NORMAL);
+  glDisableVertexAttribArray(ATTRIBUTE_POSITION);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 
-void drawInstruction(instructionDisplay drawnInstruction, int keyShortcut) {
-  GLuint textureIds[] = {drawnInstruction.textures.id,
-                         drawnInstruction.textures.id2,
-                         drawnInstruction.textures.ccwId,
-                         drawnInstruction.textures.ccwId2};
-
-  glBindTexture(GL_TEXTURE_2D, textureIds[keyShortcut]);
-
-  glColor4ub(255, 255, 255, 255);
-
-  float corners[4][2] = {
-    {0, 0},
-    {1, 0},
-    {1, 1},
-    {0, 1}
+void drawInstructions(shaderStore * shaders, instructionDisplay * instructions, int keyShortcut) {
+  /* Corners of the texture, as indices in the region of a glyph */
+  int regionCorners[4][2] = {
+    {0, 1},
+    {2, 1},
+    {2, 3},
+    {0, 3}
   };
 
-  glEnable(GL_TEXTURE_2D);
-  glBegin(GL_QUADS);
-  glNormal3f(drawnInstruction.normal.x, drawnInstruction.normal.y, drawnInstruction.normal.z);
-
-  for (int vertexIndex = 0; vertexIndex < 4; vertexIndex++) {
-    float x = drawnInstruction.corners[vertexIndex].x;
-    float y = drawnInstruction.corners[vertexIndex].y;
-    float z = drawnInstruction.corners[vertexIndex].z;
-
-    float xMap = corners[vertexIndex][0];
-    float yMap = corners[vertexIndex][1];
-
-    glTexCoord2f(xMap, yMap);
-    glVertex3d(x, y, z);
+  /* Position, normal and texture coordinates of the 4 corners of each quad */
+  GLfloat vertices[6 * 4 * 8];
+  GLfloat * vertex = vertices;
+  for (int instructionIndex = 0; instructionIndex < 6; instructionIndex++) {
+    instructionDisplay * drawnInstruction = &instructions[instructionIndex];
+    texture glyphs[] = {drawnInstruction->textures.glyph,
+                        drawnInstruction->textures.glyph2,
+                        drawnInstruction->textures.ccwGlyph,
+                        drawnInstruction->textures.ccwGlyph2};
+    GLfloat * region = glyphs[keyShortcut].region;
+
+    for (int vertexIndex = 0; vertexIndex < 4; vertexIndex++) {
+      *vertex++ = drawnInstruction->corners[vertexIndex].x;
+      *vertex++ = drawnInstruction->corners[vertexIndex].y;
+      *vertex++ = drawnInstruction->corners[vertexIndex].z;
+      *vertex++ = drawnInstruction->normal.x;
+      *vertex++ = drawnInstruction->normal.y;
+      *vertex++ = drawnInstruction->normal.z;
+      *vertex++ = region[regionCorners[vertexIndex][0]];
+      *vertex++ = region[regionCorners[vertexIndex][1]];
+    }
   }
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
+
+  /* Lit as the stickers, in white, around the cube */
+  GLfloat identity[16];
+  identityMatrix(identity);
+  glUseProgram(shaders->stickers);
+  glUniform1i(shaders->stickersTextured, true);
+  glUniformMatrix4fv(shaders->stickersModel, 1, GL_FALSE, identity);
+  glBindTexture(GL_TEXTURE_2D, instructions[0].textures.glyph.id);
+
+  GLsizei stride = 8 * sizeof(GLfloat);
+  glEnableVertexAttribArray(ATTRIBUTE_POSITION);
+  glEnableVertexAttribArray(ATTRIBUTE_NORMAL);
+  glEnableVertexAttribArray(ATTRIBUTE_TEXCOORD);
+  glVertexAttribPointer(ATTRIBUTE_POSITION, 3, GL_FLOAT, GL_FALSE, stride, vertices);
+  glVertexAttribPointer(ATTRIBUTE_NORMAL, 3, GL_FLOAT, GL_FALSE, stride, vertices + 3);
+  glVertexAttribPointer(ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, stride, vertices + 6);
+  glVertexAttrib4f(ATTRIBUTE_COLOUR, 1, 1, 1, 1);
+  glDrawArrays(GL_QUADS, 0, 6 * 4);
+  glDisableVertexAttribArray(ATTRIBUTE_TEXCOORD);
+  glDisableVertexAttribArray(ATTRIBUTE_NORMAL);
+  glDisableVertexAttribArray(ATTRIBUTE_POSITION);
 }
 
 
-void drawXYZInstruction(textureStore texStore, bool reversed) {
-  if (reversed) {
-    glBindTexture(GL_TEXTURE_2D, texStore.xyzi.id);
-  } else {
-    glBindTexture(GL_TEXTURE_2D, texStore.xyz.id);
-  }
-  glColor3ub(255, 255, 255);
-  glBegin(GL_QUADS);
-  glTexCoord2i(0,0); glVertex2i(20, 590);
-  glTexCoord2i(0,1); glVertex2i(20, 490);
-  glTexCoord2i(1,1); glVertex2i(120, 490);
-  glTexCoord2i(1,0); glVertex2i(120, 590);
-  glEnd();
+void drawXYZInstruction(shaderStore * shaders, textureStore texStore, bool reversed) {
+  texture glyph = reversed ? texStore.xyzi : texStore.xyz;
+  GLfloat * region = glyph.region;
+  GLfloat positions[] = {20, 590, 20, 490, 120, 490, 120, 590};
+  GLfloat texCoords[] = {region[0], region[1],
+                         region[0], region[3],
+                         region[2], region[3],
+                         region[2], region[1]};
+  glBindTexture(GL_TEXTURE_2D, glyph.id);
+  drawOverlay(shaders, GL_QUADS, 4, positions, texCoords, NULL);
 }
 
 
-void drawSkybox(GLuint textureId) {
-  // Taille du cube
-  float t = 500.0f;
-
-  // Utilisation de la texture CubeMap
-  glBindTexture(GL_TEXTURE_CUBE_MAP_ARB, textureId);
-
-  glEnable(GL_TEXTURE_CUBE_MAP_ARB);
-  glDisable(GL_LIGHTING);
-  glDisable(GL_DEPTH_TEST);
-  glDepthMask(GL_FALSE);
-
-  glColor3ub(255, 255, 255);
-
-  // Rendu de la géométrie
-  glBegin(GL_TRIANGLE_STRIP);			// X Négatif
-  	glTexCoord3f(-t,-t,-t); glVertex3f(-t,-t,-t);
-  	glTexCoord3f(-t,t,-t); glVertex3f(-t,t,-t);
-  	glTexCoord3f(-t,-t,t); glVertex3f(-t,-t,t);
-  	glTexCoord3f(-t,t,t); glVertex3f(-t,t,t);
-  glEnd();
-
-  glBegin(GL_TRIANGLE_STRIP);			// X Positif
-  	glTexCoord3f(t, -t,-t); glVertex3f(t,-t,-t);
-  	glTexCoord3f(t,-t,t); glVertex3f(t,-t,t);
-  	glTexCoord3f(t,t,-t); glVertex3f(t,t,-t);
-  	glTexCoord3f(t,t,t); glVertex3f(t,t,t);
-  glEnd();
-
-  glBegin(GL_TRIANGLE_STRIP);			// Y Négatif
-  	glTexCoord3f(-t,-t,-t); glVertex3f(-t,-t,-t);
-  	glTexCoord3f(-t,-t,t); glVertex3f(-t,-t,t);
-  	glTexCoord3f(t, -t,-t); glVertex3f(t,-t,-t);
-  	glTexCoord3f(t,-t,t); glVertex3f(t,-t,t);
-  glEnd();
-
-  glBegin(GL_TRIANGLE_STRIP);			// Y Positif
-  	glTexCoord3f(-t,t,-t); glVertex3f(-t,t,-t);
-  	glTexCoord3f(t,t,-t); glVertex3f(t,t,-t);
-  	glTexCoord3f(-t,t,t); glVertex3f(-t,t,t);
-  	glTexCoord3f(t,t,t); glVertex3f(t,t,t);
-  glEnd();
-
-  glBegin(GL_TRIANGLE_STRIP);			// Z Négatif
-  	glTexCoord3f(-t,-t,-t); glVertex3f(-t,-t,-t);
-  	glTexCoord3f(t, -t,-t); glVertex3f(t,-t,-t);
-  	glTexCoord3f(-t,t,-t); glVertex3f(-t,t,-t);
-  	glTexCoord3f(t,t,-t); glVertex3f(t,t,-t);
-  glEnd();
-
-  glBegin(GL_TRIANGLE_STRIP);			// Z Positif
-  	glTexCoord3f(-t,-t,t); glVertex3f(-t,-t,t);
-  	glTexCoord3f(-t,t,t); glVertex3f(-t,t,t);
-  	glTexCoord3f(t,-t,t); glVertex3f(t,-t,t);
-  	glTexCoord3f(t,t,t); glVertex3f(t,t,t);
-  glEnd();
-
-  glDepthMask(GL_TRUE);
-  glEnable(GL_DEPTH_TEST);
-  glEnable(GL_LIGHTING);
-  glDisable(GL_TEXTURE_CUBE_MAP_ARB);
+void drawSkybox(shaderStore * shaders, GLuint textureId) {
+  /* Size of the cube, the texture coordinates are the positions */
+  const float t = 500.0f;
+  const GLfloat vertices[] = {
+    -t, -t, -t,  -t, t, -t,  -t, t, t,  -t, -t, t,    // Negative X
+    t, -t, -t,  t, -t, t,  t, t, t,  t, t, -t,        // Positive X
+    -t, -t, -t,  -t, -t, t,  t, -t, t,  t, -t, -t,    // Negative Y
+    -t, t, -t,  t, t, -t,  t, t, t,  -t, t, t,        // Positive Y
+    -t, -t, -t,  t, -t, -t,  t, t, -t,  -t, t, -t,    // Negative Z
+    -t, -t, t,  -t, t, t,  t, t, t,  t, -t, t         // Positive Z
+  };
+
+  glUseProgram(shaders->skybox);
+  glBindTexture(GL_TEXTURE_CUBE_MAP, textureId);
+  glEnableVertexAttribArray(ATTRIBUTE_POSITION);
+  glVertexAttribPointer(ATTRIBUTE_POSITION, 3, GL_FLOAT, GL_FALSE, 0, vertices);
+  glDrawArrays(GL_QUADS, 0, 6 * 4);
+  glDisableVertexAttribArray(ATTRIBUTE_POSITION);
 }
 
 
-void drawHistory(textureStore texStore, mvstack moveStack) {
-  move * moves = head(moveStack, 13);
-  for (int i = 0; i < 13 && (int)moves[i] != -1; i++) {
+void drawHistory(shaderStore * shaders, textureStore texStore, mvstack moveStack) {
+  /* Position, texture coordinates and colour of the 4 corners of each quad */
+  GLfloat positions[HISTORY_LENGTH * 4 * 2];
+  GLfloat texCoords[HISTORY_LENGTH * 4 * 2];
+  GLubyte colours[HISTORY_LENGTH * 4 * 4];
+
+  move * moves = head(moveStack, HISTORY_LENGTH);
+  int count = 0;
+  for ( ; count < HISTORY_LENGTH && (int)moves[count] != -1; count++) {
     int t = 50;
-    int xOffset = i * 60 + 20;
+    int xOffset = count * 60 + 20;
     int yOffset = 20;
-    int alpha = 255 - (i * (255 / 13));
-    glColor4ub(255, 255, 255, alpha);
-    glBindTexture(GL_TEXTURE_2D, moveToTexture(texStore, moves[i]).id);
-    glBegin(GL_QUADS);
-    glTexCoord2i(0,1); glVertex2i(xOffset, yOffset);
-    glTexCoord2i(0,0); glVertex2i(xOffset, yOffset + t);
-    glTexCoord2i(1,0); glVertex2i(xOffset + t, yOffset + t);
-    glTexCoord2i(1,1); glVertex2i(xOffset + t, yOffset);
-    glEnd();
+    int alpha = 255 - (count * (255 / HISTORY_LENGTH));
+    GLfloat * region = moveToTexture(texStore, moves[count]).region;
+
+    GLfloat quadPositions[] = {xOffset, yOffset,
+                               xOffset, yOffset + t,
+                               xOffset + t, yOffset + t,
+                               xOffset + t, yOffset};
+    GLfloat quadTexCoords[] = {region[0], region[3],
+                               region[0], region[1],
+                               region[2], region[1],
+                               region[2], region[3]};
+    memcpy(positions + count * 8, quadPositions, sizeof(quadPositions));
+    memcpy(texCoords + count * 8, quadTexCoords, sizeof(quadTexCoords));
+    for (int vertexIndex = 0; vertexIndex < 4; vertexIndex++) {
+      GLubyte * colour = colours + (count * 4 + vertexIndex) * 4;
+      colour[0] = colour[1] = colour[2] = 255;
+      colour[3] = alpha;
+    }
   }
-
   free(moves);
-}
-
-
-void drawWinning(textureStore texStore) {
-  glBindTexture(GL_TEXTURE_2D, texStore.winner.id);
-  glColor4ub(255, 255, 255, 255);
-  glBegin(GL_QUADS);
-  glTexCoord2i(0,1); glVertex2i(5, 0);
-  glTexCoord2i(0,0); glVertex2i(5, 600);
-  glTexCoord2i(1,0); glVertex2i(795, 600);
-  glTexCoord2i(1,1); glVertex2i(795, 0);
-  glEnd();
-}
 
-
-void rotateFaceY(face * currentFace, float angle, bool ccw) {
-  float yRotation = ccw == true ? - angle : angle;
-  float sinRotation = sinf(yRotation);
-  float cosRotation = cosf(yRotation);
-  for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++) {
-    float x = currentFace->corners[cornerIndex].x;
-    float z = currentFace->corners[cornerIndex].z;
-
-    float xPrime = z * sinRotation + x * cosRotation;
-    float zPrime = z * cosRotation - x * sinRotation;
-
-    currentFace->corners[cornerIndex].x = xPrime;
-    currentFace->corners[cornerIndex].z = zPrime;
+  if (count == 0) {
+    return;
   }
 
-  float xNormal = currentFace->normal.x;
-  float zNormal = currentFace->normal.z;
+  /* Every glyph is in the atlas : the whole history is a single draw */
+  glBindTexture(GL_TEXTURE_2D, texStore.atlas);
+  drawOverlay(shaders, GL_QUADS, count * 4, positions, texCoords, colours);
+}
 
-  float xNormalPrime = zNormal * sinRotation + xNormal * cosRotation;
-  float zNormalPrime = zNormal * cosRotation - xNormal * sinRotation;
 
-  currentFace->normal.x = xNormalPrime;
-  currentFace->normal.z = zNormalPrime;
+void drawWinning(shaderStore * shaders, textureStore texStore) {
+  GLfloat positions[] = {5, 0, 5, 600, 795, 600, 795, 0};
+  GLfloat texCoords[] = {0, 1, 0, 0, 1, 0, 1, 1};
+  glBindTexture(GL_TEXTURE_2D, texStore.winner.id);
+  drawOverlay(shaders, GL_QUADS, 4, positions, texCoords, NULL);
 }
 
 
-void rotateFaceZ(face * currentFace, float angle, bool ccw) {
-  float zRotation = ccw == true ? - angle : angle;
-  float sinRotation = sinf(zRotation);
-  float cosRotation = cosf(zRotation);
-  for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++) {
-    float x = currentFace->corners[cornerIndex].x;
-    float y = currentFace->corners[cornerIndex].y;
-
-    float xPrime = x * cosRotation - y * sinRotation;
-    float yPrime = x * sinRotation + y * cosRotation;
+void generateRotationMatrix(GLfloat * matrix, enum Axis rotationAxis, float angle, bool ccw) {
+  float rotation = ccw == true ? - angle : angle;
+  float sinRotation = sinf(rotation);
+  float cosRotation = cosf(rotation);
 
-    currentFace->corners[cornerIndex].x = xPrime;
-    currentFace->corners[cornerIndex].y = yPrime;
+  /* Indices of the 2 coordinates that are modified by the rotation */
+  int first, second;
+  switch (rotationAxis) {
+    case X_AXIS:
+      first = 1;
+      second = 2;
+      break;
+    case Y_AXIS:
+      first = 2;
+      second = 0;
+      break;
+    default:
+      first = 0;
+      second = 1;
+      break;
   }
 
-  float xNormal = currentFace->normal.x;
-  float yNormal = currentFace->normal.y;
-
-  float xNormalPrime = xNormal * cosRotation - yNormal * sinRotation;
-  float yNormalPrime = xNormal * sinRotation + yNormal * cosRotation;
-
-  currentFace->normal.x = xNormalPrime;
-  currentFace->normal.y = yNormalPrime;
+  identityMatrix(matrix);
+  matrix[first * 4 + first] = cosRotation;
+  matrix[first * 4 + second] = sinRotation;
+  matrix[second * 4 + first] = - sinRotation;
+  matrix[second * 4 + second] = cosRotation;
 }
 
 
-void rotateFaceX(face * currentFace, float angle, bool ccw) {
-  float xRotation = ccw == true ? - angle : angle;
-  float sinRotation = sinf(xRotation);
-  float cosRotation = cosf(xRotation);
-  for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++) {
-    float z = currentFace->corners[cornerIndex].z;
-    float y = currentFace->corners[cornerIndex].y;
+void rotateCube(cube3d * currentCube, const GLfloat * rotation) {
+  /* The rotation is applied after the previous ones : M = R * M */
+  multiplyMatrices(currentCube->modelMatrix, rotation, currentCube->modelMatrix);
+}
 
-    float zPrime = y * sinRotation + z * cosRotation;
-    float yPrime = y * cosRotation - z * sinRotation;
 
-    currentFace->corners[cornerIndex].z = zPrime;
-    currentFace->corners[cornerIndex].y = yPrime;
+void snapCubeRotation(cube3d * currentCube) {
+  for (int index = 0; index < 16; index++) {
+    currentCube->modelMatrix[index] = roundf(currentCube->modelMatrix[index]);
   }
-
-  float zNormal = currentFace->normal.z;
-  float yNormal = currentFace->normal.y;
-
-  float zNormalPrime = yNormal * sinRotation + zNormal * cosRotation;
-  float yNormalPrime = yNormal * cosRotation - zNormal * sinRotation;
-
-  currentFace->normal.z = zNormalPrime;
-  currentFace->normal.y = yNormalPrime;
 }
 
 
@@ -771,6 +958,8 @@ texture moveToTexture(textureStore texStore, move command) {
 }
 
 void destroyRubikCube(rubikcube * aCube) {
+    glDeleteBuffers(1, &aCube->vertexBuffer);
+    free(aCube->vertices);
     free(aCube->cubes);
     free(aCube);
     return;
@@ -10,7 +10,7 @@
 
 
 #include <GL/gl.h>
-#include <GL/glu.h>
+#include <GL/glext.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <math.h>
@@ -19,9 +19,22 @@
 #include <stdlib.h>
 #include "../model/cube.h"
 #include "../controller/commandQueue.h"
+#include "loader.h"
+#include "assets.h"
+#include "shaders.h"
 
 
 #define PI 3.141592653589793
+#define VERTEX_FLOATS 9     /**< Position, normal and colour of a vertex */
+#define FACE_VERTICES 6     /**< A face is drawn as 2 triangles */
+#define CUBE_VERTICES (6 * FACE_VERTICES)
+#define ATLAS_GLYPHS 32     /**< Number of glyphs packed in the atlas */
+#define ATLAS_COLUMNS 8     /**< Number of glyphs on a row of the atlas */
+#define ATLAS_CELL_SIZE 256 /**< Size of a glyph in the atlas, in pixels */
+#define ATLAS_MAX_LEVEL 3   /**< Last mipmap level, low enough for the glyphs
+                            not to bleed into each other */
+#define HELP_GLYPH_SIZE 50  /**< Size of the glyphs in the help window */
+#define HISTORY_LENGTH 13   /**< Number of moves shown in the history */
 
 
 /**
@@ -73,6 +86,12 @@ typedef struct _transform {
 typedef struct _cube3d {
   face faces[6];            /**< The faces of the cube */
   transform cubeTransform;  /**< The position, rotation and scale of the cube */
+  int meshOffset;           /**< Index of the first vertex of the cube in the
+                            vertex buffer of the rubik's cube */
+  bool meshChanged;         /**< True if the faces changed since the last
+                            upload to the vertex buffer */
+  GLfloat modelMatrix[16];  /**< The rotation of the cube since the start,
+                            column-major as expected by OpenGL */
 } cube3d;
 
 
@@ -81,17 +100,31 @@ typedef struct _cube3d {
  */
 typedef struct _rubikcube {
   cube3d **** cubes;        /**< A 3x3x3 matrix of pointers to cubes */
+  GLuint vertexBuffer;      /**< The OpenGL's buffer holding the whole mesh */
+  GLfloat * vertices;       /**< A copy of the mesh, used to build the uploads */
 } rubikcube;
 
 
 /**
- * A structure holding the ids of the OpenGL's textures for the instructions
+ * A structure holding the OpenGL's id and SDL's surface for a texture
+ */
+typedef struct _texture {
+  GLuint id;              /**< Id of the OpenGL's texture (the atlas for
+                          a glyph) */
+  GLfloat region[4];      /**< Region of the image in the OpenGL's texture :
+                          left, top, right and bottom texture coordinates */
+  SDL_Surface * surface;  /**< The SDL surface of the texture */
+} texture;
+
+
+/**
+ * A structure holding the textures of the instructions
  */
 typedef struct _instructionTextures {
-  GLuint id;        /**< The ID for the base texture */
-  GLuint ccwId;     /**< The ID for the inverted texture */
-  GLuint id2;       /**< The ID for the double texture */
-  GLuint ccwId2;    /**< The ID for the double inverted texture */
+  texture glyph;        /**< The base texture */
+  texture ccwGlyph;     /**< The inverted texture */
+  texture glyph2;       /**< The double texture */
+  texture ccwGlyph2;    /**< The double inverted texture */
 } instructionTextures;
 
 
@@ -107,27 +140,15 @@ typedef struct _instructionDisplay {
 
 
 /**
- * A structure for the quad on which each history's element is displayed
- */
-typedef struct _historyDisplay {
-  GLuint id;            /**< The id of the OpenGL's texture */
-  vector3 corners[4];   /**< The list of corners */
-} historyDisplay;
-
-
-/**
- * A structure holding the OpenGL's id and SDL's surface for a texture
- */
-typedef struct _texture {
-  GLuint id;              /**< Id of the OpenGL's texture */
-  SDL_Surface * surface;  /**< The SDL surface of the texture */
-} texture;
-
-
-/**
- * A structure holding all the textures
+ * A structure holding all the textures. The instructions and moves glyphs are
+ * packed in a single atlas, the skybox and the winning picture have their own
+ * textures.
  */
 typedef struct _textureStore {
+  GLuint atlas;       /**< The texture holding all the glyphs */
+  bool helpGlyphsLoaded; /**< True once the surfaces of the glyphs are
+                         loaded for the help window */
+
   texture up;         /**< The U instruction */
   texture upi;        /**< The Ui instruction */
   texture upid;       /**< The ui instruction */
@@ -176,6 +197,16 @@ typedef struct _textureStore {
 } textureStore;
 
 
+/**
+ * This enum is used to designate the axis of a rotation
+ */
+enum Axis {
+  X_AXIS,
+  Y_AXIS,
+  Z_AXIS
+};
+
+
 /**
  * This enum is used to designate the face being built or animated
  */
@@ -191,7 +222,8 @@ enum FaceType {
 
 
 /**
- * Generate a rubikcube structure with everything (cubes and such)
+ * Generate a rubikcube structure with everything (cubes and such). The mesh is
+ * uploaded to a vertex buffer, so an OpenGL context must be current.
  * @return A pointer to the newly created rubikcube
  */
 rubikcube * generateRubikCube();
@@ -222,6 +254,34 @@ face generateFace(transform cubeTransform, enum FaceType faceType);
 void generateTexture(texture * newTexture, const char * url);
 
 
+/**
+ * Pack glyphs in a single texture. Each glyph is decoded and scaled down to a
+ * cell of ATLAS_CELL_SIZE pixels on the worker threads, and gets the id of the
+ * atlas and its region in it. The atlas is uploaded on the calling thread.
+ * @param atlasId The ID of the atlas texture
+ * @param glyphs  The glyphs
+ * @param urls    The paths to the images of the glyphs
+ * @param count   The number of glyphs, ATLAS_GLYPHS at most
+ */
+void generateAtlas(GLuint * atlasId, texture ** glyphs, const char ** urls, int count);
+
+
+/**
+ * Load the surfaces of the glyphs, scaled down to HELP_GLYPH_SIZE pixels for
+ * the help window. Does nothing if they are already loaded.
+ * @param texStore The texture store
+ */
+void loadHelpGlyphs(textureStore * texStore);
+
+
+/**
+ * Generate a texture on its first use. Does nothing if it is already loaded.
+ * @param lazyTexture The texture, with a NULL surface if not loaded
+ * @param url         The path to the image
+ */
+void requireTexture(texture * lazyTexture, const char * url);
+
+
 /**
  * Generate a cubemap texture
  * @param textureId The ID of the cubemap texture
@@ -230,7 +290,9 @@ void generateCubemapTexture(GLuint * textureId);
 
 
 /**
- * Generate the texture store
+ * Generate the texture store. The images are decoded on worker threads, the
+ * winning picture and the surfaces for the help window are loaded on their
+ * first use.
  * @return A texture store
  */
 textureStore generateTextureStore();
@@ -253,107 +315,91 @@ void setCubeColour(colour newColour, cube3d * selectedCube);
 
 
 /**
- * Draw the cubes of a Rubik's cube
+ * Draw the cubes of a Rubik's cube from the vertex buffer, each cube with its
+ * own model matrix. The cubes which colours changed since the last frame are
+ * uploaded to the vertex buffer first.
+ * @param shaders   The shader store
  * @param rubikCube The Rubik's cube to display
  */
-void drawCubes(rubikcube * rubikCube);
+void drawCubes(shaderStore * shaders, rubikcube * rubikCube);
 
 
 /**
- * Draw a cube on the screen
- * @param drawnCube The cube we will draw
- * @param debug     true to display the cube in magenta
- */
-void drawCube(cube3d drawnCube, bool debug);
-
-
-/**
- * Draw a face (basically a quad). Used by drawCube.
- * @param drawnFace The face to be drawn
- * @param debug     true to display the face in magenta
- */
-void drawFace(face drawnFace, bool debug);
-
-
-/**
- * Draw the instructions
+ * Draw the 6 instructions floating in front of the faces, in a single call
+ * @param shaders      The shader store
  * @param instructions A list of instructions to display
  * @param keyShortcut  An int representing the states of Shift and Ctrl
  */
-void drawInstructions(instructionDisplay * instructions, int keyShortcut);
-
-
-/**
- * Draw an instruction floating in front of a face
- * @param drawnInstruction The image structure for the instruction's image
- * @param ccw              Is the counterclockiwse modifier active ?
- * @param two              Is the double modifier active ?
- */
-void drawInstruction(instructionDisplay drawnInstruction, int keyShortcut);
+void drawInstructions(shaderStore * shaders, instructionDisplay * instructions, int keyShortcut);
 
 
 /**
- * Draw the XYZ or XYZi instruction
+ * Draw the XYZ or XYZi instruction. The overlay program must be in use.
+ * @param shaders  The shader store
  * @param texStore The texture store to use
  * @param reversed True to show XYZi
  */
-void drawXYZInstruction(textureStore texStore, bool reversed);
+void drawXYZInstruction(shaderStore * shaders, textureStore texStore, bool reversed);
 
 
 /**
- * Draw the skybox
+ * Draw the skybox, on the far plane
+ * @param shaders   The shader store
  * @param textureId The ID of the skybox
  */
-void drawSkybox(GLuint textureId);
+void drawSkybox(shaderStore * shaders, GLuint textureId);
 
 
 /**
- * Draw the history
+ * Draw the last HISTORY_LENGTH moves of the history, in a single call. The
+ * overlay program must be in use.
+ * @param shaders   The shader store
  * @param texStore  The texture store to use
  * @param moveStack A list of moves to display
  */
-void drawHistory(textureStore texStore, mvstack moveStack);
+void drawHistory(shaderStore * shaders, textureStore texStore, mvstack moveStack);
 
 
 /**
- * Draw the winning screen
+ * Draw the winning screen. The overlay program must be in use.
+ * @param shaders  The shader store
  * @param texStore The texture store to use
  */
-void drawWinning(textureStore texStore);
+void drawWinning(shaderStore * shaders, textureStore texStore);
 
 
 /**
- * Apply a rotation on a face around the Y axis
- * @param currentFace The face to rotate
- * @param angle       The angle for the rotation
- * @param ccw         True to set the rotation to counterclockwise;
+ * Generate the matrix of a rotation around an axis
+ * @param matrix       The 16 floats of the matrix to fill, column-major
+ * @param rotationAxis The axis of the rotation
+ * @param angle        The angle for the rotation
+ * @param ccw          True to set the rotation to counterclockwise
  */
-void rotateFaceY(face * currentFace, float angle, bool ccw);
+void generateRotationMatrix(GLfloat * matrix, enum Axis rotationAxis, float angle, bool ccw);
 
 
 /**
- * Apply a rotation on a face around the Z axis
- * @param currentFace The face to rotate
- * @param angle       The angle for the rotation
- * @param ccw         True to set the rotation to counterclockwise;
+ * Apply a rotation to a cube by multiplying its model matrix
+ * @param currentCube The cube to rotate
+ * @param rotation    The rotation matrix, from generateRotationMatrix()
  */
-void rotateFaceZ(face * currentFace, float angle, bool ccw);
+void rotateCube(cube3d * currentCube, const GLfloat * rotation);
 
 
 /**
- * Apply a rotation on a face around the X axis
- * @param currentFace The face to rotate
- * @param angle       The angle for the rotation
- * @param ccw         True to set the rotation to counterclockwise;
+ * Round the model matrix of a cube to the nearest quarter turn. Must be called
+ * at the end of each animation so that the floating point errors don't build
+ * up over the game.
+ * @param currentCube The cube to snap
  */
-void rotateFaceX(face * currentFace, float angle, bool ccw);
+void snapCubeRotation(cube3d * currentCube);
 
 
 /**
  * Translate a move to a texture. Used to display history.
  * @param  texStore The structure where the textures are stored
  * @param  command  The move command
- * @return          The ID of the OpenGL's texture
+ * @return          The texture, with the region of the move in the atlas
  */
 texture moveToTexture(textureStore texStore, move command);
 
@@ -0,0 +1,60 @@
+/**
+ * @file loader.c
+ */
+
+
+#include "loader.h"
+
+
+/**
+ * The jobs shared between the workers
+ */
+typedef struct _jobQueue {
+  int count;                                /**< Number of jobs */
+  SDL_atomic_t next;                        /**< Next job to be taken */
+  void (* job)(void * data, int index);     /**< The function of the jobs */
+  void * data;                              /**< Data of the jobs */
+} jobQueue;
+
+
+/**
+ * Take jobs until there is none left
+ * @param  queue The job queue
+ * @return       0
+ */
+static int worker(void * queue) {
+  jobQueue * jobs = (jobQueue *)queue;
+  int index;
+  while ((index = SDL_AtomicAdd(&jobs->next, 1)) < jobs->count) {
+    jobs->job(jobs->data, index);
+  }
+  return 0;
+}
+
+
+void runParallel(int count, void (* job)(void * data, int index), void * data) {
+  jobQueue jobs;
+  jobs.count = count;
+  SDL_AtomicSet(&jobs.next, 0);
+  jobs.job = job;
+  jobs.data = data;
+
+  /* The calling thread works too, the others are helpers */
+  int threadCount = SDL_GetCPUCount() - 1;
+  threadCount = threadCount < LOADER_MAX_THREADS - 1 ? threadCount : LOADER_MAX_THREADS - 1;
+  threadCount = threadCount < count - 1 ? threadCount : count - 1;
+
+  SDL_Thread * threads[LOADER_MAX_THREADS];
+  int started = 0;
+  for ( ; started < threadCount; started++) {
+    threads[started] = SDL_CreateThread(&worker, "loader", &jobs);
+    if (threads[started] == NULL) {
+      break;
+    } // No more threads : the remaining workers will take more jobs
+  }
+
+  worker(&jobs);
+  for (int threadIndex = 0; threadIndex < started; threadIndex++) {
+    SDL_WaitThread(threads[threadIndex], NULL);
+  }
+}
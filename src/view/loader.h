@@ -0,0 +1,30 @@
+/**
+ * @file loader.h
+ * Defines a small pool of worker threads to decode the assets in parallel
+ *
+ * Only the decoding (and the CPU work on the decoded pixels) may run on the
+ * workers : the OpenGL uploads must stay on the thread owning the context.
+ */
+
+
+#ifndef LOADER_H
+#define LOADER_H
+
+
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+
+
+#define LOADER_MAX_THREADS 8  /**< Maximum number of worker threads */
+
+
+/**
+ * Run a job for every index between 0 and count - 1, spread over worker
+ * threads, and wait for all of them. The jobs must be independent.
+ * @param count The number of jobs
+ * @param job   The function running a job
+ * @param data  Data passed to every job
+ */
+void runParallel(int count, void (* job)(void * data, int index), void * data);
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file matrix.c
+ */
+
+
+#include "matrix.h"
+
+
+void identityMatrix(GLfloat * matrix) {
+  for (int index = 0; index < 16; index++) {
+    matrix[index] = index % 5 == 0 ? 1 : 0;
+  }
+}
+
+
+void multiplyMatrices(GLfloat * result, const GLfloat * left, const GLfloat * right) {
+  GLfloat product[16];
+  for (int column = 0; column < 4; column++) {
+    for (int row = 0; row < 4; row++) {
+      float sum = 0;
+      for (int index = 0; index < 4; index++) {
+        sum += left[index * 4 + row] * right[column * 4 + index];
+      }
+      product[column * 4 + row] = sum;
+    }
+  }
+  memcpy(result, product, sizeof(product));
+}
+
+
+void perspectiveMatrix(GLfloat * matrix, float fovy, float aspect, float near, float far) {
+  float focal = 1 / tanf(fovy * 3.141592653589793 / 360);
+  memset(matrix, 0, 16 * sizeof(GLfloat));
+  matrix[0] = focal / aspect;
+  matrix[5] = focal;
+  matrix[10] = (far + near) / (near - far);
+  matrix[11] = -1;
+  matrix[14] = 2 * far * near / (near - far);
+}
+
+
+/**
+ * Normalize a vector of 3 floats
+ * @param vector The vector
+ */
+static void normalize(GLfloat * vector) {
+  float length = sqrtf(vector[0] * vector[0] + vector[1] * vector[1]
+                       + vector[2] * vector[2]);
+  for (int index = 0; index < 3; index++) {
+    vector[index] /= length;
+  }
+}
+
+
+/**
+ * Compute the cross product of two vectors of 3 floats
+ * @param result The product
+ * @param first  The first vector
+ * @param second The second vector
+ */
+static void cross(GLfloat * result, const GLfloat * first, const GLfloat * second) {
+  result[0] = first[1] * second[2] - first[2] * second[1];
+  result[1] = first[2] * second[0] - first[0] * second[2];
+  result[2] = first[0] * second[1] - first[1] * second[0];
+}
+
+
+void lookAtMatrix(GLfloat * matrix, const GLfloat * eye, const GLfloat * center, const GLfloat * up) {
+  /* Forward, side and true up vectors of the camera */
+  GLfloat forward[3] = {center[0] - eye[0], center[1] - eye[1], center[2] - eye[2]};
+  normalize(forward);
+  GLfloat side[3];
+  cross(side, forward, up);
+  normalize(side);
+  GLfloat top[3];
+  cross(top, side, forward);
+
+  identityMatrix(matrix);
+  for (int index = 0; index < 3; index++) {
+    matrix[index * 4] = side[index];
+    matrix[index * 4 + 1] = top[index];
+    matrix[index * 4 + 2] = -forward[index];
+  }
+  for (int row = 0; row < 3; row++) {
+    matrix[12 + row] = - (matrix[row] * eye[0] + matrix[4 + row] * eye[1]
+                          + matrix[8 + row] * eye[2]);
+  }
+}
+
+
+void orthoMatrix(GLfloat * matrix, float left, float right, float bottom, float top) {
+  identityMatrix(matrix);
+  matrix[0] = 2 / (right - left);
+  matrix[5] = 2 / (top - bottom);
+  matrix[10] = -1;
+  matrix[12] = - (right + left) / (right - left);
+  matrix[13] = - (top + bottom) / (top - bottom);
+}
@@ -0,0 +1,67 @@
+/**
+ * @file matrix.h
+ * Defines the 4x4 matrices given to the shaders
+ *
+ * The matrices are arrays of 16 floats, column-major as expected by OpenGL.
+ * They replace the matrix stack of the fixed pipeline (gluPerspective(),
+ * gluLookAt(), gluOrtho2D() and glMultMatrixf()).
+ */
+
+
+#ifndef MATRIX_H
+#define MATRIX_H
+
+
+#include <math.h>
+#include <string.h>
+#include <GL/gl.h>
+
+
+/**
+ * Set a matrix to the identity
+ * @param matrix The matrix to fill
+ */
+void identityMatrix(GLfloat * matrix);
+
+
+/**
+ * Multiply two matrices. The result may be one of the operands.
+ * @param result The product, left * right
+ * @param left   The matrix applied last
+ * @param right  The matrix applied first
+ */
+void multiplyMatrices(GLfloat * result, const GLfloat * left, const GLfloat * right);
+
+
+/**
+ * Generate a perspective projection, as gluPerspective()
+ * @param matrix The matrix to fill
+ * @param fovy   The vertical field of view, in degrees
+ * @param aspect The width of the view divided by its height
+ * @param near   The distance of the near plane
+ * @param far    The distance of the far plane
+ */
+void perspectiveMatrix(GLfloat * matrix, float fovy, float aspect, float near, float far);
+
+
+/**
+ * Generate the view of a camera, as gluLookAt()
+ * @param matrix The matrix to fill
+ * @param eye    The position of the camera
+ * @param center The point the camera looks at
+ * @param up     The direction of the top of the view
+ */
+void lookAtMatrix(GLfloat * matrix, const GLfloat * eye, const GLfloat * center, const GLfloat * up);
+
+
+/**
+ * Generate an orthographic projection, as gluOrtho2D()
+ * @param matrix The matrix to fill
+ * @param left   The left side of the view
+ * @param right  The right side of the view
+ * @param bottom The bottom side of the view
+ * @param top    The top side of the view
+ */
+void orthoMatrix(GLfloat * matrix, float left, float right, float bottom, float top);
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file offscreen.c
+ */
+
+
+#include "offscreen.h"
+
+
+/**
+ * Open the EGL display, preferring the surfaceless platform of Mesa
+ * @return The initialized display
+ */
+static EGLDisplay openDisplay() {
+  EGLDisplay display = EGL_NO_DISPLAY;
+
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+  PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+    (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+  if (getPlatformDisplay != NULL) {
+    display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                 EGL_DEFAULT_DISPLAY, NULL);
+  }
+#endif
+
+  EGLint major, minor;
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+      exitFatal("in openDisplay(), unable to initialize EGL");
+    }
+  } // No surfaceless platform : fall back on the default display
+
+  return display;
+}
+
+
+/**
+ * Create a framebuffer with a colour renderbuffer and optionally a depth one
+ * @param framebuffer  The framebuffer to create
+ * @param colourBuffer The colour renderbuffer to create
+ * @param depthBuffer  The depth renderbuffer to create, NULL for none
+ * @param samples      Number of samples, 0 for no multisampling
+ * @param width        Width of the buffers
+ * @param height       Height of the buffers
+ */
+static void generateFramebuffer(GLuint * framebuffer, GLuint * colourBuffer, GLuint * depthBuffer, int samples, int width, int height) {
+  glGenFramebuffers(1, framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, *framebuffer);
+
+  glGenRenderbuffers(1, colourBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, *colourBuffer);
+  glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, width, height);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, *colourBuffer);
+
+  if (depthBuffer != NULL) {
+    glGenRenderbuffers(1, depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, *depthBuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                              GL_RENDERBUFFER, *depthBuffer);
+  }
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    exitFatal("in generateFramebuffer(), incomplete framebuffer");
+  }
+}
+
+
+offscreenTarget * generateOffscreenTarget(int width, int height, int samples) {
+  offscreenTarget * self = (offscreenTarget *) ec_malloc(sizeof(offscreenTarget));
+  self->width = width;
+  self->height = height;
+  self->pixels = (unsigned char *) ec_malloc(width * height * 4);
+  self->planes = (unsigned char *) ec_malloc(width * height
+                                             + 2 * ((width + 1) / 2) * ((height + 1) / 2));
+
+  /* Create a desktop OpenGL context, the view uses the fixed pipeline */
+  self->display = openDisplay();
+  EGLint configAttributes[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_ALPHA_SIZE, 8,
+    EGL_DEPTH_SIZE, 24,
+    EGL_NONE
+  };
+  EGLConfig config;
+  EGLint configCount = 0;
+  if (!eglChooseConfig(self->display, configAttributes, &config, 1, &configCount)
+      || configCount == 0) {
+    exitFatal("in generateOffscreenTarget(), no EGL config for OpenGL");
+  }
+
+  eglBindAPI(EGL_OPENGL_API);
+  self->context = eglCreateContext(self->display, config, EGL_NO_CONTEXT, NULL);
+  if (self->context == EGL_NO_CONTEXT
+      || !eglMakeCurrent(self->display, EGL_NO_SURFACE, EGL_NO_SURFACE, self->context)) {
+    exitFatal("in generateOffscreenTarget(), unable to create the context");
+  } // Surfaceless context : everything is drawn in the framebuffers below
+
+  /* Draw in a multisampled framebuffer, resolved in a plain one to be read */
+  generateFramebuffer(&self->framebuffers[1], &self->renderbuffers[2], NULL,
+                      0, width, height);
+  generateFramebuffer(&self->framebuffers[0], &self->renderbuffers[0],
+                      &self->renderbuffers[1], samples, width, height);
+  glViewport(0, 0, width, height);
+
+  return self;
+}
+
+
+void readOffscreenFrame(offscreenTarget * self) {
+  int width = self->width;
+  int height = self->height;
+
+  /* Resolve the antialiasing */
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, self->framebuffers[0]);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, self->framebuffers[1]);
+  glBlitFramebuffer(0, 0, width, height, 0, 0, width, height,
+                    GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+  /* OpenGL gives the bottom row first : read the rows upside down */
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, self->framebuffers[1]);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  for (int row = 0; row < height; row++) {
+    glReadPixels(0, height - 1 - row, width, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                 self->pixels + row * width * 4);
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, self->framebuffers[0]);
+}
+
+
+bool writeFramePNG(offscreenTarget * self, const char * path) {
+  SDL_Surface * surface = SDL_CreateRGBSurfaceFrom(self->pixels,
+                                                   self->width, self->height,
+                                                   32, self->width * 4,
+                                                   0x000000ff, 0x0000ff00,
+                                                   0x00ff0000, 0xff000000);
+  if (surface == NULL) {
+    return false;
+  }
+  bool written = IMG_SavePNG(surface, path) == 0;
+  SDL_FreeSurface(surface);
+  return written;
+}
+
+
+void writeY4MHeader(offscreenTarget * self, FILE * stream, int fps) {
+  fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+          self->width, self->height, fps);
+}
+
+
+bool writeFrameY4M(offscreenTarget * self, FILE * stream) {
+  int width = self->width;
+  int height = self->height;
+  int chromaWidth = (width + 1) / 2;
+  int chromaHeight = (height + 1) / 2;
+  unsigned char * lumaPlane = self->planes;
+  unsigned char * bluePlane = lumaPlane + width * height;
+  unsigned char * redPlane = bluePlane + chromaWidth * chromaHeight;
+
+  /* BT.601 studio range, the chroma is averaged on blocks of 2x2 pixels */
+  for (int row = 0; row < height; row++) {
+    const unsigned char * pixel = self->pixels + row * width * 4;
+    for (int column = 0; column < width; column++, pixel += 4) {
+      lumaPlane[row * width + column] =
+        16 + ((66 * pixel[0] + 129 * pixel[1] + 25 * pixel[2] + 128) >> 8);
+    }
+  }
+  for (int row = 0; row < chromaHeight; row++) {
+    for (int column = 0; column < chromaWidth; column++) {
+      int red = 0, green = 0, blue = 0;
+      for (int corner = 0; corner < 4; corner++) {
+        int pixelRow = 2 * row + corner / 2;
+        int pixelColumn = 2 * column + corner % 2;
+        pixelRow = pixelRow < height ? pixelRow : height - 1;
+        pixelColumn = pixelColumn < width ? pixelColumn : width - 1;
+        const unsigned char * pixel = self->pixels + (pixelRow * width + pixelColumn) * 4;
+        red += pixel[0];
+        green += pixel[1];
+        blue += pixel[2];
+      }
+      red /= 4;
+      green /= 4;
+      blue /= 4;
+      bluePlane[row * chromaWidth + column] =
+        128 + ((-38 * red - 74 * green + 112 * blue + 128) >> 8);
+      redPlane[row * chromaWidth + column] =
+        128 + ((112 * red - 94 * green - 18 * blue + 128) >> 8);
+    }
+  }
+
+  size_t frameSize = width * height + 2 * chromaWidth * chromaHeight;
+  return fputs("FRAME\n", stream) != EOF
+    && fwrite(self->planes, 1, frameSize, stream) == frameSize;
+}
+
+
+void destroyOffscreenTarget(offscreenTarget * self) {
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glDeleteFramebuffers(2, self->framebuffers);
+  glDeleteRenderbuffers(3, self->renderbuffers);
+  eglMakeCurrent(self->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglDestroyContext(self->display, self->context);
+  eglTerminate(self->display);
+  free(self->pixels);
+  free(self->planes);
+  free(self);
+}
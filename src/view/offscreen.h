@@ -0,0 +1,100 @@
+/**
+ * @file offscreen.h
+ * Defines an offscreen render target, to render the view without any display
+ *
+ * The OpenGL context is created through EGL on the Mesa surfaceless platform
+ * when it is available (no X server nor GPU needed, llvmpipe renders on the
+ * CPU), and on the default display otherwise. The scene is drawn in a
+ * multisampled framebuffer object and resolved in a plain one to be read back.
+ */
+
+
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include "../controller/errorController.h"
+#include "../controller/utils.h"
+
+
+#define OFFSCREEN_SAMPLES 4   /**< Default number of samples for the
+                              antialiasing */
+
+
+/**
+ * A structure holding an offscreen OpenGL context and its framebuffers
+ */
+typedef struct _offscreenTarget {
+  EGLDisplay display;         /**< The EGL display */
+  EGLContext context;         /**< The OpenGL context */
+  GLuint framebuffers[2];     /**< Multisampled and resolved framebuffers */
+  GLuint renderbuffers[3];    /**< Multisampled colour and depth, resolved
+                              colour */
+  int width;                  /**< Width of the image, in pixels */
+  int height;                 /**< Height of the image, in pixels */
+  unsigned char * pixels;     /**< Last frame read, RGBA, top row first */
+  unsigned char * planes;     /**< Last frame converted to YUV 4:2:0 */
+} offscreenTarget;
+
+
+/**
+ * Create an OpenGL context without any window and make it current. Every
+ * draw call goes to the offscreen framebuffer afterwards. Exits on failure.
+ * @param  width   Width of the image, in pixels
+ * @param  height  Height of the image, in pixels
+ * @param  samples Number of samples for the antialiasing, 0 to disable it
+ * @return         A pointer to the new target
+ */
+offscreenTarget * generateOffscreenTarget(int width, int height, int samples);
+
+
+/**
+ * Resolve the antialiasing of the frame drawn and copy it in pixels
+ * @param self The target
+ */
+void readOffscreenFrame(offscreenTarget * self);
+
+
+/**
+ * Write the last frame read in a PNG file
+ * @param  self The target
+ * @param  path Path of the file
+ * @return      True on success
+ */
+bool writeFramePNG(offscreenTarget * self, const char * path);
+
+
+/**
+ * Write the header of a YUV4MPEG2 stream
+ * @param self   The target
+ * @param stream The stream (a file or a pipe)
+ * @param fps    Number of frames per second
+ */
+void writeY4MHeader(offscreenTarget * self, FILE * stream, int fps);
+
+
+/**
+ * Write the last frame read in a YUV4MPEG2 stream, as uncompressed 4:2:0
+ * @param  self   The target
+ * @param  stream The stream, its header already written
+ * @return        True on success
+ */
+bool writeFrameY4M(offscreenTarget * self, FILE * stream);
+
+
+/**
+ * Destroy the framebuffers and the context of a target
+ * @param self The target
+ */
+void destroyOffscreenTarget(offscreenTarget * self);
+
+#endif
@@ -0,0 +1,261 @@
+/**
+ * @file profiler.c
+ */
+
+
+#include "profiler.h"
+
+
+/**
+ * Names of the steps, for the CSV file
+ */
+static const char * sectionNames[PROFILE_SECTIONS] = {
+  "animations", "events", "help", "skybox", "cubes", "overlays", "swap"
+};
+
+
+/**
+ * Colours of the steps in the overlay
+ */
+static const GLubyte sectionColours[PROFILE_SECTIONS][3] = {
+  {230, 159, 0}, {86, 180, 233}, {0, 158, 115}, {240, 228, 66},
+  {0, 114, 178}, {213, 94, 0}, {204, 121, 167}
+};
+
+
+/**
+ * Segments lit for the digits 0 to 9, then the letter P. The bits are the
+ * top, top right, bottom right, bottom, bottom left, top left and middle
+ * segments.
+ */
+static const unsigned char segmentDigits[11] = {
+  0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F, 0x73
+};
+
+
+frameProfiler * generateProfiler() {
+  frameProfiler * self = (frameProfiler *)calloc(1, sizeof(frameProfiler));
+  self->frequency = SDL_GetPerformanceFrequency();
+  self->lastMark = SDL_GetPerformanceCounter();
+  return self;
+}
+
+
+void startProfiledFrame(frameProfiler * self) {
+  for (int section = 0; section < PROFILE_SECTIONS; section++) {
+    self->current[section] = 0;
+  }
+  self->lastMark = SDL_GetPerformanceCounter();
+}
+
+
+void markProfiledSection(frameProfiler * self, enum ProfileSection section) {
+  Uint64 now = SDL_GetPerformanceCounter();
+  self->current[section] += (float)(now - self->lastMark) * 1000 / self->frequency;
+  self->lastMark = now;
+}
+
+
+void skipProfiledTime(frameProfiler * self) {
+  self->lastMark = SDL_GetPerformanceCounter();
+}
+
+
+/**
+ * Get the bucket of the histogram of a frame time
+ * @param  frameTime The frame time, in milliseconds
+ * @return           The index of the bucket, the last one for long frames
+ */
+static int bucketOf(float frameTime) {
+  int bucket = frameTime / PROFILE_BUCKET_WIDTH;
+  return bucket < PROFILE_BUCKETS ? bucket : PROFILE_BUCKETS - 1;
+}
+
+
+void endProfiledFrame(frameProfiler * self) {
+  float * frame = self->frames[self->next];
+
+  /* The oldest frame leaves the window when it is full */
+  if (self->count == PROFILE_FRAMES) {
+    self->histogram[bucketOf(frame[PROFILE_SECTIONS])]--;
+  } else {
+    self->count++;
+  }
+
+  float total = 0;
+  for (int section = 0; section < PROFILE_SECTIONS; section++) {
+    frame[section] = self->current[section];
+    total += self->current[section];
+  }
+  frame[PROFILE_SECTIONS] = total;
+  self->histogram[bucketOf(total)]++;
+  self->next = (self->next + 1) % PROFILE_FRAMES;
+}
+
+
+float profiledPercentile(frameProfiler * self, float fraction) {
+  int rank = fraction * self->count;
+  rank = rank < self->count ? rank : self->count - 1;
+
+  int seen = 0;
+  for (int bucket = 0; bucket < PROFILE_BUCKETS; bucket++) {
+    seen += self->histogram[bucket];
+    if (seen > rank) {
+      return (bucket + 1) * PROFILE_BUCKET_WIDTH;
+    }
+  }
+  return 0;
+}
+
+
+/**
+ * Vertices of the overlay, a position and a colour each
+ */
+typedef struct _profilerVertices {
+  GLfloat positions[PROFILE_VERTICES][2]; /**< Positions, in pixels */
+  GLubyte colours[PROFILE_VERTICES][4];   /**< RGBA colours */
+  int count;                              /**< Number of vertices */
+} profilerVertices;
+
+
+/**
+ * Add a vertex to the overlay, dropped if the arrays are full
+ * @param vertices The vertices
+ * @param x        Abscissa of the vertex
+ * @param y        Ordinate of the vertex
+ * @param colour   RGBA colour of the vertex
+ */
+static void addVertex(profilerVertices * vertices, GLfloat x, GLfloat y, const GLubyte * colour) {
+  if (vertices->count == PROFILE_VERTICES) {
+    return;
+  }
+  vertices->positions[vertices->count][0] = x;
+  vertices->positions[vertices->count][1] = y;
+  memcpy(vertices->colours[vertices->count], colour, 4);
+  vertices->count++;
+}
+
+
+/**
+ * Add the lines of a text with segments, as on a digital clock
+ * @param vertices The vertices of the lines
+ * @param text     The text, made of digits, dots, spaces and P letters
+ * @param x        Left side of the text
+ * @param y        Bottom side of the text
+ * @param size     Height of a character
+ */
+static void addSegments(profilerVertices * vertices, const char * text, GLfloat x, GLfloat y, GLfloat size) {
+  const GLubyte white[4] = {255, 255, 255, 255};
+  GLfloat width = size / 2;
+  GLfloat corners[6][2] = {
+    {0, size}, {width, size}, {width, size / 2},
+    {width, 0}, {0, 0}, {0, size / 2}
+  }; // Top left, top right, middle right, bottom right, bottom left, middle left
+  int segments[7][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 0}, {5, 2}};
+
+  for ( ; *text != '\0'; text++) {
+    if (*text == '.') {
+      addVertex(vertices, x, y, white);
+      addVertex(vertices, x, y + 2, white);
+      x += width / 2;
+      continue;
+    }
+
+    unsigned char lit = 0;
+    if (*text >= '0' && *text <= '9') {
+      lit = segmentDigits[*text - '0'];
+    } else if (*text == 'P') {
+      lit = segmentDigits[10];
+    }
+    for (int segment = 0; segment < 7; segment++) {
+      if (lit & (1 << segment)) {
+        addVertex(vertices, x + corners[segments[segment][0]][0], y + corners[segments[segment][0]][1], white);
+        addVertex(vertices, x + corners[segments[segment][1]][0], y + corners[segments[segment][1]][1], white);
+      }
+    }
+    x += width * 1.6;
+  }
+}
+
+
+void drawProfiler(frameProfiler * self, shaderStore * shaders) {
+  const GLfloat left = 526, bottom = 470, right = 790, top = 590;
+  const GLfloat scale = 4; // Pixels per millisecond
+  static profilerVertices quads, lines;
+  quads.count = 0;
+  lines.count = 0;
+
+  /* Background of the overlay */
+  const GLubyte background[4] = {0, 0, 0, 160};
+  addVertex(&quads, left, bottom, background);
+  addVertex(&quads, right, bottom, background);
+  addVertex(&quads, right, top, background);
+  addVertex(&quads, left, top, background);
+
+  /* The steps of the last frames, stacked, the most recent on the right */
+  int frames = self->count < PROFILE_GRAPH_FRAMES ? self->count : PROFILE_GRAPH_FRAMES;
+  GLfloat graphTop = top - 26;
+  for (int frameIndex = 0; frameIndex < frames; frameIndex++) {
+    float * frame = self->frames[(self->next - 1 - frameIndex + PROFILE_FRAMES) % PROFILE_FRAMES];
+    GLfloat x = right - 4 - 2 * (frameIndex + 1);
+    GLfloat y = bottom + 4;
+    for (int section = 0; section < PROFILE_SECTIONS && y < graphTop; section++) {
+      GLfloat height = frame[section] * scale;
+      height = y + height < graphTop ? height : graphTop - y;
+      const GLubyte colour[4] = {sectionColours[section][0], sectionColours[section][1],
+                                 sectionColours[section][2], 255};
+      addVertex(&quads, x, y, colour);
+      addVertex(&quads, x + 2, y, colour);
+      addVertex(&quads, x + 2, y + height, colour);
+      addVertex(&quads, x, y + height, colour);
+      y += height;
+    }
+  }
+
+  /* Budget of a frame at 60 frames per second */
+  const GLubyte budget[4] = {255, 255, 255, 128};
+  addVertex(&lines, left + 4, bottom + 4 + 1000.0 / 60 * scale, budget);
+  addVertex(&lines, right - 4, bottom + 4 + 1000.0 / 60 * scale, budget);
+
+  /* Percentiles of the frame time, in milliseconds */
+  char text[32];
+  snprintf(text, sizeof(text), "P50 %.2f", profiledPercentile(self, 0.5));
+  addSegments(&lines, text, left + 6, top - 18, 12);
+  snprintf(text, sizeof(text), "P99 %.2f", profiledPercentile(self, 0.99));
+  addSegments(&lines, text, left + 136, top - 18, 12);
+
+  drawOverlay(shaders, GL_QUADS, quads.count, quads.positions[0], NULL, quads.colours[0]);
+  drawOverlay(shaders, GL_LINES, lines.count, lines.positions[0], NULL, lines.colours[0]);
+}
+
+
+bool writeProfilerCSV(frameProfiler * self, const char * path) {
+  FILE * file = fopen(path, "w");
+  if (file == NULL) {
+    return false;
+  }
+
+  fprintf(file, "frame");
+  for (int section = 0; section < PROFILE_SECTIONS; section++) {
+    fprintf(file, ",%s", sectionNames[section]);
+  }
+  fprintf(file, ",total\n");
+
+  /* Oldest frame first */
+  int first = (self->next - self->count + PROFILE_FRAMES) % PROFILE_FRAMES;
+  for (int frameIndex = 0; frameIndex < self->count; frameIndex++) {
+    float * frame = self->frames[(first + frameIndex) % PROFILE_FRAMES];
+    fprintf(file, "%d", frameIndex);
+    for (int column = 0; column <= PROFILE_SECTIONS; column++) {
+      fprintf(file, ",%.3f", frame[column]);
+    }
+    fprintf(file, "\n");
+  }
+
+  return fclose(file) == 0;
+}
+
+
+void destroyProfiler(frameProfiler * self) {
+  free(self);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file profiler.h
+ * Defines a profiler measuring where the time of each frame goes
+ *
+ * update() marks the end of each of its steps : the time elapsed since the
+ * previous mark is added to the step. The times are measured on the CPU : the
+ * OpenGL calls only queue the work, the time the GPU takes shows in the swap.
+ */
+
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <GL/gl.h>
+#include <SDL2/SDL.h>
+#include "shaders.h"
+
+
+#define PROFILE_FRAMES 4096       /**< Number of frames kept, about a minute
+                                  at 60 frames per second */
+#define PROFILE_BUCKETS 200       /**< Number of buckets of the histogram */
+#define PROFILE_BUCKET_WIDTH 0.25 /**< Width of a bucket, in milliseconds */
+#define PROFILE_GRAPH_FRAMES 128  /**< Number of frames drawn in the overlay */
+#define PROFILE_VERTICES 4096     /**< Maximum number of vertices of the
+                                  overlay, per primitive */
+
+
+/**
+ * The steps of a frame
+ */
+enum ProfileSection {
+  PROFILE_ANIMATIONS,   /**< Update of the animations */
+  PROFILE_EVENTS,       /**< Polling and parsing the events */
+  PROFILE_HELP,         /**< Update of the help window */
+  PROFILE_SKYBOX,       /**< Drawing the skybox */
+  PROFILE_CUBES,        /**< Drawing the cubes */
+  PROFILE_OVERLAYS,     /**< Drawing the instructions, the history and the
+                        other 2D elements */
+  PROFILE_SWAP,         /**< Swapping the buffers, waiting for the GPU */
+  PROFILE_SECTIONS      /**< Number of steps */
+};
+
+
+/**
+ * A structure holding the timings of the last frames
+ */
+typedef struct _frameProfiler {
+  Uint64 frequency;               /**< Ticks of the counter per second */
+  Uint64 lastMark;                /**< Counter at the last mark */
+  float current[PROFILE_SECTIONS]; /**< Timings of the frame being measured,
+                                  in milliseconds */
+  float frames[PROFILE_FRAMES][PROFILE_SECTIONS + 1]; /**< Rolling window of
+                                  timings, the last column is the total */
+  int histogram[PROFILE_BUCKETS]; /**< Number of frames of the window per
+                                  bucket of total time */
+  int next;                       /**< Index of the next frame in frames */
+  int count;                      /**< Number of frames in the window */
+} frameProfiler;
+
+
+/**
+ * Create an empty profiler
+ * @return A pointer to the new profiler
+ */
+frameProfiler * generateProfiler();
+
+
+/**
+ * Start measuring a frame
+ * @param self The profiler
+ */
+void startProfiledFrame(frameProfiler * self);
+
+
+/**
+ * Add the time elapsed since the last mark to a step of the frame
+ * @param self    The profiler
+ * @param section The step that just ended
+ */
+void markProfiledSection(frameProfiler * self, enum ProfileSection section);
+
+
+/**
+ * Ignore the time elapsed since the last mark, spent sleeping
+ * @param self The profiler
+ */
+void skipProfiledTime(frameProfiler * self);
+
+
+/**
+ * Add the frame measured to the window and to the histogram
+ * @param self The profiler
+ */
+void endProfiledFrame(frameProfiler * self);
+
+
+/**
+ * Get a percentile of the frame times of the window, from the histogram
+ * @param  self     The profiler
+ * @param  fraction The fraction of frames, as 0.99 for the 99th percentile
+ * @return          The frame time, in milliseconds, 0 if no frame was measured
+ */
+float profiledPercentile(frameProfiler * self, float fraction);
+
+
+/**
+ * Draw the overlay : the steps of the last frames, stacked, and the 50th and
+ * 99th percentiles of the frame time. The overlay program must be in use.
+ * @param self    The profiler
+ * @param shaders The shader store
+ */
+void drawProfiler(frameProfiler * self, shaderStore * shaders);
+
+
+/**
+ * Write the timings of the window in a CSV file, in milliseconds
+ * @param  self The profiler
+ * @param  path The path of the file
+ * @return      True on success
+ */
+bool writeProfilerCSV(frameProfiler * self, const char * path);
+
+
+/**
+ * Destroy a profiler
+ * @param self The profiler
+ */
+void destroyProfiler(frameProfiler * self);
+
+#endif
@@ -0,0 +1,265 @@
+/**
+ * @file shaders.c
+ */
+
+
+#include "shaders.h"
+
+
+/**
+ * The uniforms shared by every program
+ */
+#define FRAME_BLOCK \
+  "#extension GL_ARB_uniform_buffer_object : require\n" \
+  "layout(std140) uniform Frame {\n" \
+  "  mat4 projection;\n" \
+  "  mat4 view;\n" \
+  "  mat4 overlay;\n" \
+  "  vec4 lightPosition;\n" \
+  "  vec4 ambient;\n" \
+  "  vec4 diffuse;\n" \
+  "  vec4 specular;\n" \
+  "  vec4 shininess;\n" \
+  "};\n"
+
+
+/**
+ * The stickers are lit per pixel with the Blinn-Phong model of the fixed
+ * pipeline : a point light and a viewer at infinity
+ */
+static const char * stickersVertex =
+  "#version 130\n"
+  FRAME_BLOCK
+  "uniform mat4 model;\n"
+  "in vec3 position;\n"
+  "in vec3 normal;\n"
+  "in vec4 colour;\n"
+  "in vec2 texCoord;\n"
+  "out vec3 eyePosition;\n"
+  "out vec3 eyeNormal;\n"
+  "out vec4 vertexColour;\n"
+  "out vec2 vertexTexCoord;\n"
+  "void main() {\n"
+  "  vec4 eye = view * model * vec4(position, 1.0);\n"
+  "  eyePosition = eye.xyz;\n"
+  "  eyeNormal = mat3(view * model) * normal;\n"
+  "  vertexColour = colour;\n"
+  "  vertexTexCoord = texCoord;\n"
+  "  gl_Position = projection * eye;\n"
+  "}\n";
+
+static const char * stickersFragment =
+  "#version 130\n"
+  FRAME_BLOCK
+  "uniform sampler2D glyphs;\n"
+  "uniform bool textured;\n"
+  "in vec3 eyePosition;\n"
+  "in vec3 eyeNormal;\n"
+  "in vec4 vertexColour;\n"
+  "in vec2 vertexTexCoord;\n"
+  "out vec4 fragmentColour;\n"
+  "void main() {\n"
+  "  vec3 normal = normalize(eyeNormal);\n"
+  "  vec3 light = normalize(lightPosition.xyz - eyePosition);\n"
+  "  float lambert = max(dot(normal, light), 0.0);\n"
+  "  vec3 colour = vertexColour.rgb * (ambient.rgb + diffuse.rgb * lambert);\n"
+  "  if (lambert > 0.0) {\n"
+  "    vec3 halfway = normalize(light + vec3(0.0, 0.0, 1.0));\n"
+  "    colour += specular.rgb * pow(max(dot(normal, halfway), 0.0), shininess.x);\n"
+  "  }\n"
+  "  fragmentColour = vec4(colour, vertexColour.a);\n"
+  "  if (textured) {\n"
+  "    fragmentColour *= texture(glyphs, vertexTexCoord);\n"
+  "  }\n"
+  "}\n";
+
+/**
+ * The skybox is pushed on the far plane, so it is drawn after the cubes and
+ * only where nothing else is
+ */
+static const char * skyboxVertex =
+  "#version 130\n"
+  FRAME_BLOCK
+  "in vec3 position;\n"
+  "out vec3 direction;\n"
+  "void main() {\n"
+  "  direction = position;\n"
+  "  gl_Position = (projection * view * vec4(position, 1.0)).xyww;\n"
+  "}\n";
+
+static const char * skyboxFragment =
+  "#version 130\n"
+  "uniform samplerCube skybox;\n"
+  "in vec3 direction;\n"
+  "out vec4 fragmentColour;\n"
+  "void main() {\n"
+  "  fragmentColour = texture(skybox, direction);\n"
+  "}\n";
+
+/**
+ * The overlay is pushed on the near plane, so it is drawn over the scene
+ * without disabling the depth test
+ */
+static const char * overlayVertex =
+  "#version 130\n"
+  FRAME_BLOCK
+  "in vec2 position;\n"
+  "in vec4 colour;\n"
+  "in vec2 texCoord;\n"
+  "out vec4 vertexColour;\n"
+  "out vec2 vertexTexCoord;\n"
+  "void main() {\n"
+  "  vertexColour = colour;\n"
+  "  vertexTexCoord = texCoord;\n"
+  "  gl_Position = vec4((overlay * vec4(position, 0.0, 1.0)).xy, -1.0, 1.0);\n"
+  "}\n";
+
+static const char * overlayFragment =
+  "#version 130\n"
+  "uniform sampler2D glyphs;\n"
+  "uniform bool textured;\n"
+  "in vec4 vertexColour;\n"
+  "in vec2 vertexTexCoord;\n"
+  "out vec4 fragmentColour;\n"
+  "void main() {\n"
+  "  fragmentColour = vertexColour;\n"
+  "  if (textured) {\n"
+  "    fragmentColour *= texture(glyphs, vertexTexCoord);\n"
+  "  }\n"
+  "}\n";
+
+
+/**
+ * Compile a shader. Exits on failure.
+ * @param  type   The type of shader, as GL_VERTEX_SHADER
+ * @param  source The GLSL source
+ * @return        The ID of the shader
+ */
+static GLuint compileShader(GLenum type, const char * source) {
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, NULL);
+  glCompileShader(shader);
+
+  GLint compiled;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (!compiled) {
+    char log[1024];
+    glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+    SDL_Log("Unable to compile a shader: %s", log);
+    exit(1);
+  }
+  return shader;
+}
+
+
+/**
+ * Build a program, its attributes at the fixed locations and its Frame block
+ * on the shared binding point. Exits on failure.
+ * @param  vertexSource   The GLSL source of the vertex shader
+ * @param  fragmentSource The GLSL source of the fragment shader
+ * @return                The ID of the program, in use
+ */
+static GLuint linkProgram(const char * vertexSource, const char * fragmentSource) {
+  GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+  GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+  GLuint program = glCreateProgram();
+  glAttachShader(program, vertexShader);
+  glAttachShader(program, fragmentShader);
+  glBindAttribLocation(program, ATTRIBUTE_POSITION, "position");
+  glBindAttribLocation(program, ATTRIBUTE_NORMAL, "normal");
+  glBindAttribLocation(program, ATTRIBUTE_COLOUR, "colour");
+  glBindAttribLocation(program, ATTRIBUTE_TEXCOORD, "texCoord");
+  glBindFragDataLocation(program, 0, "fragmentColour");
+  glLinkProgram(program);
+  glDeleteShader(vertexShader);
+  glDeleteShader(fragmentShader);
+
+  GLint linked;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (!linked) {
+    char log[1024];
+    glGetProgramInfoLog(program, sizeof(log), NULL, log);
+    SDL_Log("Unable to link a program: %s", log);
+    exit(1);
+  }
+
+  GLuint frameIndex = glGetUniformBlockIndex(program, "Frame");
+  if (frameIndex != GL_INVALID_INDEX) {
+    glUniformBlockBinding(program, frameIndex, SHADER_FRAME_BINDING);
+  }
+  glUseProgram(program);
+  return program;
+}
+
+
+shaderStore generateShaderStore(int width, int height) {
+  shaderStore shaders;
+
+  /* The samplers all read the first texture unit */
+  shaders.stickers = linkProgram(stickersVertex, stickersFragment);
+  shaders.stickersModel = glGetUniformLocation(shaders.stickers, "model");
+  shaders.stickersTextured = glGetUniformLocation(shaders.stickers, "textured");
+  glUniform1i(glGetUniformLocation(shaders.stickers, "glyphs"), 0);
+
+  shaders.skybox = linkProgram(skyboxVertex, skyboxFragment);
+  glUniform1i(glGetUniformLocation(shaders.skybox, "skybox"), 0);
+
+  shaders.overlay = linkProgram(overlayVertex, overlayFragment);
+  shaders.overlayTextured = glGetUniformLocation(shaders.overlay, "textured");
+  glUniform1i(glGetUniformLocation(shaders.overlay, "glyphs"), 0);
+  glUseProgram(0);
+
+  /* The projections and the light never change, only the view does */
+  frameUniforms * frame = &shaders.frame;
+  perspectiveMatrix(frame->projection, 70, (float)width / height, 1, 1000);
+  identityMatrix(frame->view);
+  orthoMatrix(frame->overlay, 0, width, 0, height);
+  GLfloat lighting[5][4] = { // The fields following lightPosition
+    {-1, 0, 0, 1},          // Position of the light, next to the camera
+    {0.4, 0.4, 0.4, 1},     // Ambient light of the scene and of the light
+    {0.8, 0.8, 0.8, 1},     // Diffuse light
+    {0.45, 0.45, 0.45, 1},  // Specular light times the specular material
+    {96, 0, 0, 0}           // Shininess
+  };
+  memcpy(frame->lightPosition, lighting, sizeof(lighting));
+
+  glGenBuffers(1, &shaders.frameBuffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, shaders.frameBuffer);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(frameUniforms), frame, GL_DYNAMIC_DRAW);
+  glBindBufferBase(GL_UNIFORM_BUFFER, SHADER_FRAME_BINDING, shaders.frameBuffer);
+
+  return shaders;
+}
+
+
+void setViewMatrix(shaderStore * shaders, const GLfloat * view) {
+  memcpy(shaders->frame.view, view, sizeof(shaders->frame.view));
+  glBindBuffer(GL_UNIFORM_BUFFER, shaders->frameBuffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, offsetof(frameUniforms, view),
+                  sizeof(shaders->frame.view), view);
+}
+
+
+void drawOverlay(shaderStore * shaders, GLenum mode, GLsizei count, const GLfloat * positions, const GLfloat * texCoords, const GLubyte * colours) {
+  glEnableVertexAttribArray(ATTRIBUTE_POSITION);
+  glVertexAttribPointer(ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, positions);
+
+  if (texCoords != NULL) {
+    glEnableVertexAttribArray(ATTRIBUTE_TEXCOORD);
+    glVertexAttribPointer(ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
+  }
+  glUniform1i(shaders->overlayTextured, texCoords != NULL);
+
+  if (colours != NULL) {
+    glEnableVertexAttribArray(ATTRIBUTE_COLOUR);
+    glVertexAttribPointer(ATTRIBUTE_COLOUR, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, colours);
+  } else {
+    glVertexAttrib4f(ATTRIBUTE_COLOUR, 1, 1, 1, 1);
+  }
+
+  glDrawArrays(mode, 0, count);
+
+  glDisableVertexAttribArray(ATTRIBUTE_COLOUR);
+  glDisableVertexAttribArray(ATTRIBUTE_TEXCOORD);
+  glDisableVertexAttribArray(ATTRIBUTE_POSITION);
+}
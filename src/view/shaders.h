@@ -0,0 +1,94 @@
+/**
+ * @file shaders.h
+ * Defines the GLSL programs drawing the scene
+ *
+ * Three programs replace the fixed pipeline : the stickers (the cubes and the
+ * instructions, lit per pixel), the skybox and the 2D overlay. The matrices
+ * and the lighting are shared by the programs in a uniform buffer, so a frame
+ * only uploads the view matrix and binds a program per pass. The programs use
+ * GLSL 1.30 and the uniform buffers of ARB_uniform_buffer_object, so OpenGL 3.0
+ * is enough, as with software renderers such as llvmpipe.
+ */
+
+
+#ifndef SHADERS_H
+#define SHADERS_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <SDL2/SDL.h>
+#include "matrix.h"
+
+
+#define SHADER_FRAME_BINDING 0  /**< Binding point of the frame uniforms */
+#define ATTRIBUTE_POSITION 0    /**< Location of the position attribute */
+#define ATTRIBUTE_NORMAL 1      /**< Location of the normal attribute */
+#define ATTRIBUTE_COLOUR 2      /**< Location of the colour attribute */
+#define ATTRIBUTE_TEXCOORD 3    /**< Location of the texture coordinates */
+
+
+/**
+ * The uniforms shared by the programs, laid out as the std140 Frame block
+ */
+typedef struct _frameUniforms {
+  GLfloat projection[16];   /**< The perspective projection of the scene */
+  GLfloat view[16];         /**< The view of the camera */
+  GLfloat overlay[16];      /**< The projection of the 2D overlay, in pixels */
+  GLfloat lightPosition[4]; /**< Position of the light, in view space */
+  GLfloat ambient[4];       /**< Ambient light */
+  GLfloat diffuse[4];       /**< Diffuse light */
+  GLfloat specular[4];      /**< Specular light of the stickers */
+  GLfloat shininess[4];     /**< Shininess of the stickers, in x */
+} frameUniforms;
+
+
+/**
+ * A structure holding the programs and their uniforms
+ */
+typedef struct _shaderStore {
+  GLuint stickers;          /**< Program of the cubes and the instructions */
+  GLuint skybox;            /**< Program of the skybox */
+  GLuint overlay;           /**< Program of the 2D overlay */
+  GLint stickersModel;      /**< Location of the model matrix of stickers */
+  GLint stickersTextured;   /**< Location of the texture flag of stickers */
+  GLint overlayTextured;    /**< Location of the texture flag of overlay */
+  GLuint frameBuffer;       /**< The uniform buffer of the Frame block */
+  frameUniforms frame;      /**< The content of the uniform buffer */
+} shaderStore;
+
+
+/**
+ * Compile and link the programs, and create the uniform buffer. Exits if a
+ * program cannot be built.
+ * @param  width  Width of the view, in pixels
+ * @param  height Height of the view, in pixels
+ * @return        The shader store
+ */
+shaderStore generateShaderStore(int width, int height);
+
+
+/**
+ * Upload the view of the camera for the frame
+ * @param shaders The shader store
+ * @param view    The view matrix
+ */
+void setViewMatrix(shaderStore * shaders, const GLfloat * view);
+
+
+/**
+ * Draw 2D primitives with the overlay program, which must be in use
+ * @param shaders   The shader store
+ * @param mode      The primitives, as GL_QUADS or GL_LINES
+ * @param count     The number of vertices
+ * @param positions The positions of the vertices, in pixels
+ * @param texCoords The texture coordinates, NULL for untextured primitives
+ * @param colours   The RGBA colours of the vertices, NULL for white
+ */
+void drawOverlay(shaderStore * shaders, GLenum mode, GLsizei count, const GLfloat * positions, const GLfloat * texCoords, const GLubyte * colours);
+
+#endif
@@ -35,6 +35,9 @@ void setSDL() {
   }
   Mix_AllocateChannels(2);
 
+  /* Initialize the PNG loader before the worker threads use it */
+  IMG_Init(IMG_INIT_PNG);
+
   /* Display SDL version */
   SDL_version sdlVersion;
   SDL_VERSION(&sdlVersion);
@@ -61,27 +64,16 @@ camera generateCamera() {
 }
 
 
-rubikview generateView() {
-  rubikview mainView;
+void setupScene(int width, int height) {
+  /* The projection is in the uniforms of the shaders, see shaders.h */
+  glViewport(0, 0, width, height);
 
   /*
-   *  Set the window title and set the window size, the colour depth and
-   *  context to OpenGL
+   * Enable depth testing (allows objects to hide each others). The skybox is
+   * drawn on the far plane, which must pass the test.
    */
-  mainView.mainWindow = SDL_CreateWindow("Rubiksawesome",
-                                         SDL_WINDOWPOS_UNDEFINED,
-                                         SDL_WINDOWPOS_UNDEFINED,
-                                         800, 600, SDL_WINDOW_OPENGL);
-  SDL_CreateRenderer(mainView.mainWindow, -1, 0);
-  SDL_GL_CreateContext(mainView.mainWindow);
-
-  /* Set up of the projection matrix to use perspective */
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-  gluPerspective(70, (double)800 / 600, 1, 1000);
-
-  /* Enable depth testing (allows objects to hide each others) */
   glEnable(GL_DEPTH_TEST);
+  glDepthFunc(GL_LEQUAL);
 
   /*
    * Enable transparency by enabling blending between alpha channel and
@@ -90,63 +82,84 @@ rubikview generateView() {
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
 
-  /*Enable lighting */
-  glEnable(GL_LIGHTING);
-  glEnable(GL_LIGHT0);
-
   /* Enable OpenGL multisampling (antialiasing) */
   glEnable(GL_MULTISAMPLE);
 
-  /* Create light components and assign them to GL_LIGHT0 */
-  GLfloat ambientLight[] = { 0.2f, 0.2f, 0.2f, 1.0f };
-  GLfloat diffuseLight[] = { 0.8f, 0.8f, 0.8f, 1.0f };
-  GLfloat specularLight[] = { 0.5f, 0.5f, 0.5f, 1.0f };
-  GLfloat position[] = { -1.0f, 0, 0, 1.0f };
-  glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
-  glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
-  glLightfv(GL_LIGHT0, GL_SPECULAR, specularLight);
-  glLightfv(GL_LIGHT0, GL_POSITION, position);
-
   /* Print OpenGL version */
   printf("OpenGL version: %s\n", glGetString(GL_VERSION));
   fflush(stdout);
+}
 
+
+void generateViewContent(rubikview * mainView) {
   /*
    * Create the cube and assign the camera, the rubik's cube and an empty
    * animations list
    */
-  mainView.texStore = generateTextureStore();
-  mainView.sndStore = generateSoundStore();
-  mainView.mainCamera = generateCamera();
-  mainView.rubikCube = generateRubikCube();
-  mainView.animStack = NULL;
-  mainView.gameWon = false;
-  mainView.konamiCount = 0;
+  mainView->shaders = generateShaderStore(VIEW_WIDTH, VIEW_HEIGHT);
+  mainView->texStore = generateTextureStore();
+  mainView->sndStore = generateSoundStore();
+  mainView->mainCamera = generateCamera();
+  mainView->rubikCube = generateRubikCube();
+  mainView->animQueue = generateAnimationQueue();
+  mainView->gameWon = false;
+  mainView->konamiCount = 0;
 
   /*
    * Setting the parameters for the solving window display
    */
-  mainView.windowToDisplay = false;
-  mainView.windowDisplayed = false;
-  mainView.solveWindow = NULL;
+  mainView->windowToDisplay = false;
+  mainView->windowDisplayed = false;
+  mainView->solveWindow = NULL;
+  mainView->helpStrip = NULL;
+
+  /* Always redraw by default, the first frame must be drawn anyway */
+  mainView->onDemand = false;
+  mainView->redrawNeeded = true;
+  mainView->firstFrameDrawn = false;
+
+  /* Profile every frame, the overlay is hidden by default */
+  mainView->profile = generateProfiler();
+  mainView->profilerDisplayed = false;
+  mainView->profilePath = NULL;
 
   /*
    * Generates instructions and add them to the view (hidden by default)
    */
   enum FaceType faces[6] = {FRONT, RIGHT, TOP, DOWN, BACK, LEFT};
   for (int index = 0; index < 6; index++) {
-    mainView.instructions[index] = generateInstruction(faces[index],
-                                                       mainView.texStore);
+    mainView->instructions[index] = generateInstruction(faces[index],
+                                                        mainView->texStore);
   }
-  mainView.instructionsDisplayed = false;
+  mainView->instructionsDisplayed = false;
 
   /*
    * Functions bindings
    * update() -> update()
    * animate() -> parseOrder()
    */
-  mainView.update = &update;
-  mainView.animate = &parseOrder;
+  mainView->update = &update;
+  mainView->animate = &parseOrder;
+}
+
+
+rubikview generateView() {
+  rubikview mainView;
+
+  /*
+   *  Set the window title and set the window size, the colour depth and
+   *  context to OpenGL
+   */
+  mainView.mainWindow = SDL_CreateWindow("Rubiksawesome",
+                                         SDL_WINDOWPOS_UNDEFINED,
+                                         SDL_WINDOWPOS_UNDEFINED,
+                                         VIEW_WIDTH, VIEW_HEIGHT,
+                                         SDL_WINDOW_OPENGL);
+  SDL_CreateRenderer(mainView.mainWindow, -1, 0);
+  SDL_GL_CreateContext(mainView.mainWindow);
+
+  setupScene(VIEW_WIDTH, VIEW_HEIGHT);
+  generateViewContent(&mainView);
 
   return mainView;
 }
@@ -162,6 +175,9 @@ void showHelpWindow(rubikview * mainView) {
   mainView->windowToDisplay = false;
   mainView->windowDisplayed = true;
 
+  /* The help window is the only one to blit the full size glyphs */
+  loadHelpGlyphs(&mainView->texStore);
+
   /* Destroy the current window if it exists */
   SDL_DestroyWindow(mainView->solveWindow);
 
@@ -170,40 +186,137 @@ void showHelpWindow(rubikview * mainView) {
                                            SDL_WINDOWPOS_UNDEFINED,
                                            SDL_WINDOWPOS_UNDEFINED,
                                            800, 100, 0);
+
+  /* The strip has the format of the window, to be copied without conversion */
+  SDL_Surface * solveSurface = SDL_GetWindowSurface(mainView->solveWindow);
+  SDL_FreeSurface(mainView->helpStrip);
+  mainView->helpStrip = SDL_CreateRGBSurfaceWithFormat(0, solveSurface->w,
+                                                       solveSurface->h, 32,
+                                                       solveSurface->format->format);
+  mainView->helpStripRevision = 0; // Never a revision : drawn on next update
+  mainView->helpStripShown = false;
+}
+
+
+void updateHelpWindow(rubikview * mainView, mvqueue solveMoves) {
+  /* Draw the next moves only when the solution changed */
+  SDL_Surface * strip = mainView->helpStrip;
+  if (mainView->helpStripRevision != queueRevision(solveMoves)) {
+    SDL_FillRect(strip, NULL, SDL_MapRGB(strip->format, 0, 0, 0));
+    move * moves = head(solveMoves, HELP_MOVES);
+    for (int i = 0; (int)moves[i] != -1; i++) {
+      SDL_Rect position;
+      position.x = 20 + 70 * i;
+      position.y = 20;
+      position.h = HELP_GLYPH_SIZE;
+      position.w = HELP_GLYPH_SIZE;
+
+      /* The glyphs are already scaled down, see loadHelpGlyphs() */
+      SDL_BlitSurface(moveToTexture(mainView->texStore, moves[i]).surface, NULL, strip, &position);
+    }
+    free(moves);
+    mainView->helpStripRevision = queueRevision(solveMoves);
+    mainView->helpStripShown = false;
+  }
+
+  /* Nothing to do when idle */
+  if (mainView->helpStripShown) {
+    return;
+  }
+  SDL_BlitSurface(strip, NULL, SDL_GetWindowSurface(mainView->solveWindow), NULL);
+  SDL_UpdateWindowSurface(mainView->solveWindow);
+  mainView->helpStripShown = true;
+}
+
+
+bool updateAnimations(rubikview * mainView, int pendingMoves, Uint32 now) {
+  scheduleAnimationQueue(mainView->animQueue, mainView->rubikCube,
+                         pendingMoves, now);
+  animationStack * animStackPtr = mainView->animQueue->head;
+  if (animStackPtr == NULL) {
+    return false;
+  }
+
+  /* Start the animation stack if it is not started */
+  if (!animStackPtr->hasStarted) {
+    animStackPtr->start(animStackPtr, mainView->sndStore.rumbling, now);
+  }
+
+  /* Update the animation */
+  animStackPtr->update(animStackPtr, mainView->rubikCube, now);
+
+  /* Remove it if finished */
+  if (animStackPtr->isFinished) {
+    removeAnimationStack(mainView->animQueue);
+  }
+  return true;
+}
+
+
+void renderScene(rubikview * mainView, mvstack moveStack, int keyShortcut) {
+  camera * mainCamera = &(mainView->mainCamera);
+
+  /* Clear the screen */
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  /* Set the camera position and orientation */
+  GLfloat view[16];
+  GLfloat eye[3] = {mainCamera->position.x, mainCamera->position.y, mainCamera->position.z};
+  GLfloat center[3] = {0, 0, 0};
+  GLfloat up[3] = {0, 0, 1};
+  lookAtMatrix(view, eye, center, up);
+  setViewMatrix(&mainView->shaders, view);
+
+  /* Draw the cubes first, the skybox is only drawn where they are not */
+  drawCubes(&mainView->shaders, mainView->rubikCube);
+  markProfiledSection(mainView->profile, PROFILE_CUBES);
+  drawSkybox(&mainView->shaders, mainView->texStore.skybox);
+  markProfiledSection(mainView->profile, PROFILE_SKYBOX);
+
+  /* The instructions are transparent, so they are drawn over the skybox */
+  if (mainView->instructionsDisplayed) {
+    drawInstructions(&mainView->shaders, mainView->instructions, keyShortcut);
+  }
+
+  /*
+   * Draw history, xyz instruction and the winning creepy guy if needed. The
+   * overlay program draws on the near plane, over the 3D.
+   */
+  glUseProgram(mainView->shaders.overlay);
+  drawHistory(&mainView->shaders, mainView->texStore, moveStack);
+  drawXYZInstruction(&mainView->shaders, mainView->texStore, keyShortcut >= 2);
+  if (mainView->gameWon) {
+    drawWinning(&mainView->shaders, mainView->texStore);
+  }
+  if (mainView->profilerDisplayed) {
+    drawProfiler(mainView->profile, &mainView->shaders);
+  }
+
+  glFlush();
+  markProfiledSection(mainView->profile, PROFILE_OVERLAYS);
 }
 
 
 void update(rubikview * mainView, mvqueue moveQueue, mvstack moveStack, mvqueue solveMoves) {
   Uint32 startTime = SDL_GetTicks();
+  startProfiledFrame(mainView->profile);
 
   camera * mainCamera = &(mainView->mainCamera);
-  bool imageChanged = false;
+  bool imageChanged = mainView->redrawNeeded;
+  mainView->redrawNeeded = false;
 
   /*
    * Update animations
    */
-  animationStack * animStackPtr = mainView->animStack;
-  if (animStackPtr != NULL) {
+  if (updateAnimations(mainView, sizeOfMoveQueue(moveQueue), SDL_GetTicks())) {
     imageChanged = true;
-
-    /* Start the animation stack if it is not started */
-    if (!animStackPtr->hasStarted) {
-      animStackPtr->start(animStackPtr, mainView->sndStore.rumbling);
-    }
-
-    /* Update the animation */
-    animStackPtr->update(animStackPtr, mainView->rubikCube);
-
-    /* Remove it if finished */
-    if (animStackPtr->isFinished) {
-      removeAnimationStack(&mainView->animStack, animStackPtr);
-    }
   }
+  markProfiledSection(mainView->profile, PROFILE_ANIMATIONS);
 
-  /* Show the help window if we previously entered the konami code */
-  if (mainView->windowToDisplay) {
-    showHelpWindow(mainView);
-    imageChanged = true;
+  /* Pending moves to fold : no frame is drawn until they are queued */
+  if (mainView->animQueue->foldDebt > 0 && !isEmpty(moveQueue)) {
+    mainView->redrawNeeded = true;
+    return;
   }
 
   SDL_Event event;
@@ -222,6 +335,11 @@ void update(rubikview * mainView, mvqueue moveQueue, mvstack moveStack, mvqueue
   keyShortcut += keystate[SDL_SCANCODE_LCTRL] ? 1 : 0;
 
   while (SDL_PollEvent(&event)) {
+    /* Any input but moving the mouse around may change the image */
+    if (event.type != SDL_MOUSEMOTION) {
+      imageChanged = true;
+    }
+
     switch(event.type)
     {
       case SDL_MOUSEMOTION:
@@ -237,18 +355,23 @@ void update(rubikview * mainView, mvqueue moveQueue, mvstack moveStack, mvqueue
         imageChanged = true;
         break;
       case SDL_QUIT:
-        closeWindow();
+        closeWindow(mainView);
         break;
       case SDL_WINDOWEVENT:
         if (event.window.event == SDL_WINDOWEVENT_CLOSE) {
           if (event.window.windowID == SDL_GetWindowID(mainView->mainWindow)) {
-            closeWindow();
+            closeWindow(mainView);
           }
           else {
             SDL_DestroyWindow(mainView->solveWindow);
             mainView->windowDisplayed = false;
           }
         }
+        if (event.window.event == SDL_WINDOWEVENT_EXPOSED
+            && mainView->windowDisplayed
+            && event.window.windowID == SDL_GetWindowID(mainView->solveWindow)) {
+          mainView->helpStripShown = false;
+        } // The help window must be drawn again
         break;
     }
 
@@ -272,6 +395,12 @@ void update(rubikview * mainView, mvqueue moveQueue, mvstack moveStack, mvqueue
       }
     }
 
+    /* Press F3 to show the profiler overlay */
+    if (event.key.keysym.sym == SDLK_F3 && keyPressed) {
+      mainView->profilerDisplayed = !mainView->profilerDisplayed;
+      imageChanged = true;
+    }
+
     /* Press I to show the instructions overlay */
     if (event.key.keysym.sym == SDLK_i && keyPressed) {
       mainView->instructionsDisplayed = !mainView->instructionsDisplayed;
@@ -280,7 +409,7 @@ void update(rubikview * mainView, mvqueue moveQueue, mvstack moveStack, mvqueue
 
     /* Press escape to quit */
     if (event.key.keysym.sym == SDLK_ESCAPE && keyPressed) {
-      closeWindow();
+      closeWindow(mainView);
     }
 
     /* FOR DEBUGGING PURPOSE ONLY : solve the game automatically */
@@ -341,118 +470,45 @@ void update(rubikview * mainView, mvqueue moveQueue, mvstack moveStack, mvqueue
    * Draw the scene *
    ******************/
 
-  if (!imageChanged) {
-    Uint32 endTime = SDL_GetTicks() - startTime;
-    if (endTime < 16){
-      SDL_Delay(16 - endTime);
-    }
-  }
+  markProfiledSection(mainView->profile, PROFILE_EVENTS);
 
-  /* Clear the screen */
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-  /*
-   * Set the matrix mode to the model view. The next operations will be applied
-   * on the matrix containing all the vertices and stuff like that
-   */
-  glMatrixMode(GL_MODELVIEW);
-  glLoadIdentity();
-
-  /* Set the camera position and orientation */
-  gluLookAt(mainCamera->position.x, mainCamera->position.y, mainCamera->position.z, 0, 0, 0, 0, 0, 1);
-
-  /* Draw the skybox before anything */
-  drawSkybox(mainView->texStore.skybox);
-
-  /* Set the lightings parameters */
-  GLfloat light_diffuse[] = {1, 1, 1, 1};
-  GLfloat light_specular[] = {0.9, 0.9, 0.9, 1};
-
-  glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, light_diffuse);
-  glMaterialfv(GL_FRONT, GL_SPECULAR, light_specular);
-  glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
-  glMateriali(GL_FRONT, GL_SHININESS, 96);
-  glEnable(GL_COLOR_MATERIAL);
-
-  /* Draw the 3D stuffs */
-  drawCubes(mainView->rubikCube);
-  if (mainView->instructionsDisplayed) {
-    drawInstructions(mainView->instructions, keyShortcut);
+  /* Show the help window if we entered the konami code */
+  if (mainView->windowToDisplay) {
+    showHelpWindow(mainView);
+    imageChanged = true;
   }
 
-  /*
-   * Set the scene for some 2D:
-   * Disabling lighting and depth testing
-   */
-  glDisable(GL_DEPTH_TEST);
-  glDisable(GL_LIGHTING);
-  glDepthMask(GL_FALSE);
-
-  /*
-   * We will temporarily add an orthometric matrix to the projection
-   * matrix so that we can draw in 2D. We will pop it back later when we go
-   * back to 3D.
-   */
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-  glLoadIdentity();
-  gluOrtho2D(0.0, 800, 0.0, 600);
-
-  /*
-   * We push a new model view matrix on top of the existing one to make the
-   * 2D on top of the 3D.
-   */
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-  glLoadIdentity();
-
-  /* Start drawing in 2D */
-  glEnable(GL_TEXTURE_2D);
-
-  /* Draw history, xyz instruction and the winning creepy guy if needed */
-  drawHistory(mainView->texStore, moveStack);
-  drawXYZInstruction(mainView->texStore, keystate[SDL_SCANCODE_LSHIFT]);
-  if (mainView->gameWon) {
-    drawWinning(mainView->texStore);
+  /* Update the solve window, which costs nothing when idle */
+  if (mainView->windowDisplayed) {
+    updateHelpWindow(mainView, solveMoves);
   }
+  markProfiledSection(mainView->profile, PROFILE_HELP);
 
-  /* Stop drawin in 3D */
-  glDisable(GL_TEXTURE_2D);
-
-  /* We pop the projection and modelview matrices we used in 2D */
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-  glMatrixMode(GL_MODELVIEW);
-  glPopMatrix();
+  /* On-demand mode : sleep until something happens instead of redrawing */
+  if (mainView->onDemand && !imageChanged && isEmpty(moveQueue)) {
+    SDL_WaitEventTimeout(NULL, ON_DEMAND_TIMEOUT);
+    return;
+  }
 
-  /* We reenable the lights and depth testing for 3D */
-  glDepthMask(GL_TRUE);
-  glEnable(GL_LIGHTING);
-  glEnable(GL_DEPTH_TEST);
+  if (!imageChanged) {
+    Uint32 endTime = SDL_GetTicks() - startTime;
+    if (endTime < 16){
+      SDL_Delay(16 - endTime);
+    }
+    skipProfiledTime(mainView->profile);
+  }
 
   /* Displaying final screen */
-  glFlush();
+  renderScene(mainView, moveStack, keyShortcut);
   SDL_GL_SwapWindow(mainView->mainWindow);
-
-
-  /*
-   * Update the solve window
-   */
-  if (mainView->windowDisplayed) {
-    SDL_Surface * solveSurface = SDL_GetWindowSurface(mainView->solveWindow);
-    SDL_FillRect(solveSurface, NULL, SDL_MapRGB(solveSurface->format, 0, 0, 0));
-    move * moves = head(solveMoves, 11);
-    for (int i = 0; i < 11 && (int)moves[i] != -1; i++) {
-      SDL_Rect position;
-      position.x = 20 + 70 * i;
-      position.y = 20;
-      position.h = 50;
-      position.w = 50;
-
-      SDL_BlitScaled(moveToTexture(mainView->texStore, moves[i]).surface, NULL, solveSurface, &position);
-    }
-
-    SDL_UpdateWindowSurface(mainView->solveWindow);
+  markProfiledSection(mainView->profile, PROFILE_SWAP);
+  endProfiledFrame(mainView->profile);
+
+  /* Time from the start of the program to the first interactive frame */
+  if (!mainView->firstFrameDrawn) {
+    mainView->firstFrameDrawn = true;
+    printf("First frame drawn after %u ms\n", SDL_GetTicks());
+    fflush(stdout);
   }
 
   Uint32 endTime = SDL_GetTicks() - startTime;
@@ -698,268 +754,287 @@ move getNextMove(SDL_Keycode keysym, int keyShortcut) {
 
 
 void parseOrder(rubikview * mainView, move order, bool fast) {
-  animation * newAnimation;
+  animation newAnimation;
 
   /*
    * Generate an animation stack that will hold all the animations.
    * We'll add an animation for each slice that need to be animated.
    */
-  animationStack * newAnimStack = generateAnimationStack(mainView->sndStore.rumbling);
+  animationStack * newAnimStack = generateAnimationStack(mainView->animQueue,
+                                                        mainView->rubikCube,
+                                                        mainView->sndStore.rumbling);
 
   /* Make it instantaneous if fast is true */
-  float rotationAngle = fast ? PI / 2 : ROTATION_ANGLE;
+  Uint32 duration = fast ? 0 : ANIMATION_DURATION;
   switch (order) {
     case U:
-      newAnimation = generateAnimation(TOP, 2, rotationAngle, true,
+      newAnimation = generateAnimation(TOP, 2, duration, true,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case D:
-      newAnimation = generateAnimation(DOWN, 0, rotationAngle, false,
+      newAnimation = generateAnimation(DOWN, 0, duration, false,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case R:
-      newAnimation = generateAnimation(RIGHT, 2, rotationAngle, true,
+      newAnimation = generateAnimation(RIGHT, 2, duration, true,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case L:
-      newAnimation = generateAnimation(LEFT, 0, rotationAngle, false,
+      newAnimation = generateAnimation(LEFT, 0, duration, false,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case F:
-      newAnimation = generateAnimation(FRONT, 0, rotationAngle, false,
+      newAnimation = generateAnimation(FRONT, 0, duration, false,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case B:
-      newAnimation = generateAnimation(BACK, 2, rotationAngle, true,
+      newAnimation = generateAnimation(BACK, 2, duration, true,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
 
     case Ui:
-      newAnimation = generateAnimation(TOP, 2, rotationAngle, false,
+      newAnimation = generateAnimation(TOP, 2, duration, false,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case Di:
-      newAnimation = generateAnimation(DOWN, 0, rotationAngle, true,
+      newAnimation = generateAnimation(DOWN, 0, duration, true,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case Ri:
-      newAnimation = generateAnimation(RIGHT, 2, rotationAngle, false,
+      newAnimation = generateAnimation(RIGHT, 2, duration, false,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case Li:
-      newAnimation = generateAnimation(LEFT, 0, rotationAngle, true,
+      newAnimation = generateAnimation(LEFT, 0, duration, true,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case Fi:
-      newAnimation = generateAnimation(FRONT, 0, rotationAngle, true,
+      newAnimation = generateAnimation(FRONT, 0, duration, true,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case Bi:
-      newAnimation = generateAnimation(BACK, 2, rotationAngle, false,
+      newAnimation = generateAnimation(BACK, 2, duration, false,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
 
     case u:
-      newAnimation = generateAnimation(TOP, 2, rotationAngle, true,
+      newAnimation = generateAnimation(TOP, 2, duration, true,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(TOP, 1, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(TOP, 1, duration, true,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case d:
-      newAnimation = generateAnimation(DOWN, 0, rotationAngle, false,
+      newAnimation = generateAnimation(DOWN, 0, duration, false,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(DOWN, 1, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(DOWN, 1, duration, false,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case r:
-      newAnimation = generateAnimation(RIGHT, 2, rotationAngle, true,
+      newAnimation = generateAnimation(RIGHT, 2, duration, true,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(RIGHT, 1, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(RIGHT, 1, duration, true,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case l:
-      newAnimation = generateAnimation(LEFT, 0, rotationAngle, false,
+      newAnimation = generateAnimation(LEFT, 0, duration, false,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(LEFT, 1, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(LEFT, 1, duration, false,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case f:
-      newAnimation = generateAnimation(FRONT, 0, rotationAngle, false,
+      newAnimation = generateAnimation(FRONT, 0, duration, false,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(FRONT, 1, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(FRONT, 1, duration, false,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case b:
-      newAnimation = generateAnimation(BACK, 2, rotationAngle, true,
+      newAnimation = generateAnimation(BACK, 2, duration, true,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(BACK, 1, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(BACK, 1, duration, true,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
 
     case ui:
-      newAnimation = generateAnimation(TOP, 2, rotationAngle, false,
+      newAnimation = generateAnimation(TOP, 2, duration, false,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(TOP, 1, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(TOP, 1, duration, false,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case di:
-      newAnimation = generateAnimation(DOWN, 0, rotationAngle, true,
+      newAnimation = generateAnimation(DOWN, 0, duration, true,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(DOWN, 1, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(DOWN, 1, duration, true,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case ri:
-      newAnimation = generateAnimation(RIGHT, 2, rotationAngle, false,
+      newAnimation = generateAnimation(RIGHT, 2, duration, false,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(RIGHT, 1, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(RIGHT, 1, duration, false,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case li:
-      newAnimation = generateAnimation(LEFT, 0, rotationAngle, true,
+      newAnimation = generateAnimation(LEFT, 0, duration, true,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(LEFT, 1, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(LEFT, 1, duration, true,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case fi:
-      newAnimation = generateAnimation(FRONT, 0, rotationAngle, true,
+      newAnimation = generateAnimation(FRONT, 0, duration, true,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(FRONT, 1, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(FRONT, 1, duration, true,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case bi:
-      newAnimation = generateAnimation(BACK, 2, rotationAngle, false,
+      newAnimation = generateAnimation(BACK, 2, duration, false,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(BACK, 1, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(BACK, 1, duration, false,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
 
     case x:
-      newAnimation = generateAnimation(RIGHT, 0, rotationAngle, true,
+      newAnimation = generateAnimation(RIGHT, 0, duration, true,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(RIGHT, 2, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(RIGHT, 2, duration, true,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(RIGHT, 1, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(RIGHT, 1, duration, true,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case xi:
-      newAnimation = generateAnimation(RIGHT, 0, rotationAngle, false,
+      newAnimation = generateAnimation(RIGHT, 0, duration, false,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(RIGHT, 2, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(RIGHT, 2, duration, false,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(RIGHT, 1, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(RIGHT, 1, duration, false,
                                        &rotateDataX);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
 
     case y:
-      newAnimation = generateAnimation(TOP, 0, rotationAngle, true,
+      newAnimation = generateAnimation(TOP, 0, duration, true,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(TOP, 2, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(TOP, 2, duration, true,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(TOP, 1, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(TOP, 1, duration, true,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case yi:
-      newAnimation = generateAnimation(TOP, 0, rotationAngle, false,
+      newAnimation = generateAnimation(TOP, 0, duration, false,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(TOP, 2, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(TOP, 2, duration, false,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(TOP, 1, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(TOP, 1, duration, false,
                                        &rotateDataZ);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
 
     case z:
-      newAnimation = generateAnimation(FRONT, 0, rotationAngle, false,
+      newAnimation = generateAnimation(FRONT, 0, duration, false,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(FRONT, 2, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(FRONT, 2, duration, false,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(FRONT, 1, rotationAngle, false,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(FRONT, 1, duration, false,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
     case zi:
-      newAnimation = generateAnimation(FRONT, 0, rotationAngle, true,
+      newAnimation = generateAnimation(FRONT, 0, duration, true,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(FRONT, 2, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(FRONT, 2, duration, true,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
-      newAnimation = generateAnimation(FRONT, 1, rotationAngle, true,
+      addAnimation(newAnimStack, newAnimation);
+      newAnimation = generateAnimation(FRONT, 1, duration, true,
                                        &rotateDataY);
-      addAnimation(&newAnimStack->animations, newAnimation);
+      addAnimation(newAnimStack, newAnimation);
       break;
 
     default:
       break;
   }
-  addAnimationStack(&mainView->animStack, newAnimStack);
+  addAnimationStack(mainView->animQueue, newAnimStack);
 }
 
 
 soundStore generateSoundStore() {
   /* Uses SDL_Mixer to load the sounds */
   soundStore sndStore;
-  sndStore.rumbling = Mix_LoadWAV("res/sounds/rumble.wav");
-  sndStore.clapping = Mix_LoadWAV("res/sounds/clapping.wav");
+  sndStore.rumbling = loadSoundAsset("res/sounds/rumble.wav");
+  sndStore.clapping = NULL; // Loaded on the first win
   return sndStore;
 }
 
 
+void scrambleCube(cube * cubeData, rubikview * mainView, move * moves) {
+  int index = 0;
+  move currmove = -1;
+  while (((int) (currmove = moves[index++]) != -1)) {
+    mainView->animate(mainView, currmove, true);
+    cubeData->rotate(cubeData, currmove);
+  }
+}
+
+
+void cancelMove(cube * cubeData, rubikview * mainView, mvstack history) {
+  move cancelCmd = inverseMove(pop(history));
+  cubeData->rotate(cubeData, cancelCmd);
+  mainView->animate(mainView, cancelCmd, false);
+}
+
+
 void resetView(rubikview * aView) {
     /* Reset camera */
     aView->mainCamera = generateCamera();
 
-    /* Empty the animation stack just to be safe */
-    aView->animStack = NULL;
+    /* Empty the animation queue just to be safe */
+    clearAnimationQueue(aView->animQueue);
 
     /*
      *  Frees the rubikCube
@@ -970,6 +1045,7 @@ void resetView(rubikview * aView) {
     aView->gameWon = false;
     aView->instructionsDisplayed = false;
     aView->konamiCount = 0;
+    aView->redrawNeeded = true;
     return;
 }
 
@@ -977,11 +1053,22 @@ void resetView(rubikview * aView) {
 void playWinningSequence(rubikview * mainView) {
   /* Set the flag to true and start the winning sound (clapping) */
   mainView->gameWon = true;
+  mainView->redrawNeeded = true;
+
+  /* The winning picture and sound are only loaded on the first win */
+  requireTexture(&mainView->texStore.winner, "res/winner.png");
+  if (mainView->sndStore.clapping == NULL) {
+    mainView->sndStore.clapping = loadSoundAsset("res/sounds/clapping.wav");
+  }
   Mix_PlayChannel(1, mainView->sndStore.clapping, 0);
 }
 
 
-void closeWindow() {
+void closeWindow(rubikview * mainView) {
+  if (mainView->profilePath != NULL
+      && !writeProfilerCSV(mainView->profile, mainView->profilePath)) {
+    SDL_Log("Unable to write the timings in %s", mainView->profilePath);
+  }
   SDL_Quit();
   exit(0);
 }
@@ -11,19 +11,21 @@
 #include <math.h>
 #include <stdbool.h>
 #include <GL/gl.h>
-#include <GL/glu.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_mixer.h>
 #include "graphics.h"
 #include "animations.h"
+#include "profiler.h"
 #include "../model/cube.h"
 #include "../controller/commandQueue.h"
 
 
-#define PI_DENOMINATOR 90
-#define ROTATION_ANGLE (PI / PI_DENOMINATOR)
-#define ANIMATIONS_STEP (PI_DENOMINATOR / 2)
+#define VIEW_WIDTH 800        /**< Width of the rendered image, in pixels */
+#define VIEW_HEIGHT 600       /**< Height of the rendered image, in pixels */
+#define ON_DEMAND_TIMEOUT 100 /**< Longest wait for an event in on-demand
+                              mode, in milliseconds */
+#define HELP_MOVES 11         /**< Number of moves shown in the help window */
 
 
 /**
@@ -42,7 +44,8 @@ typedef struct _camera {
  */
 typedef struct _soundStore {
   Mix_Chunk * rumbling;   /**< Rumbling sound when the slices are moving */
-  Mix_Chunk * clapping;   /**< Clapping sound for the end */
+  Mix_Chunk * clapping;   /**< Clapping sound for the end, NULL until the
+                          first win */
 } soundStore;
 
 
@@ -52,10 +55,11 @@ typedef struct _soundStore {
 typedef struct _rubikview {
   camera mainCamera;                  /**< The camera in the view */
   rubikcube * rubikCube;              /**< The Rubik's cube */
-  animationStack * animStack;         /**< Animation stack to update them
-                                      serially */
+  animationQueue * animQueue;         /**< Queue of animation stacks to
+                                      update them serially */
   instructionDisplay instructions[6]; /**< An array of images for the
                                       instructions */
+  shaderStore shaders;                /**< Programs drawing the scene */
   textureStore texStore;              /**< Store for the textures */
   soundStore sndStore;                /**< Store for the sounds */
   bool instructionsDisplayed;         /**< True to show the instructions */
@@ -67,6 +71,22 @@ typedef struct _rubikview {
                                       the help window */
   bool windowDisplayed;               /**< Flag to indicate that the help
                                       display has been displayed */
+  SDL_Surface * helpStrip;            /**< The next moves, drawn in the format
+                                      of the help window */
+  unsigned long helpStripRevision;    /**< Revision of the solving queue drawn
+                                      in helpStrip */
+  bool helpStripShown;                /**< False when the help window must be
+                                      updated from helpStrip */
+  bool onDemand;                      /**< True to redraw only when something
+                                      changed, and sleep otherwise */
+  bool redrawNeeded;                  /**< Flag to force a redraw on the next
+                                      update, set when the game changes */
+  bool firstFrameDrawn;               /**< True once the first frame is shown,
+                                      to report the startup time */
+  frameProfiler * profile;            /**< Timings of the last frames */
+  bool profilerDisplayed;             /**< True to show the profiler overlay */
+  const char * profilePath;           /**< Path of the CSV file where the
+                                      timings are written on exit, or NULL */
   void (* update)(struct _rubikview * mainView, mvqueue moveQueue, mvstack moveStack, mvqueue solveMoves);
   void (* animate)(struct _rubikview * self, move order, bool fast);
 } rubikview;
@@ -78,6 +98,23 @@ typedef struct _rubikview {
 void setSDL();
 
 
+/**
+ * Set the OpenGL state (projection, lights, blending) of the current context
+ * @param width  Width of the rendered image, in pixels
+ * @param height Height of the rendered image, in pixels
+ */
+void setupScene(int width, int height);
+
+
+/**
+ * Fill a view with its textures, sounds, camera and a completed Rubik's cube.
+ * An OpenGL context must be current. No window is created, so it can be used
+ * to render offscreen.
+ * @param mainView The view to fill
+ */
+void generateViewContent(rubikview * mainView);
+
+
 /**
  * Generate a view structure with all the cubes already generated and set
  * to a completed Rubik's cube.
@@ -93,9 +130,23 @@ rubikview generateView();
 void showHelpWindow(rubikview * mainView);
 
 
+/**
+ * Update the help window with the next moves of the solution. The moves are
+ * drawn in a cached strip, rebuilt only when the solving queue changed, and
+ * the window is only updated when the strip changed or the window was exposed.
+ * @param mainView   The pointer to the current view
+ * @param solveMoves The queue of moves solving the cube
+ */
+void updateHelpWindow(rubikview * mainView, mvqueue solveMoves);
+
+
 /**
  * Redraw the view and handle events. This function must be called on every
  * frame.
+ *
+ * In on-demand mode, when there is no animation, no input, no pending move and
+ * redrawNeeded is not set, nothing is drawn and the function waits for the
+ * next event (at most ON_DEMAND_TIMEOUT ms) instead.
  * @param mainView   The structure holding the view
  * @param moveQueue  A list of the moves that need to be animated
  * @param moveStack  A list of moves that has been done (history)
@@ -104,6 +155,26 @@ void showHelpWindow(rubikview * mainView);
 void update(rubikview * mainView, mvqueue moveQueue, mvstack moveStack, mvqueue solveMoves);
 
 
+/**
+ * Play the animations of the view up to a given time
+ * @param  mainView     The structure holding the view
+ * @param  pendingMoves Number of moves waiting to be animated
+ * @param  now          The current time, in milliseconds
+ * @return              True if an animation has been played
+ */
+bool updateAnimations(rubikview * mainView, int pendingMoves, Uint32 now);
+
+
+/**
+ * Draw the whole scene (skybox, cubes, instructions and 2D overlay) in the
+ * current framebuffer
+ * @param mainView    The structure holding the view
+ * @param moveStack   A list of moves that has been done (history)
+ * @param keyShortcut State of the Shift (2) and Ctrl (1) keys
+ */
+void renderScene(rubikview * mainView, mvstack moveStack, int keyShortcut);
+
+
 /**
  * Rotate the camera around the phi and theta angle
  * @param self   The camera itself
@@ -169,6 +240,26 @@ move getNextMove(SDL_Keycode keysym, int keyShortcut);
 void parseOrder(rubikview * mainView, move order, bool fast);
 
 
+/**
+ * Scrambles the cube according a given sequence of moves
+ *
+ * @param cubeData - Pointer to the 2D cube data to scramble
+ * @param mainView - Pointer to the 3D cube data to scramble
+ * @param moves - array of n+1 moves, the last one being the -1 endmark
+ */
+void scrambleCube(cube * cubeData, rubikview * mainView, move * moves);
+
+
+/**
+ * Cancels the last move in the history
+ *
+ * @param cubeData - A pointer to the 2D cube data to modifiy
+ * @param mainView - A pointer to the 3D cube data to modify
+ * @param history - A stack of moves representing the history of moves
+ */
+void cancelMove(cube * cubeData, rubikview * mainView, mvstack history);
+
+
 /**
  * Generate a sound store
  * @return The sound store that has been generated
@@ -196,8 +287,9 @@ void playWinningSequence(rubikview * mainView);
 
 
 /**
- * Close the window
+ * Close the window, writing the timings of the frames if asked to
+ * @param mainView The pointer to the current view
  */
-void closeWindow();
+void closeWindow(rubikview * mainView);
 
 #endif
@@ -0,0 +1,318 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/rubik.h"
+#include "../src/controller/lastLayerTable.h"
+
+/*
+ * Generates the table of the algorithms of the last layer (see
+ * src/controller/lastLayerTable.h)
+ *
+ * Usage: ./gen1lll lastlayer.tbl
+ *
+ * The algorithms are made of known algorithms keeping the first two layers,
+ * played from the 4 sides, mirrored and inverted, and of the turns of the up
+ * face. A search from the solved last layer, each algorithm costing its
+ * number of moves, finds the cheapest chain of them for every state. The
+ * moves of the same face are then merged, and every algorithm is checked on a
+ * cube before the table is written.
+ */
+
+#define GEN1LLL_ALGORITHMS 512  /**< Room for the variants of the algorithms */
+#define GEN1LLL_MAX_MOVES 256   /**< Moves bounding an algorithm */
+#define GEN1LLL_UNKNOWN 0xFFFF  /**< Cost of a state not reached yet */
+
+/**
+ * Algorithms keeping the first two layers, with green on front and yellow up
+ */
+static const char * knownAlgorithms[] = {
+    "R U Ri U R U2 Ri",                             // Sune
+    "F R U Ri Ui Fi",
+    "R U Ri Ui Ri F R Fi",
+    "F Ri Fi R U R Ui Ri",
+    "R U2 Ri Ui R U Ri Ui R Ui Ri",                 // H
+    "R U2 R2 Ui R2 Ui R2 U2 R",                     // Pi
+    "R2 D Ri U2 R Di Ri U2 Ri",                     // Headlights
+    "R U Ri Ui Ri F R2 Ui Ri Ui R U Ri Fi",         // T permutation
+    "R Ui R U R U R Ui Ri Ui R2",                   // Ua permutation
+    "Ri F Ri B2 R Fi Ri B2 R2",                     // Aa permutation
+    "R U Ri Fi R U Ri Ui Ri F R2 Ui Ri",            // Jb permutation
+    "F R Ui Ri Ui R U Ri Fi R U Ri Ui Ri F R Fi",   // Y permutation
+    "R2 U2 R U2 R2 U2 R2 U2 R U2 R2",               // H permutation
+    "R Ui Ri Ui R U R D Ri Ui R Di Ri U2 Ri",       // Ra permutation
+    NULL
+};
+
+/**
+ * An algorithm and where it brings the facelets of the last layer
+ */
+typedef struct _algorithm {
+    move * moves;                                   // Terminated by -1
+    int size;                                       // Number of moves
+    unsigned char corners[LAST_LAYER_CORNERS];
+    unsigned char edges[LAST_LAYER_EDGES];
+} algorithm;
+
+static algorithm algorithms[GEN1LLL_ALGORITHMS];
+static int algorithmCount = 0;
+
+/**
+ * The search : the cost of each state, the algorithm reaching it and the
+ * state it is reached from
+ */
+static unsigned short costs[LAST_LAYER_STATES];
+static short reachedBy[LAST_LAYER_STATES];
+static int reachedFrom[LAST_LAYER_STATES];
+static lastLayerState states[LAST_LAYER_STATES];
+
+/**
+ * Returns a face move turned by a quarter of the cube around the up face
+ */
+static move turnedMove(move cmd) {
+    const int sides[6] = {R, L, B, F, U, D};   // F to R, R to B...
+    return cmd - cmd % 15 + sides[cmd % 15];
+}
+
+/**
+ * Returns a face move mirrored from right to left
+ */
+static move mirroredMove(move cmd) {
+    const int sides[6] = {F, B, L, R, U, D};
+    move mirrored = sides[cmd % 15];
+    if (cmd >= F2) return mirrored + F2;
+    return cmd >= Fi ? mirrored : mirrored + Fi;
+}
+
+/**
+ * Adds an algorithm, or exits if it does not keep the first two layers
+ */
+static void addAlgorithm(move * moves) {
+    if (algorithmCount == GEN1LLL_ALGORITHMS) {
+        fprintf(stderr, "Too many algorithms\n");
+        exit(1);
+    }
+    algorithm * added = &algorithms[algorithmCount++];
+    added->moves = moves;
+    added->size = 0;
+    while ((int) moves[added->size] != -1) added->size++;
+    if (!lastLayerMoves(moves, added->corners, added->edges)) {
+        char * code = commandToString(moves);
+        fprintf(stderr, "%s does not keep the first two layers\n", code);
+        exit(1);
+    }
+}
+
+/**
+ * Adds the turns of the up face and the variants of the known algorithms
+ */
+static void addAlgorithms() {
+    const move upTurns[3] = {U, Ui, U2};
+    for (int turn = 0 ; turn < 3 ; turn++) {
+        move * moves = (move *) ec_malloc(sizeof(move) * 2);
+        moves[0] = upTurns[turn];
+        moves[1] = -1;
+        addAlgorithm(moves);
+    }
+
+    for (int known = 0 ; knownAlgorithms[known] ; known++) {
+        move * base = commandParser(knownAlgorithms[known]);
+        int size = 0;
+        while ((int) base[size] != -1) size++;
+        for (int variant = 0 ; variant < 16 ; variant++) {
+            move * moves = (move *) ec_malloc(sizeof(move) * (size + 1));
+            for (int index = 0 ; index < size ; index++) {
+                move cmd = base[variant & 8 ? size - 1 - index : index];
+                if (variant & 8) cmd = inverseMove(cmd);
+                if (variant & 4) cmd = mirroredMove(cmd);
+                for (int turn = 0 ; turn < (variant & 3) ; turn++) {
+                    cmd = turnedMove(cmd);
+                }
+                moves[index] = cmd;
+            }
+            moves[size] = -1;
+            addAlgorithm(moves);
+        }
+        free(base);
+    }
+}
+
+/**
+ * Searches the cheapest chain of algorithms bringing the solved last layer to
+ * every state, the states being expanded by cost
+ */
+static void searchStates(int solvedIndex, lastLayerState * solved) {
+    for (int index = 0 ; index < LAST_LAYER_STATES ; index++) {
+        costs[index] = GEN1LLL_UNKNOWN;
+    }
+    costs[solvedIndex] = 0;
+    reachedBy[solvedIndex] = -1;
+    states[solvedIndex] = *solved;
+
+    int farthest = 0;
+    for (int cost = 0 ; cost <= farthest ; cost++) {
+        for (int index = 0 ; index < LAST_LAYER_STATES ; index++) {
+            if (costs[index] != cost) continue;
+            for (int played = 0 ; played < algorithmCount ; played++) {
+                algorithm * current = &algorithms[played];
+                lastLayerState next;
+                for (int piece = 0 ; piece < 4 ; piece++) {
+                    next.corners[piece] =
+                        current->corners[states[index].corners[piece]];
+                    next.edges[piece] =
+                        current->edges[states[index].edges[piece]];
+                }
+                int nextIndex = lastLayerIndex(&next);
+                if (cost + current->size < costs[nextIndex]) {
+                    costs[nextIndex] = cost + current->size;
+                    reachedBy[nextIndex] = played;
+                    reachedFrom[nextIndex] = index;
+                    states[nextIndex] = next;
+                    if (costs[nextIndex] > farthest) {
+                        farthest = costs[nextIndex];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Adds a move to a sequence, merged with the last move of the same face
+ *
+ * The double moves are written as F2, whether they come as F2 or as Fi2.
+ *
+ * @returns the new size of the sequence
+ */
+static int appendMove(move * moves, int size, move cmd) {
+    const int quarters[4] = {1, 3, 2, 2};   // Of F, Fi, F2 and Fi2
+    const int kinds[4] = {0, 0, F2, Fi};    // The move of 1, 2 or 3 quarters
+    int turns = quarters[cmd / 15];
+    if (size && moves[size - 1] % 15 == cmd % 15) {
+        turns = (turns + quarters[moves[size - 1] / 15]) % 4;
+        if (!turns) return size - 1;
+        moves[size - 1] = kinds[turns] + cmd % 15;
+        return size;
+    }
+    moves[size] = kinds[turns] + cmd % 15;
+    return size + 1;
+}
+
+/**
+ * Returns the algorithm of a state : the inverse of the chain reaching it
+ *
+ * @returns the number of moves
+ */
+static int solvingMoves(int index, move * moves) {
+    int size = 0;
+    while (reachedBy[index] != -1) {
+        algorithm * current = &algorithms[reachedBy[index]];
+        for (int rank = current->size - 1 ; rank >= 0 ; rank--) {
+            if (size == GEN1LLL_MAX_MOVES) {
+                fprintf(stderr, "The algorithm of %d is too long\n", index);
+                exit(1);
+            }
+            size = appendMove(moves, size, inverseMove(current->moves[rank]));
+        }
+        index = reachedFrom[index];
+    }
+    moves[size] = -1;
+    return size;
+}
+
+/**
+ * Checks that an algorithm solves its state, from a solved cube on which its
+ * inverse is played
+ */
+static int checkMoves(cube * solved, int index, move * moves, int size) {
+    cube * work = solved->copy(solved);
+    for (int rank = size - 1 ; rank >= 0 ; rank--) {
+        work->rotate(work, inverseMove(moves[rank]));
+    }
+    lastLayerState state;
+    int valid = readLastLayer(work, &state) && lastLayerIndex(&state) == index;
+    for (int rank = 0 ; rank < size ; rank++) {
+        work->rotate(work, moves[rank]);
+    }
+    for (int face = F ; face <= D && valid ; face++) {
+        for (int row = 0 ; row < 3 ; row++) {
+            valid &= !memcmp(work->cube[face][row], solved->cube[face][row], 3);
+        }
+    }
+    destroyCube(work);
+    return valid;
+}
+
+static void writeLittleEndian(FILE * file, unsigned long value, int size) {
+    for (int index = 0 ; index < size ; index++) {
+        fputc(value >> (8 * index) & 0xFF, file);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage is : ./gen1lll output.tbl\n");
+        return 1;
+    }
+
+    addAlgorithms();
+    cube * solved = positionCube(initCube(), 'g', 'y');
+    lastLayerState solvedState;
+    readLastLayer(solved, &solvedState);
+    int solvedIndex = lastLayerIndex(&solvedState);
+    searchStates(solvedIndex, &solvedState);
+
+    unsigned long * offsets = (unsigned long *)
+        ec_malloc(sizeof(unsigned long) * (LAST_LAYER_STATES + 1));
+    int capacity = LAST_LAYER_STATES * 32;
+    move * allMoves = (move *) ec_malloc(sizeof(move) * capacity);
+    unsigned long moveCount = 0;
+    int longest = 0;
+    for (int index = 0 ; index < LAST_LAYER_STATES ; index++) {
+        if (costs[index] == GEN1LLL_UNKNOWN) {
+            fprintf(stderr, "The state %d is not reached\n", index);
+            return 1;
+        }
+        move moves[GEN1LLL_MAX_MOVES + 1];
+        int size = solvingMoves(index, moves);
+        if (!checkMoves(solved, index, moves, size)) {
+            fprintf(stderr, "The algorithm of %d does not solve it\n", index);
+            return 1;
+        }
+
+        if (moveCount + size > (unsigned long) capacity) {
+            capacity *= 2;
+            allMoves = (move *) ec_realloc(allMoves, sizeof(move) * capacity);
+        }
+        offsets[index] = moveCount;
+        memcpy(allMoves + moveCount, moves, sizeof(move) * size);
+        moveCount += size;
+        if (size > longest) longest = size;
+    }
+    offsets[LAST_LAYER_STATES] = moveCount;
+    destroyCube(solved);
+
+    unsigned char * packed = (unsigned char *)
+        calloc(PACKED_MOVES_BYTES(moveCount) + 1, 1);
+    packMoveBuffer(packed, allMoves, moveCount);
+
+    FILE * output = fopen(argv[1], "wb");
+    if (!output) {
+        perror(argv[1]);
+        return 1;
+    }
+    fwrite("RBKL", 1, 4, output);
+    fputc(LAST_LAYER_VERSION, output);
+    for (int index = 0 ; index <= LAST_LAYER_STATES ; index++) {
+        writeLittleEndian(output, offsets[index], 4);
+    }
+    fwrite(packed, 1, PACKED_MOVES_BYTES(moveCount), output);
+    fclose(output);
+
+    printf("%d state(s) from %d algorithm(s), %.1f moves on average, "
+           "at most %d\n", LAST_LAYER_STATES, algorithmCount,
+           (double) moveCount / LAST_LAYER_STATES, longest);
+    free(packed);
+    free(allMoves);
+    free(offsets);
+    return 0;
+}
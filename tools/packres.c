@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+/*
+ * Packs resource files in a C source file, to be linked in the game
+ *
+ * Usage: ./packres output.c res/a.png res/b.wav ...
+ *
+ * Every file is deflated with zlib, and stored as is when that does not make it
+ * smaller (the PNG files are already deflated). The generated file defines the
+ * assetPack blob and the assetIndex table declared in src/view/assets.h, sorted
+ * by path so the game can look them up by dichotomy.
+ */
+
+#define PACKRES_COLUMNS 16  /**< Bytes written per line of the blob */
+
+/**
+ * A file to pack
+ */
+typedef struct _packedFile {
+    const char * path;      /**< Path of the file, as used by the game */
+    unsigned char * data;   /**< Content of the file, deflated or not */
+    unsigned long size;     /**< Size of the file */
+    unsigned long packedSize; /**< Size of data */
+} packedFile;
+
+static int comparePaths(const void * first, const void * second) {
+    return strcmp(((const packedFile *)first)->path,
+                  ((const packedFile *)second)->path);
+}
+
+/**
+ * Read a file and deflate it if that makes it smaller
+ */
+static void packFile(packedFile * file) {
+    FILE * input = fopen(file->path, "rb");
+    if (!input) {
+        perror(file->path);
+        exit(1);
+    }
+    fseek(input, 0, SEEK_END);
+    file->size = ftell(input);
+    fseek(input, 0, SEEK_SET);
+    unsigned char * content = malloc(file->size ? file->size : 1);
+    if (!content || fread(content, 1, file->size, input) != file->size) {
+        perror(file->path);
+        exit(1);
+    }
+    fclose(input);
+
+    uLongf packedSize = compressBound(file->size);
+    unsigned char * packed = malloc(packedSize);
+    if (packed && compress2(packed, &packedSize, content, file->size,
+                            Z_BEST_COMPRESSION) == Z_OK
+            && packedSize < file->size) {
+        free(content);
+        file->data = packed;
+        file->packedSize = packedSize;
+    } else {
+        free(packed);
+        file->data = content;
+        file->packedSize = file->size;
+    } // Already compressed : stored as is
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage is : ./packres output.c files...\n");
+        return 1;
+    }
+
+    int count = argc - 2;
+    packedFile * files = calloc(count ? count : 1, sizeof(packedFile));
+    for (int index = 0 ; index < count ; index++) {
+        files[index].path = argv[index + 2];
+        packFile(&files[index]);
+    }
+    qsort(files, count, sizeof(packedFile), &comparePaths);
+
+    FILE * output = fopen(argv[1], "w");
+    if (!output) {
+        perror(argv[1]);
+        return 1;
+    }
+    fprintf(output, "/* Generated by tools/packres.c, do not edit */\n\n"
+            "#include \"src/view/assets.h\"\n\n"
+            "const unsigned char assetPack[] = {\n");
+    unsigned long offset = 0;
+    for (int index = 0 ; index < count ; index++) {
+        for (unsigned long byte = 0 ; byte < files[index].packedSize ; byte++, offset++) {
+            fprintf(output, "0x%02x,%s", files[index].data[byte],
+                    offset % PACKRES_COLUMNS == PACKRES_COLUMNS - 1 ? "\n" : "");
+        }
+    }
+    fprintf(output, "0x00\n};\n\nconst assetEntry assetIndex[] = {\n");
+
+    offset = 0;
+    unsigned long size = 0;
+    for (int index = 0 ; index < count ; index++) {
+        fprintf(output, "    {\"%s\", %lu, %lu, %lu},\n", files[index].path,
+                offset, files[index].size, files[index].packedSize);
+        offset += files[index].packedSize;
+        size += files[index].size;
+        free(files[index].data);
+    }
+    fprintf(output, "    {NULL, 0, 0, 0}\n};\n\n"
+            "const int assetCount = %d;\n", count);
+    fclose(output);
+
+    printf("%d file(s) packed, %lu bytes in %lu\n", count, size, offset);
+    free(files);
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/rubik.h"
+#include "../src/controller/lastLayerTable.h"
+#include "../src/controller/patternComparator.h"
+
+/*
+ * Headless check of the solvers
+ *
+ * Usage: ./rubikcheck scrambles [table]
+ *
+ * Seeded scrambles are solved with trueSolve() and neutralSolve(), and set up
+ * as a pattern or as another scramble with solveBetween(). Every sequence is
+ * played on the cube to check it reaches its goal. Without a table, the last
+ * layer is solved in 4 steps. Exits with 1 if a sequence fails.
+ */
+
+#define CHECK_SEED 1            /**< Seed of the scrambles */
+#define CHECK_DEADLINE 20000    /**< Time shortening a solveBetween(), in us */
+
+static const char * patterns[] = {
+    "checkerboard", "superflip", "cubeincube", "sixspots", "crosses",
+    "stripes"
+};
+
+/**
+ * Returns true if two cubes are in the same state, orientation included
+ */
+static bool sameState(cube * aCube, cube * bCube) {
+    for (int face = F ; face <= D ; face++) {
+        for (int row = 0 ; row < 3 ; row++) {
+            if (memcmp(aCube->cube[face][row], bCube->cube[face][row], 3)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns a scrambled cube, turned as a whole one time out of three
+ */
+static cube * scrambledCube(int rank) {
+    move * scramble = randomScramble(20, 30);
+    cube * scrambled = executeBulkCommand(initCube(), scramble);
+    free(scramble);
+    if (rank % 3 == 1) scrambled->rotate(scrambled, x);
+    return scrambled;
+}
+
+/**
+ * Plays a solution on a copy of a cube, and checks that it solves it
+ */
+static bool checkSolution(cube * scrambled, move * solution) {
+    cube * work = executeBulkCommand(scrambled->copy(scrambled), solution);
+    cube * solved = initCube();
+    bool solves = patternMatches(work, solved);
+    destroyCube(work);
+    destroyCube(solved);
+    free(solution);
+    return solves;
+}
+
+/**
+ * Plays the moves of solveBetween() on a copy of a cube, and checks that they
+ * lead to the goal
+ */
+static bool checkBetween(cube * from, cube * to) {
+    move * moves = solveBetween(from, to, CHECK_DEADLINE);
+    if (!moves) return false;
+    cube * work = executeBulkCommand(from->copy(from), moves);
+    bool reached = sameState(work, to);
+    destroyCube(work);
+    free(moves);
+    return reached;
+}
+
+int main(int argc, char **argv) {
+    int scrambles = argc >= 2 ? atoi(argv[1]) : 0;
+    if (argc < 2 || argc > 3 || scrambles <= 0) {
+        fprintf(stderr, "Usage is : ./rubikcheck scrambles [table]\n");
+        return 1;
+    }
+    const char * table = argc == 3 ? argv[2] : NULL;
+    if (!loadLastLayerTable(table)) {
+        fprintf(stderr, "%s is not a table of the last layer\n",
+                table ? table : "(none)");
+        return 1;
+    }
+
+    srand(CHECK_SEED);
+    int failures[3] = {0, 0, 0};
+    for (int rank = 0 ; rank < scrambles ; rank++) {
+        cube * scrambled = scrambledCube(rank);
+        failures[0] += !checkSolution(scrambled, trueSolve(scrambled));
+        failures[1] += !checkSolution(scrambled, neutralSolve(scrambled));
+
+        cube * goal = rank % 2 ? scrambledCube(rank + 1)
+            : patternCube(patterns[rank / 2 % 6]);
+        failures[2] += !checkBetween(scrambled, goal);
+        destroyCube(goal);
+        destroyCube(scrambled);
+    }
+
+    printf("%d scramble(s), %s : %d trueSolve(), %d neutralSolve() and %d "
+           "solveBetween() failure(s)\n", scrambles,
+           table ? table : "no table", failures[0], failures[1], failures[2]);
+    return failures[0] || failures[1] || failures[2];
+}